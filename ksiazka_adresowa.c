@@ -5,15 +5,155 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <limits.h>
 #include <math.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 /* procedury (makra) wykorzystywane w kolejce priorytetowej */
 #define PRZODEK(i) (int)floor((i-1)/2)
 #define LEWY(i) 2*i+1
 #define PRAWY(i) 2*i+2
 
+/* rodzaje kolejek priorytetowych wykorzystywanych w algorytmie Dijkstry */
+#define KOLEJKA_KOPIEC 1
+#define KOLEJKA_KUBELKOWA 2
+/* liczba kubelkow kolejki kubelkowej - o jeden wiecej niz liczba bitow odleglosci */
+#define LICZBA_KUBELKOW 33
+/* stopien wezla, od ktorego krawedzie wezla sa dodatkowo wyszukiwane */
+/* w tablicy mieszajacej (zbior sasiadow) zamiast przegladania listy krawedzi */
+#define PROG_ZBIORU_SASIADOW 32
+/* martwe miejsce w migawce CSR, ponizej ktorego nigdy nie budujemy jej od nowa */
+#define MIN_MARTWYCH_MIGAWKI 4096
+/* liczba uporzadkowanych widokow osob - wedlug identyfikatorow, pierwszych imion */
+/* i nazwisk (tak jak tryby sortowania 1, 2 i 3) */
+#define LICZBA_WIDOKOW 3
+/* najwieksza liczba poziomow listy z przeskokami, w ktorej przechowywany jest widok */
+#define MAKS_POZIOM_WIDOKU 16
+/* liczba zapytan pobieranych naraz przez watek z wlasnej kolejki w trybie wsadowym */
+#define PORCJA_ZAPYTAN 16
+/* sygnatura (z koncowym znakiem '\0' ma 8 bajtow) i wersja formatu pliku binarnego */
+#define SYGNATURA_PLIKU_BINARNEGO "KSIAZKA"
+#define WERSJA_PLIKU_BINARNEGO 1
+/* rozmiar pliku bazy (w bajtach), od ktorego wczytujemy go wieloma watkami */
+#define PROG_WCZYTYWANIA_ROWNOLEGLEGO (1 << 20)
+/* liczba wezlow formatowanych naraz przez jeden watek przy zapisywaniu bazy */
+#define WEZLOW_W_PORCJI_ZAPISU 8192
+/* sygnatura (8 bajtow, bez koncowego znaku '\0') i wersja pliku dziennika zmian */
+#define SYGNATURA_DZIENNIKA "DZIENNIK"
+#define WERSJA_DZIENNIKA 1
+/* od czego zaczyna sie dziennik: od pustej bazy, od migawki zapisanej w pliku */
+/* tekstowym albo od stanu po poprzednim dzienniku (trwa jego kompaktowanie) */
+#define BAZA_PUSTA 0
+#define BAZA_Z_PLIKU 1
+#define BAZA_ZE_STAREGO_DZIENNIKA 2
+/* rodzaje zmian zapisywanych w dzienniku */
+#define ZMIANA_DODANIE_OSOBY 1
+#define ZMIANA_DANYCH_OSOBY 2
+#define ZMIANA_USUNIECIE_OSOBY 3
+#define ZMIANA_DODANIE_ZNAJOMOSCI 4
+#define ZMIANA_USUNIECIE_ZNAJOMOSCI 5
+#define ZMIANA_STOPNIA_ZNAJOMOSCI 6
+#define ZMIANA_SORTOWANIE 7
+/* najwiekszy rozmiar tresci rekordu dziennika (w bajtach) */
+#define ROZMIAR_REKORDU_DZIENNIKA 512
+/* rozmiar dziennika (w bajtach), po przekroczeniu ktorego jest on wlaczany */
+/* w tle do nowej migawki bazy */
+#define PROG_KOMPAKTOWANIA (4 << 20)
+/* wskazowka dla procesora, zeby zaczal pobierac do pamieci podrecznej dane */
+/* spod podanego adresu, zanim beda potrzebne (tylko w kompilatorach GNU) */
+#ifdef __GNUC__
+#define POBIERANIE_Z_WYPRZEDZENIEM(adres) __builtin_prefetch(adres)
+#else
+#define POBIERANIE_Z_WYPRZEDZENIEM(adres)
+#endif
+/* liczba obiektow w jednym bloku (plastrze) pamieci puli */
+#define OBIEKTOW_W_PLASTRZE 4096
+/* rozmiar naglowka plastra - obiekty zaczynaja sie od adresu wyrownanego do 16 bajtow */
+#define NAGLOWEK_PLASTRA 16
+
+/****************************** pule pamieci **********************************/
+
+/* pula obiektow o stalym rozmiarze (wezlow lub krawedzi) - pamiec jest przydzielana */
+/* duzymi blokami (plastrami) po OBIEKTOW_W_PLASTRZE obiektow zamiast osobnego */
+/* wywolania malloc dla kazdego obiektu; zwolnione obiekty trafiaja na liste wolnych */
+/* i sa wykorzystywane ponownie, a cala pule mozna zwolnic naraz (resetowanie_puli) */
+typedef struct plaster
+{
+  struct plaster *nastepny; /* za naglowkiem plastra leza obiekty puli */
+} plaster;
+
+typedef struct
+{
+  size_t rozmiar_obiektu;
+  plaster *plastry; /* lista wszystkich plastrow puli */
+  char *wolne_miejsce; /* pierwszy jeszcze nieuzyty obiekt najnowszego plastra */
+  char *koniec_plastra;
+  void *wolne; /* lista zwolnionych obiektow - adres nastepnego w pierwszych bajtach obiektu */
+} pula_obiektow;
+
+void inicjalizacja_puli(pula_obiektow *pula, size_t rozmiar_obiektu)
+{
+  /* zwolniony obiekt musi pomiescic wskaznik listy wolnych, a kolejne */
+  /* obiekty musza byc wyrownane tak jak wskazniki */
+  if(rozmiar_obiektu < sizeof(void*))
+    rozmiar_obiektu = sizeof(void*);
+  pula->rozmiar_obiektu = (rozmiar_obiektu + sizeof(void*)-1) & ~(sizeof(void*)-1);
+  pula->plastry = NULL;
+  pula->wolne_miejsce = NULL;
+  pula->koniec_plastra = NULL;
+  pula->wolne = NULL;
+}
+
+void* przydzielanie_z_puli(pula_obiektow *pula)
+{
+  plaster *nowy;
+  void *obiekt;
+
+  if(pula->wolne != NULL)
+  {
+    obiekt = pula->wolne;
+    pula->wolne = *(void**)obiekt;
+    return obiekt;
+  }
+  if(pula->wolne_miejsce == pula->koniec_plastra)
+  {
+    nowy = (plaster*) malloc(NAGLOWEK_PLASTRA + OBIEKTOW_W_PLASTRZE*pula->rozmiar_obiektu);
+    nowy->nastepny = pula->plastry;
+    pula->plastry = nowy;
+    pula->wolne_miejsce = (char*)nowy + NAGLOWEK_PLASTRA;
+    pula->koniec_plastra = pula->wolne_miejsce + OBIEKTOW_W_PLASTRZE*pula->rozmiar_obiektu;
+  }
+  obiekt = pula->wolne_miejsce;
+  pula->wolne_miejsce += pula->rozmiar_obiektu;
+  return obiekt;
+}
+
+void zwracanie_do_puli(pula_obiektow *pula, void *obiekt)
+{
+  *(void**)obiekt = pula->wolne;
+  pula->wolne = obiekt;
+}
+
+/* zwolnienie wszystkich obiektow puli naraz - koszt zalezy tylko od liczby plastrow */
+void resetowanie_puli(pula_obiektow *pula)
+{
+  plaster *temp;
+
+  while(pula->plastry != NULL)
+  {
+    temp = pula->plastry->nastepny;
+    free(pula->plastry);
+    pula->plastry = temp;
+  }
+  inicjalizacja_puli(pula, pula->rozmiar_obiektu);
+}
+
 /************************** struktury podstawowe ******************************/
 
 typedef struct
@@ -38,12 +178,30 @@ typedef struct wezel
   int nr_telefonu;
   /* atrybuty wykorzystywane do utrzymania struktury grafu */
   struct wezel *nastepny; /* wskaznik do nastepnego wezla w liscie wszystkich wezlow grafu */
+  struct wezel *poprzedni; /* wskaznik do poprzedniego wezla w tej liscie */
   struct krawedz *pierwszy; /* pierwsza znajomosc w liscie znajomych osob */
-  /* atrybuty wykorzystywane w algorytmie Dijkstry  */
-  struct wezel* poprzednik;
-  int odleglosc;
-  int liczba_krawedzi; /* liczba krawedzi dzielacych dany wezel */
-} wezel;              /* od wezla zrodlowego w najlepszej sciezce */
+  struct krawedz *ostatni; /* ostatnia znajomosc w liscie - nowe sa dopisywane za nia */
+  int stopien; /* liczba krawedzi w liscie znajomych */
+  /* krawedzie wedlug identyfikatora znajomego, tylko dla wezlow o stopniu */
+  /* co najmniej PROG_ZBIORU_SASIADOW (dla pozostalych NULL) */
+  struct zbior_sasiadow *zbior;
+  /* numer wezla w tablicy sloty grafu - pod tym numerem przechowywane sa dane */
+  /* wezla w kontekscie wyszukiwania (patrz algorytm Dijkstry) */
+  int slot;
+  /* osoby o tym samym pierwszym imieniu i nazwisku (imiennicy) tworza liste, */
+  /* ktorej pierwsza osoba lezy w indeksie nazwisk grafu */
+  struct wezel *nastepny_imiennik;
+  struct wezel *poprzedni_imiennik; /* NULL - osoba jest pierwsza na liscie imiennikow */
+  unsigned int skrot_nazwiska; /* wartosc funkcji mieszajacej imienia i nazwiska */
+  /* klucze sortowania pierwszego imienia i nazwiska (patrz liczenie_klucza_sortowania) */
+  uint64_t klucz_imienia[2];
+  uint64_t klucz_nazwiska[2];
+  bool pelny_klucz_imienia, pelny_klucz_nazwiska; /* klucz zawiera caly napis */
+  /* wieze[v][p] - nastepna osoba w widoku v na poziomie p listy z przeskokami */
+  /* (p < wysokosci_wiez[v]); wieze sa przydzielane z pul grafu wedlug wysokosci */
+  struct wezel **wieze[LICZBA_WIDOKOW];
+  unsigned char wysokosci_wiez[LICZBA_WIDOKOW];
+} wezel;
 
 /* krawedz miedzy wezlami - odpowiednik znajomosci miedzy osobami
    wykorzystujac ponizsza strukture mozemy stworzyc
@@ -53,16 +211,106 @@ typedef struct krawedz
   wezel *cel; /* wskaznik do wezla do ktorego prowadzi dana krawedz (osoba z ktora ktos zawarl znajomosc) */
   short waga; /* stopien znajomosci z osoba do ktorej prowadzi krawedz (skala od 1 do 10) */
   struct krawedz *nastepny; /* nastepna znajomosc danej osoby w liscie znajomosci */
+  struct krawedz *poprzedni; /* poprzednia znajomosc - krawedz usuwamy bez szukania poprzednika */
+  /* krawedz w przeciwnym kierunku (od osoby cel do wlasciciela tej krawedzi) - znajomosci */
+  /* sa zawsze dodawane parami, wiec usuwajac osobe odnajdujemy krawedzie do niej */
+  /* prowadzace bez przegladania calego grafu */
+  struct krawedz *blizniacza;
+  int indeks_w_migawce; /* indeks krawedzi w tablicach aktualnej migawki CSR */
 } krawedz;
 
+/* zbior sasiadow wezla o duzym stopniu - tablica mieszajaca z adresowaniem */
+/* otwartym (sondowanie liniowe) krawedzi wychodzacych wedlug id wezla docelowego */
+typedef struct zbior_sasiadow
+{
+  krawedz **tablica; /* NULL oznacza wolne miejsce */
+  int pojemnosc; /* potega dwojki */
+  int liczba_krawedzi;
+  /* lista wszystkich zbiorow grafu - pozwala je zwolnic bez przegladania wezlow */
+  struct zbior_sasiadow *poprzedni, *nastepny;
+} zbior_sasiadow;
+
+/* migawka grafu w formacie CSR (ang. compressed sparse row) - krawedzie wszystkich */
+/* wezlow w jednej ciaglej tablicy, uzywana przez algorytmy wyszukiwania sciezek */
+/* zamiast list krawedzi (kolejne krawedzie listy leza w przypadkowych miejscach pamieci) */
+/* krawedzie wezla o slocie i maja indeksy [poczatki[i], konce[i]) */
+/* i wystepuja w tej samej kolejnosci co w liscie krawedzi wezla */
+typedef struct
+{
+  int *poczatki; /* liczba_wezlow+1 elementow (ostatni tylko zaraz po budowie) */
+  int *konce; /* po budowie konce[i] == poczatki[i+1] */
+  int *sasiedzi; /* slot wezla, do ktorego prowadzi krawedz */
+  unsigned char *wagi; /* stopien znajomosci (1 - 10) */
+  int liczba_wezlow; /* liczba slotow grafu objetych migawka */
+  int liczba_krawedzi; /* zajeta czesc tablic sasiedzi i wagi (razem z martwymi) */
+  int liczba_martwych; /* elementy tablic nienalezace juz do zadnego wezla */
+  int pojemnosc_wezlow; /* liczby elementow na ktore zaalokowano tablice */
+  int pojemnosc_krawedzi;
+  /* zmiany grafu sa nanoszone na migawke od razu (dodana krawedz przenosi zakres */
+  /* wezla na koniec tablic, usunieta zwalnia miejsce w zakresie), a od nowa */
+  /* budujemy ja przed wyszukiwaniem dopiero, gdy martwe miejsce przekroczy */
+  /* liczbe krawedzi albo po wczytaniu calego grafu */
+  bool nieaktualna;
+} migawka_csr;
+
+/* indeks identyfikatorow - tablica mieszajaca z adresowaniem otwartym */
+/* (sondowanie liniowe), w ktorej wezel o danym id znajdujemy w czasie O(1) */
+typedef struct
+{
+  struct wezel **tablica; /* NULL oznacza wolne miejsce */
+  int pojemnosc; /* potega dwojki */
+  int liczba_wezlow;
+} indeks_id;
+
+/* indeks nazwisk - tablica mieszajaca z adresowaniem otwartym wedlug pierwszego */
+/* imienia i nazwiska; w tablicy lezy tylko pierwsza osoba z listy imiennikow, */
+/* wiec nawet bardzo wiele osob o tym samym imieniu i nazwisku zajmuje jedno miejsce */
+typedef struct
+{
+  struct wezel **tablica; /* NULL oznacza wolne miejsce */
+  int pojemnosc; /* potega dwojki */
+  int liczba_nazwisk; /* liczba roznych par imie - nazwisko */
+} indeks_nazwisk;
+
+/* uporzadkowane widoki osob - dla kazdego trybu sortowania lista z przeskokami */
+/* (ang. skip list) przez wezly grafu; osoba na poziomie p jest tez na poziomie */
+/* p+1 z prawdopodobienstwem 1/4, wiec dodanie i usuniecie osoby kosztuje */
+/* O(log n), a wypisanie osob w dowolnej kolejnosci nie wymaga sortowania */
+/* osoby o rownych imionach (nazwiskach) sa uporzadkowane wedlug id */
+typedef struct
+{
+  struct wezel *poczatki[LICZBA_WIDOKOW][MAKS_POZIOM_WIDOKU]; /* pierwsze osoby na poziomach */
+  int liczba_poziomow[LICZBA_WIDOKOW];
+  pula_obiektow pule_wiez[MAKS_POZIOM_WIDOKU]; /* pule_wiez[i] - wieze wysokosci i+1 */
+  unsigned int stan_losowania; /* generator wysokosci wiez */
+  /* po wczytaniu wielu osob naraz widoki sa budowane od nowa (sortowaniem) */
+  /* dopiero wtedy, gdy sa potrzebne */
+  bool nieaktualne;
+} widoki_osob;
+
 /* graf jest dynamiczna lista wszystkich wezlow. Kazdy wezel posiada liste wezlow, */
 /* ktore sa z nim polaczone krawedzia, tzn. kazda osoba posiada liste swoich znajomych */
 /* do grafu odwolujemy sie za pomoca wskaznika zrodlo */
 typedef struct baza
 {
   wezel *zrodlo; /* pierwszy wezel w liscie wszystkich wezlow grafu */
+  wezel *ostatni_wezel; /* ostatni wezel w tej liscie - nowe wezly dopisujemy za nim */
   int liczba_elementow;
   int biezacy_id;
+  /* kazdy wezel ma numer slotu z przedzialu [0, liczba_slotow), numery zwolnione */
+  /* przez usuniete wezly sa wykorzystywane ponownie, wiec numeracja pozostaje gesta */
+  wezel **sloty; /* sloty[i] - wezel o numerze slotu i lub NULL gdy slot jest wolny */
+  int liczba_slotow;
+  int pojemnosc_slotow; /* liczba elementow na ktora zaalokowano tablice sloty i wolne_sloty */
+  int *wolne_sloty; /* stos numerow slotow zwolnionych przez usuniete wezly */
+  int liczba_wolnych_slotow;
+  migawka_csr migawka; /* krawedzie grafu w postaci wygodnej dla wyszukiwania sciezek */
+  indeks_id indeks; /* wezly grafu wedlug identyfikatorow */
+  indeks_nazwisk nazwiska; /* wezly grafu wedlug pierwszego imienia i nazwiska */
+  widoki_osob widoki; /* wezly grafu uporzadkowane wedlug id, imion i nazwisk */
+  pula_obiektow pula_wezlow; /* pamiec wszystkich wezlow grafu */
+  pula_obiektow pula_krawedzi; /* pamiec wszystkich krawedzi grafu */
+  zbior_sasiadow *zbiory; /* lista zbiorow sasiadow wezlow o duzym stopniu */
 } baza; /* baza - graf - ksiazka adresowo-spolecznosciowa */
 
 /* tworzymy dwie nazwy dla tej samej struktury, zeby latwiej bylo zrozumiec */
@@ -71,461 +319,912 @@ typedef baza graf;
 
 void inicjalizacja_bazy(baza *b)
 {
+  int i, j;
+
   b->liczba_elementow = 0;
   b->biezacy_id = 1; /* id zwiekszamy o jeden po dodaniu kazdej nowej osoby */
   b->zrodlo = NULL;
+  b->ostatni_wezel = NULL;
+  b->sloty = NULL;
+  b->liczba_slotow = 0;
+  b->pojemnosc_slotow = 0;
+  b->wolne_sloty = NULL;
+  b->liczba_wolnych_slotow = 0;
+  b->migawka.poczatki = NULL;
+  b->migawka.konce = NULL;
+  b->migawka.sasiedzi = NULL;
+  b->migawka.wagi = NULL;
+  b->migawka.liczba_wezlow = 0;
+  b->migawka.liczba_krawedzi = 0;
+  b->migawka.liczba_martwych = 0;
+  b->migawka.pojemnosc_wezlow = 0;
+  b->migawka.pojemnosc_krawedzi = 0;
+  b->migawka.nieaktualna = true;
+  b->indeks.tablica = NULL;
+  b->indeks.pojemnosc = 0;
+  b->indeks.liczba_wezlow = 0;
+  b->nazwiska.tablica = NULL;
+  b->nazwiska.pojemnosc = 0;
+  b->nazwiska.liczba_nazwisk = 0;
+  for(i = 0; i < LICZBA_WIDOKOW; i++)
+  {
+    for(j = 0; j < MAKS_POZIOM_WIDOKU; j++)
+      b->widoki.poczatki[i][j] = NULL;
+    b->widoki.liczba_poziomow[i] = 1;
+  }
+  for(j = 0; j < MAKS_POZIOM_WIDOKU; j++)
+    inicjalizacja_puli(&b->widoki.pule_wiez[j], (j+1)*sizeof(wezel*));
+  b->widoki.stan_losowania = 2463534242u;
+  b->widoki.nieaktualne = false;
+  inicjalizacja_puli(&b->pula_wezlow, sizeof(wezel));
+  inicjalizacja_puli(&b->pula_krawedzi, sizeof(krawedz));
+  b->zbiory = NULL;
+}
+
+/*********************** migawka grafu (CSR) ******************************/
+
+/* powiekszenie tablic sasiedzi i wagi tak, zeby zmiescily liczba elementow */
+void powiekszanie_migawki(migawka_csr *m, int liczba)
+{
+  if(liczba <= m->pojemnosc_krawedzi)
+    return ;
+  while(m->pojemnosc_krawedzi < liczba)
+    m->pojemnosc_krawedzi = (m->pojemnosc_krawedzi == 0)? 64 : 2*m->pojemnosc_krawedzi;
+  m->sasiedzi = (int*) realloc(m->sasiedzi, m->pojemnosc_krawedzi*sizeof(int));
+  m->wagi = (unsigned char*) realloc(m->wagi, m->pojemnosc_krawedzi*sizeof(unsigned char));
+}
+
+/* powiekszenie tablic poczatki i konce do pojemnosci tablicy slotow grafu */
+void powiekszanie_wezlow_migawki(graf *g)
+{
+  migawka_csr *m = &g->migawka;
+
+  if(m->pojemnosc_wezlow < g->liczba_slotow+1)
+  {
+    m->pojemnosc_wezlow = g->pojemnosc_slotow+1;
+    m->poczatki = (int*) realloc(m->poczatki, m->pojemnosc_wezlow*sizeof(int));
+    m->konce = (int*) realloc(m->konce, m->pojemnosc_wezlow*sizeof(int));
+  }
+}
+
+/* budowanie migawki od nowa na podstawie list krawedzi wszystkich wezlow */
+/* tablice poprzedniej migawki sa wykorzystywane ponownie, jesli sa wystarczajaco duze */
+void budowanie_migawki(graf *g)
+{
+  migawka_csr *m = &g->migawka;
+  krawedz *krawedzwsk;
+  int i, k = 0;
+
+  powiekszanie_wezlow_migawki(g);
+  for(i = 0; i < g->liczba_slotow; i++)
+  {
+    m->poczatki[i] = k;
+    /* wolny slot to wezel bez krawedzi */
+    if(g->sloty[i] != NULL)
+      for(krawedzwsk = g->sloty[i]->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+      {
+        powiekszanie_migawki(m, k+1);
+        m->sasiedzi[k] = krawedzwsk->cel->slot;
+        m->wagi[k] = (unsigned char) krawedzwsk->waga;
+        krawedzwsk->indeks_w_migawce = k;
+        k++;
+      }
+    m->konce[i] = k;
+  }
+  m->poczatki[g->liczba_slotow] = k;
+  m->liczba_wezlow = g->liczba_slotow;
+  m->liczba_krawedzi = k;
+  m->liczba_martwych = 0;
+  m->nieaktualna = false;
+}
+
+/* gdy martwego miejsca jest wiecej niz zywych krawedzi, migawke zbudujemy od nowa */
+/* przy najblizszym wyszukiwaniu - koszt budowy O(V+E) rozklada sie na co najmniej */
+/* tyle zmian, ile krawedzi ma graf */
+void sprawdzanie_martwych_migawki(migawka_csr *m)
+{
+  if(m->liczba_martwych > MIN_MARTWYCH_MIGAWKI &&
+     m->liczba_martwych > m->liczba_krawedzi - m->liczba_martwych)
+    m->nieaktualna = true;
+}
+
+/* nowy wezel dostaje pusty zakres - slot zwolniony przez usuniety wezel */
+/* ma pusty zakres juz od jego usuniecia (zwalnianie_z_migawki) */
+void dodawanie_wezla_do_migawki(graf *g, int slot)
+{
+  migawka_csr *m = &g->migawka;
+
+  if(m->nieaktualna || slot < m->liczba_wezlow)
+    return ;
+  powiekszanie_wezlow_migawki(g);
+  m->poczatki[slot] = m->konce[slot] = m->liczba_krawedzi;
+  m->liczba_wezlow = slot+1;
+}
+
+/* zwolnienie zakresu usuwanego wezla (jego krawedzie wchodzace usuwa */
+/* wczesniej usuwanie_z_migawki) */
+void zwalnianie_z_migawki(graf *g, int slot)
+{
+  migawka_csr *m = &g->migawka;
+
+  if(m->nieaktualna)
+    return ;
+  m->liczba_martwych += m->konce[slot] - m->poczatki[slot];
+  m->konce[slot] = m->poczatki[slot];
+  sprawdzanie_martwych_migawki(m);
+}
+
+/* naniesienie na migawke krawedzi dopisanej wlasnie na koniec listy wezla - */
+/* jesli zakres wezla nie konczy sie na koncu tablic, to najpierw go tam */
+/* przenosimy (stare miejsce staje sie martwe), wiec koszt to O(stopnia wezla) */
+void dopisywanie_do_migawki(graf *g, wezel *wezelwsk, krawedz *nowa)
+{
+  migawka_csr *m = &g->migawka;
+  krawedz *krawedzwsk;
+  int slot = wezelwsk->slot, dlugosc, k;
+
+  if(m->nieaktualna)
+    return ;
+  if(m->konce[slot] != m->liczba_krawedzi)
+  {
+    dlugosc = m->konce[slot] - m->poczatki[slot];
+    powiekszanie_migawki(m, m->liczba_krawedzi + dlugosc + 1);
+    k = m->liczba_krawedzi;
+    memcpy(m->sasiedzi + k, m->sasiedzi + m->poczatki[slot], dlugosc*sizeof(int));
+    memcpy(m->wagi + k, m->wagi + m->poczatki[slot], dlugosc*sizeof(unsigned char));
+    m->poczatki[slot] = k;
+    m->konce[slot] = k + dlugosc;
+    m->liczba_krawedzi += dlugosc;
+    m->liczba_martwych += dlugosc;
+    for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != nowa; krawedzwsk = krawedzwsk->nastepny)
+      krawedzwsk->indeks_w_migawce = k++;
+  }
+  powiekszanie_migawki(m, m->liczba_krawedzi+1);
+  m->sasiedzi[m->liczba_krawedzi] = nowa->cel->slot;
+  m->wagi[m->liczba_krawedzi] = (unsigned char) nowa->waga;
+  nowa->indeks_w_migawce = m->liczba_krawedzi;
+  m->liczba_krawedzi++;
+  m->konce[slot]++;
+  sprawdzanie_martwych_migawki(m);
+}
+
+/* usuniecie krawedzi z zakresu wezla przed odlaczeniem jej od listy - dalsze */
+/* krawedzie zakresu przesuwamy o jedno miejsce, zeby kolejnosc pozostala taka */
+/* sama jak w liscie (i wyniki wyszukiwan takie same jak po budowie od nowa) */
+void usuwanie_z_migawki(graf *g, wezel *wezelwsk, krawedz *usuwana)
+{
+  migawka_csr *m = &g->migawka;
+  krawedz *krawedzwsk;
+  int j, koniec;
+
+  /* nieaktualna migawka moze nie miec jeszcze tablic (konce == NULL) */
+  if(m->nieaktualna)
+    return ;
+  j = usuwana->indeks_w_migawce;
+  koniec = m->konce[wezelwsk->slot];
+  memmove(m->sasiedzi + j, m->sasiedzi + j+1, (koniec-j-1)*sizeof(int));
+  memmove(m->wagi + j, m->wagi + j+1, (koniec-j-1)*sizeof(unsigned char));
+  for(krawedzwsk = usuwana->nastepny; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+    krawedzwsk->indeks_w_migawce--;
+  m->konce[wezelwsk->slot]--;
+  m->liczba_martwych++;
+  sprawdzanie_martwych_migawki(m);
+}
+
+/* wywolywana przed kazdym wyszukiwaniem - jesli graf sie nie zmienil to koszt jest staly */
+/* w trybie wsadowym migawka jest aktualizowana przed uruchomieniem watkow, */
+/* wiec watki jedynie ja odczytuja */
+void aktualizacja_migawki(graf *g)
+{
+  if(g->migawka.nieaktualna)
+    budowanie_migawki(g);
+}
+
+void zwalnianie_migawki(migawka_csr *m)
+{
+  free(m->poczatki);
+  free(m->konce);
+  free(m->sasiedzi);
+  free(m->wagi);
 }
 
 /************************ algorytm Dijkstry *******************************/
 
+/* element kopca - numer slotu wezla razem z jego odlegloscia od zrodla */
+/* (trzymamy odleglosc w tablicy kopca, zeby porownania nie wymagaly siegania do stanow wezlow) */
+typedef struct
+{
+  int odleglosc;
+  int slot;
+} element_kopca;
+
 /* kolejka priorytetowa zaimplementowana jako kopiec binarny typu min */
 /* (podobnie jak w ksiazce Cormena rozdzial 6 - Heapsort) */
+/* w kopcu sa tylko wezly odkryte w biezacym zapytaniu (front przeszukiwania) */
 typedef struct
 {
-  wezel **tablica; /* tablica wskaznikow do wszystkich wezlow grafu */
+  element_kopca *tablica;
   int rozmiar;
+  int pojemnosc; /* liczba elementow na ktora zaalokowano tablice */
 } kopiec_min;
 
+/* kolejka wezlow (numerow slotow) wykorzystywana w przeszukiwaniu wszerz */
+/* wezly kolejnych poziomow przeszukiwania sa dopisywane na koncu tablicy */
+typedef struct
+{
+  int *tablica;
+  int poczatek; /* indeks pierwszego wezla biezacego poziomu przeszukiwania */
+  int rozmiar;
+  int pojemnosc; /* liczba elementow na ktora zaalokowano tablice */
+} kolejka_wezlow;
+
+/* element kolejki kubelkowej - slot wezla razem z odlegloscia, z ktora zostal wstawiony */
+typedef struct
+{
+  unsigned int odleglosc;
+  int slot;
+} element_kubelka;
+
+typedef struct
+{
+  element_kubelka *tablica;
+  int rozmiar;
+  int pojemnosc; /* liczba elementow na ktora zaalokowano tablice */
+} kubelek;
+
+/* kolejka kubelkowa (kopiec pozycyjny, ang. radix heap) - kolejka priorytetowa */
+/* dla calkowitych odleglosci, w ktorej pobierane odleglosci nigdy nie maleja */
+/* element o odleglosci d trafia do kubelka o numerze rownym liczbie bitow, */
+/* na ktorych d rozni sie od ostatnio pobranej odleglosci (kubelek 0 gdy d == ostatni) */
+typedef struct
+{
+  kubelek kubelki[LICZBA_KUBELKOW];
+  unsigned int ostatni; /* ostatnio pobrana (najmniejsza) odleglosc */
+  int rozmiar; /* liczba elementow we wszystkich kubelkach */
+} kolejka_kubelkowa;
+
+/* dane wezla wykorzystywane w wyszukiwaniu sciezek */
+typedef struct
+{
+  /* numer zapytania (pokolenie), w ktorym zostaly ustawione ponizsze dane */
+  /* jesli jest rozny od biezacego pokolenia kontekstu to dane sa nieaktualne */
+  unsigned int pokolenie;
+  int odleglosc;
+  int poprzednik; /* slot poprzedniego wezla na sciezce od zrodla lub -1 */
+  int liczba_krawedzi; /* liczba krawedzi dzielacych dany wezel */
+                       /* od wezla zrodlowego w najlepszej sciezce */
+  int pozycja_w_kopcu; /* indeks wezla w tablicy kopca lub -1 gdy wezla nie ma w kopcu */
+  /* dane wykorzystywane w dwukierunkowym przeszukiwaniu wszerz */
+  int nastepnik; /* slot nastepnego wezla na sciezce do celu (przeszukiwanie od celu) */
+  char strona; /* 0 - wezel nieodkryty, 1 - odkryty od strony zrodla, 2 - od strony celu */
+  /* 0 - wezel nie jest celem wyszukiwania, 1 - cel jeszcze nieosiagniety, 2 - cel osiagniety */
+  char cel_wyszukiwania;
+} stan_wezla;
+
+/* kontekst wyszukiwania - wszystkie dane zmieniane podczas wyszukiwania sciezki */
+/* graf jest w trakcie wyszukiwania tylko czytany, wiec wiele kontekstow (np. w roznych */
+/* watkach) moze jednoczesnie odpowiadac na zapytania dotyczace tego samego grafu */
+typedef struct
+{
+  stan_wezla *stany; /* dane wezlow indeksowane numerem slotu */
+  int pojemnosc; /* liczba slotow na ktora zaalokowano tablice stany */
+  unsigned int pokolenie; /* numer biezacego zapytania */
+  kopiec_min kopiec; /* tablice kolejek sa powiekszane tylko w razie potrzeby */
+  kolejka_wezlow kolejki[2]; /* kolejki przeszukiwania wszerz od zrodla i od celu */
+  kolejka_kubelkowa kubelki;
+  /* kolejka uzywana przy wyszukiwaniu najskuteczniejszej sciezki */
+  int rodzaj_kolejki; /* KOLEJKA_KOPIEC lub KOLEJKA_KUBELKOWA */
+  int liczba_odwiedzonych; /* liczba wezlow odkrytych w ostatnim zapytaniu */
+  int *sloty_celow; /* sloty celow przekazanych jako wskazniki na wezly */
+  int pojemnosc_celow;
+} kontekst_wyszukiwania;
+
+void inicjalizacja_kontekstu(kontekst_wyszukiwania *kontekst)
+{
+  int i;
+
+  kontekst->stany = NULL;
+  kontekst->pojemnosc = 0;
+  kontekst->pokolenie = 0; /* nowe stany maja pokolenie 0, wiec ich dane sa nieaktualne */
+  kontekst->kopiec.tablica = NULL;
+  kontekst->kopiec.rozmiar = 0;
+  kontekst->kopiec.pojemnosc = 0;
+  for(i = 0; i < 2; i++)
+  {
+    kontekst->kolejki[i].tablica = NULL;
+    kontekst->kolejki[i].poczatek = 0;
+    kontekst->kolejki[i].rozmiar = 0;
+    kontekst->kolejki[i].pojemnosc = 0;
+  }
+  for(i = 0; i < LICZBA_KUBELKOW; i++)
+  {
+    kontekst->kubelki.kubelki[i].tablica = NULL;
+    kontekst->kubelki.kubelki[i].rozmiar = 0;
+    kontekst->kubelki.kubelki[i].pojemnosc = 0;
+  }
+  kontekst->kubelki.ostatni = 0;
+  kontekst->kubelki.rozmiar = 0;
+  kontekst->rodzaj_kolejki = KOLEJKA_KOPIEC;
+  kontekst->liczba_odwiedzonych = 0;
+  kontekst->sloty_celow = NULL;
+  kontekst->pojemnosc_celow = 0;
+}
+
+void zwalnianie_kontekstu(kontekst_wyszukiwania *kontekst)
+{
+  int i;
+
+  free(kontekst->stany);
+  free(kontekst->kopiec.tablica);
+  free(kontekst->kolejki[0].tablica);
+  free(kontekst->kolejki[1].tablica);
+  for(i = 0; i < LICZBA_KUBELKOW; i++)
+    free(kontekst->kubelki.kubelki[i].tablica);
+  free(kontekst->sloty_celow);
+  inicjalizacja_kontekstu(kontekst);
+}
+
+/* zamiana miejscami dwoch elementow kopca o indeksach i oraz j */
+/* razem z aktualizacja pozycji zapamietanych w stanach zamienianych wezlow */
+void zamiana_elementow_kopca(kontekst_wyszukiwania *kontekst, int i, int j)
+{
+  element_kopca *tablica = kontekst->kopiec.tablica;
+  element_kopca temp;
+
+  temp = tablica[i];
+  tablica[i] = tablica[j];
+  tablica[j] = temp;
+  kontekst->stany[tablica[i].slot].pozycja_w_kopcu = i;
+  kontekst->stany[tablica[j].slot].pozycja_w_kopcu = j;
+}
+
 /* przywracanie struktury kopca binarnego, ktora zostala zaburzona */
 /* indeks i wskazuje na wezel w kopcu ktory moze miec wieksza odleglosc */
 /* od zrodla niz wezly z lewego i prawego poddrzewa */
-/* funkcja analogiczna do funkcji max_heapify z ksiazki Cormena */
-void przywracanie_kopca(kopiec_min *kopiec, int i)
+/* funkcja analogiczna do funkcji max_heapify z ksiazki Cormena, */
+/* ale zamiast rekurencji uzywamy petli (przesuwamy wezel w dol kopca) */
+void przywracanie_kopca(kontekst_wyszukiwania *kontekst, int i)
 {
+  kopiec_min *kopiec = &kontekst->kopiec;
   int lewy, prawy, najmniejszy;
-  wezel *temp;
-  lewy = LEWY(i); /* indeks w tablicy lewego potomka elementu o indeksie i */
-  prawy = PRAWY(i); /* indeks w tablicy prawego potomka elementu o indeksie i */
-  if(lewy <= kopiec->rozmiar-1 && kopiec->tablica[lewy]->odleglosc < kopiec->tablica[i]->odleglosc)
-    najmniejszy = lewy;
-  else
-    najmniejszy = i;
-  if(prawy <= kopiec->rozmiar-1 && kopiec->tablica[prawy]->odleglosc < kopiec->tablica[najmniejszy]->odleglosc)
-    najmniejszy = prawy;
-  if(najmniejszy != i)
+  while(1)
   {
-    /* zamiana wskaznikow */
-    temp = kopiec->tablica[i];
-    kopiec->tablica[i] = kopiec->tablica[najmniejszy];
-    kopiec->tablica[najmniejszy] = temp;
-    przywracanie_kopca(kopiec, najmniejszy);
+    lewy = LEWY(i); /* indeks w tablicy lewego potomka elementu o indeksie i */
+    prawy = PRAWY(i); /* indeks w tablicy prawego potomka elementu o indeksie i */
+    if(lewy <= kopiec->rozmiar-1 && kopiec->tablica[lewy].odleglosc < kopiec->tablica[i].odleglosc)
+      najmniejszy = lewy;
+    else
+      najmniejszy = i;
+    if(prawy <= kopiec->rozmiar-1 && kopiec->tablica[prawy].odleglosc < kopiec->tablica[najmniejszy].odleglosc)
+      najmniejszy = prawy;
+    if(najmniejszy == i)
+      return ; /* struktura kopca zostala przywrocona */
+    zamiana_elementow_kopca(kontekst, i, najmniejszy);
+    i = najmniejszy;
   }
 }
 
-/* n - liczba osob (wezlow) w bazie
-   wezelwsk - wskaznik na pierwszy wezel w liscie wszystkich wezlow grafu
-   zrodlo - wskaznik na wezel z ktorego zaczynamy poszukiwanie sciezki w algorytmie Dijkstry */
-/* funkcja analogiczna do funkcji build_max_heap z ksiazki Cormena */
-void budowanie_kopca(kopiec_min *kopiec, wezel *wezelwsk, wezel* zrodlo, int n)
+/* wstawianie do kopca nowo odkrytego wezla, ktorego odleglosc zostala juz ustawiona */
+/* jesli tablica kopca jest pelna to zwiekszamy ja dwukrotnie */
+/* funkcja analogiczna do funkcji max_heap_insert z ksiazki Cormena */
+void wstawianie_do_kopca(kontekst_wyszukiwania *kontekst, int slot)
 {
+  kopiec_min *kopiec = &kontekst->kopiec;
   int i;
 
-  kopiec->rozmiar = n;
-  kopiec->tablica = (wezel**) malloc(n*sizeof(wezel*));
-
-  for(i = 0; i < n; i++)
+  if(kopiec->rozmiar == kopiec->pojemnosc)
   {
-    kopiec->tablica[i] = wezelwsk;
-    kopiec->tablica[i]->poprzednik = NULL;
-    if(wezelwsk == zrodlo)
-    {
-      kopiec->tablica[i]->odleglosc = 0;
-      kopiec->tablica[i]->liczba_krawedzi = 0;
-    }
-    else /* za pomoca INT_MAX oznaczamy ze dany wezel jest nieosiagalny z wezla zrodlowego */
-      kopiec->tablica[i]->odleglosc = INT_MAX;
-    wezelwsk = wezelwsk->nastepny;
+    kopiec->pojemnosc = (kopiec->pojemnosc == 0)? 16 : 2*kopiec->pojemnosc;
+    kopiec->tablica = (element_kopca*) realloc(kopiec->tablica, kopiec->pojemnosc*sizeof(element_kopca));
+  }
+  i = kopiec->rozmiar;
+  kopiec->rozmiar++;
+  kopiec->tablica[i].odleglosc = kontekst->stany[slot].odleglosc;
+  kopiec->tablica[i].slot = slot;
+  kontekst->stany[slot].pozycja_w_kopcu = i;
+  while(i > 0 && kopiec->tablica[PRZODEK(i)].odleglosc > kopiec->tablica[i].odleglosc)
+  {
+    zamiana_elementow_kopca(kontekst, i, PRZODEK(i));
+    i = PRZODEK(i);
   }
-
-  for(i = (int)floor(kopiec->rozmiar/2); i >= 0; i--)
-    przywracanie_kopca(kopiec, i);
 }
 
 /* funkcja pozwalajaca na wprowadzenie nowej odleglosci do elementu kopca */
 /* (odleglosci od wezla zrodlowego) przy zachowaniu struktury kopca binarnego */
 /* jesli nowa odleglosc nie jest mniejsza od dotychczasowej odleglosci od zrodla */
-/* to funkcja zwraca -1 (bedziemy zmniejszac odleglosci w algorytmie Dijkstry)  */
+/* lub wezel zostal juz zdjety z kopca to funkcja zwraca -1 */
+/* (bedziemy zmniejszac odleglosci w algorytmie Dijkstry) */
+/* polozenie wezla w tablicy odczytujemy ze stanu wezla, wiec zlozonosc to O(log n) */
 /* funkcja analogiczna do funkcji heap_increase_key z ksiazki Cormena */
-int zmniejsz_odleglosc(kopiec_min *kopiec, wezel *zmieniany, int nowa_odleglosc)
+int zmniejsz_odleglosc(kontekst_wyszukiwania *kontekst, int slot, int nowa_odleglosc)
 {
-  wezel *temp;
+  kopiec_min *kopiec = &kontekst->kopiec;
   int i;
 
-  for(i = 0; i < kopiec->rozmiar; i++)
-  {/* zakladamy ze wskaznik zmieniany pokazuje na wezel ktory istnieje w grafie */
-    if(kopiec->tablica[i] == zmieniany)
-      break;
-  }
-  if(nowa_odleglosc > kopiec->tablica[i]->odleglosc)
+  i = kontekst->stany[slot].pozycja_w_kopcu;
+  if(i < 0 || nowa_odleglosc > kontekst->stany[slot].odleglosc)
     return -1;
-  kopiec->tablica[i]->odleglosc = nowa_odleglosc;
-  while(i > 0 && kopiec->tablica[PRZODEK(i)]->odleglosc > kopiec->tablica[i]->odleglosc)
+  kontekst->stany[slot].odleglosc = nowa_odleglosc;
+  kopiec->tablica[i].odleglosc = nowa_odleglosc;
+  while(i > 0 && kopiec->tablica[PRZODEK(i)].odleglosc > kopiec->tablica[i].odleglosc)
   {
-    /* zamiana wskaznikow */
-    temp = kopiec->tablica[i];
-    kopiec->tablica[i] = kopiec->tablica[PRZODEK(i)];
-    kopiec->tablica[PRZODEK(i)] = temp;
+    zamiana_elementow_kopca(kontekst, i, PRZODEK(i));
     i = PRZODEK(i);
   }
   return 0;
 }
 
-/* funkcja zwracajaca wezel o najmniejszej odleglosci od zrodla (zlozonosc O(1)) */
-/* jesli kopiec pusty to funkcja zwraca NULL */
+/* funkcja zwracajaca slot wezla o najmniejszej odleglosci od zrodla (zlozonosc O(log n)) */
+/* jesli kopiec pusty to funkcja zwraca -1 */
 /* funkcja analogiczna do funkcji exrtract_max z ksiazki Cormena */
-wezel* pobierz_minimalny(kopiec_min *kopiec)
+int pobierz_minimalny(kontekst_wyszukiwania *kontekst)
 {
-  wezel* min;
-  if(kopiec->rozmiar < 1) return NULL; /* kopiec pusty */
-  min = kopiec->tablica[0];
+  kopiec_min *kopiec = &kontekst->kopiec;
+  int min;
+  if(kopiec->rozmiar < 1) return -1; /* kopiec pusty */
+  min = kopiec->tablica[0].slot;
   kopiec->tablica[0] = kopiec->tablica[kopiec->rozmiar-1];
+  kontekst->stany[kopiec->tablica[0].slot].pozycja_w_kopcu = 0;
   kopiec->rozmiar--;
-  przywracanie_kopca(kopiec, 0);
+  kontekst->stany[min].pozycja_w_kopcu = -1; /* wezel nie nalezy juz do kopca */
+  przywracanie_kopca(kontekst, 0);
   return min;
 }
 
-/* jesli tryb == 1 to wyszukiwanie najszybszej sciezki, jesli tryb == 2 */
-/* to wyszukiwanie najskuteczniejszej sciezki */
-/* zrodlo i cel to wskazniki na wezly miedzy ktorymi szukamy najlepszej sciezki */
-/* zakladamy ze te wezly istnieja w grafie */
-/* jesli nie istnieje sciezka miedzy dwoma wezlami to funkcja zwraca NULL */
-/* w przeciwnym przypadku funkcja zwraca wskaznik do wezla cel, z ktorego mozemy */
-/* odtworzyc sciezke za pomoca zmiennej skladowej wezla "poprzednik" */
-wezel* algorytm_dijkstry(graf *g, wezel *zrodlo, wezel *cel, int tryb)
+/* rozpoczecie nowego zapytania - zwiekszenie pokolenia kontekstu sprawia, ze dane */
+/* wszystkich wezlow z poprzednich zapytan staja sie nieaktualne bez przegladania grafu */
+/* jesli od ostatniego zapytania w grafie pojawily sie nowe sloty to powiekszamy tablice stanow */
+void nowe_zapytanie(kontekst_wyszukiwania *kontekst, graf *g)
 {
-  kopiec_min kopiec;
-  wezel *min;
-  krawedz *sasiad; /* wskaznik na sasiada wezla min */
-
-/* b.zrodlo - wskaznik na pierwszy wezel w liscie wezlow, zrodlo - opis powyzej */
-  budowanie_kopca(&kopiec, g->zrodlo, zrodlo, g->liczba_elementow);
+  int i;
 
-  while(kopiec.rozmiar > 0)
+  if(kontekst->pojemnosc < g->liczba_slotow)
   {
-    min = pobierz_minimalny(&kopiec);
-
-    /* jesli wezel o najmniejszej odleglosci od zrodla ma odleglosc rowna INT_MAX tzn. nieskonczonosc */
-    /* to znaczy ze wszystkie wezly do ktorych mozna dojsc z wezla zrodlowego zostaly juz przejrzane */
-    /* Innymi slowy opuscilismy spojna skladowa grafu zawierajaca wezel zrodlowy */
-    if(min->odleglosc == INT_MAX) /* wiec nie ma sensu poszukiwac dalej najkrotszej sciezki */
-      break;
-
-    sasiad = min->pierwszy; /* przechodzimy po liscie znajomych wezla min */
-    while(sasiad != NULL)
-    {
-      if(tryb == 1)
-      {
-        if(min->odleglosc+1 < sasiad->cel->odleglosc)
-        {
-          zmniejsz_odleglosc(&kopiec, sasiad->cel, min->odleglosc+1);
-          sasiad->cel->poprzednik = min;
-        }
-        if(sasiad->cel == cel)
-        {
-          free(kopiec.tablica);
-          return cel;
-        }
-      }
-      else /* tryb == 2 */
-        if(min->odleglosc + (min->liczba_krawedzi+1)*(11-sasiad->waga)
-           < sasiad->cel->odleglosc)
-        {
-          zmniejsz_odleglosc(&kopiec, sasiad->cel,
-            min->odleglosc + (min->liczba_krawedzi+1)*(11-sasiad->waga));
-          sasiad->cel->poprzednik = min;
-          sasiad->cel->liczba_krawedzi = min->liczba_krawedzi+1;
-        }
-      sasiad = sasiad->nastepny;
-    }
+    kontekst->stany = (stan_wezla*) realloc(kontekst->stany, g->pojemnosc_slotow*sizeof(stan_wezla));
+    for(i = kontekst->pojemnosc; i < g->pojemnosc_slotow; i++)
+      kontekst->stany[i].pokolenie = 0;
+    kontekst->pojemnosc = g->pojemnosc_slotow;
   }
-
-  free(kopiec.tablica);
-  if(cel->odleglosc < INT_MAX) /* jesli < INT_MAX to do wezla docelowego da sie dojsc z wezla zrodlowego */
-    return cel;
-  return NULL; /* przypadek gdy nie istnieje sciezka miedzy dwoma wezlami */
+  kontekst->pokolenie++;
+  if(kontekst->pokolenie == 0)
+  {/* licznik sie przepelnil (raz na 2^32 zapytan) - zerujemy pokolenia wszystkich stanow */
+    for(i = 0; i < kontekst->pojemnosc; i++)
+      kontekst->stany[i].pokolenie = 0;
+    kontekst->pokolenie = 1;
+  }
+  kontekst->kopiec.rozmiar = 0;
+  kontekst->liczba_odwiedzonych = 0;
 }
 
-/*********************** operacje na grafie *******************************/
-
-/* funkcja szuka w grafie wezla o identyfikatorze podanym jako argument
-   jesli wezel o podanym id istnieje w grafie to funkcja zwraca wskaznik
-   do tego wezla, w przeciwnym przypadku funkcja zwraca NULL */
-wezel* znajdz_wezel(graf *g, int id)
+/* funkcja zwraca wskaznik na stan wezla o podanym slocie, jesli wezel nie byl */
+/* jeszcze odkryty w biezacym zapytaniu to ustawiamy jego dane tak, */
+/* jakby byl nieosiagalny z wezla zrodlowego */
+stan_wezla* odswiezanie_wezla(kontekst_wyszukiwania *kontekst, int slot)
 {
-  wezel *wezelwsk;
-
-  if(g->zrodlo == NULL) /* przypadek gdy graf pusty */
-    return NULL;
-  if(g->zrodlo->id == id) /* przypadek gdy zrodlo jest szukanym wezlem */
-    return g->zrodlo;
+  stan_wezla *stan = &kontekst->stany[slot];
+
+  if(stan->pokolenie == kontekst->pokolenie)
+    return stan;
+  stan->pokolenie = kontekst->pokolenie;
+  stan->odleglosc = INT_MAX; /* za pomoca INT_MAX oznaczamy ze dany wezel jest nieosiagalny */
+  stan->pozycja_w_kopcu = -1;
+  stan->poprzednik = -1;
+  stan->liczba_krawedzi = 0;
+  stan->nastepnik = -1;
+  stan->strona = 0;
+  stan->cel_wyszukiwania = 0;
+  kontekst->liczba_odwiedzonych++;
+  return stan;
+}
 
-  wezelwsk = g->zrodlo; /* ogolny przypadek */
-  while(wezelwsk->nastepny != NULL)
+/* ustawienie mniejszej odleglosci wezla - jesli wezel nie jest jeszcze w kopcu */
+/* (zostal wlasnie odkryty) to jest do niego wstawiany */
+void aktualizacja_odleglosci(kontekst_wyszukiwania *kontekst, int slot, int nowa_odleglosc)
+{
+  if(kontekst->stany[slot].pozycja_w_kopcu < 0)
   {
-    wezelwsk = wezelwsk->nastepny;
-    if(wezelwsk->id == id)
-      return wezelwsk;
+    kontekst->stany[slot].odleglosc = nowa_odleglosc;
+    wstawianie_do_kopca(kontekst, slot);
   }
-  return NULL;
+  else
+    zmniejsz_odleglosc(kontekst, slot, nowa_odleglosc);
 }
 
-/* Jesli nie istnieje krawedz miedzy wezlami o identyfikatorach */
-/* id1, id2 to funkcja zwraca -1, w przeciwnym przypadku zwraca 0 */
-int zmiana_wagi_krawedzi(graf *g, wezel *wezel1, wezel *wezel2, int nowa_waga)
+/* numer kubelka, do ktorego trafia element o podanej odleglosci */
+int numer_kubelka(kolejka_kubelkowa *kolejka, unsigned int odleglosc)
 {
-  krawedz *krawedzwsk;
-
-  krawedzwsk = wezel1->pierwszy;
-  while(krawedzwsk != NULL)
+  unsigned int roznica = odleglosc ^ kolejka->ostatni;
+  int numer = 0;
+
+  if(roznica == 0)
+    return 0;
+#if defined(__GNUC__)
+  numer = 32 - __builtin_clz(roznica); /* pozycja najstarszego rozniacego sie bitu */
+#else
+  while(roznica != 0)
   {
-    if(krawedzwsk->cel == wezel2)
-    {
-      krawedzwsk->waga = nowa_waga;
-      return 0;
-    }
-    krawedzwsk = krawedzwsk->nastepny;
+    roznica >>= 1;
+    numer++;
   }
-  return -1;
+#endif
+  return numer;
 }
 
-/* zakladamy ze wezel o podanym id nie istnieje w grafie */
-/* funkcja zwraca wskaznik na nowo dodany wezel */
-wezel* dodawanie_wezla(graf *g, int id)
+/* dopisanie elementu na koniec kubelka, jesli tablica jest pelna to zwiekszamy ja dwukrotnie */
+void dodawanie_do_kubelka(kubelek *kubelekwsk, element_kubelka element)
 {
-  wezel *wezelwsk;
-  wezel *nowy = (wezel*) malloc(sizeof(wezel));
-
-  nowy->id = id;
-  nowy->nastepny = NULL;
-  nowy->pierwszy = NULL;
-
-  if(g->zrodlo == NULL) /* graf pusty */
-    g->zrodlo = nowy;
-  else
+  if(kubelekwsk->rozmiar == kubelekwsk->pojemnosc)
   {
-    wezelwsk = g->zrodlo;
-    while(wezelwsk->nastepny != NULL)
-      wezelwsk = wezelwsk->nastepny;
-    wezelwsk->nastepny = nowy;
+    kubelekwsk->pojemnosc = (kubelekwsk->pojemnosc == 0)? 16 : 2*kubelekwsk->pojemnosc;
+    kubelekwsk->tablica = (element_kubelka*) realloc(kubelekwsk->tablica,
+                            kubelekwsk->pojemnosc*sizeof(element_kubelka));
   }
-  return nowy;
+  kubelekwsk->tablica[kubelekwsk->rozmiar] = element;
+  kubelekwsk->rozmiar++;
 }
 
-/* waga1 mowi w jakim stopniu osoba 1 zna osobe 2, waga2 odwrotnie */
-/* Jesli waga1 lub waga2 nie miesci sie w przedziale [1, 10] */
-/* to funkcja zwraca -1, jesli krawedz istniala juz wczesniej */
-/* to funkcja zwraca -2, w przeciwnym przypadku funkcja zwraca 0 */
-int dodawanie_krawedzi(graf *g, wezel *wezel1, wezel *wezel2, int waga1, int waga2)
+/* wstawianie wezla do kolejki kubelkowej - odleglosc nie moze byc mniejsza */
+/* od ostatnio pobranej odleglosci; zmniejszenie odleglosci wezla wykonujemy */
+/* przez ponowne wstawienie go do kolejki (nieaktualne wpisy sa pomijane przy pobieraniu) */
+void wstawianie_do_kolejki_kubelkowej(kolejka_kubelkowa *kolejka, int slot, int odleglosc)
 {
-  krawedz *nowa1, *nowa2;
-  krawedz *krawedzwsk; /* wskaznik na dowolna krawedz */
+  element_kubelka element;
 
-  if(waga1 < 1 || 10 < waga1 || waga2 < 1 || 10 < waga2)
-    return -1;
+  element.odleglosc = odleglosc;
+  element.slot = slot;
+  dodawanie_do_kubelka(&kolejka->kubelki[numer_kubelka(kolejka, odleglosc)], element);
+  kolejka->rozmiar++;
+}
 
-  nowa1 = (krawedz*) malloc(sizeof(krawedz));
-  nowa2 = (krawedz*) malloc(sizeof(krawedz));
+/* pobranie elementu o najmniejszej odleglosci, jesli kolejka jest pusta to funkcja */
+/* zwraca -1, w przeciwnym przypadku 0 - gdy kubelek 0 jest pusty to znajdujemy */
+/* najmniejsza odleglosc w pierwszym niepustym kubelku i rozdzielamy jego elementy */
+/* do kubelkow o mniejszych numerach (kazdy element jest przenoszony co najwyzej 32 razy) */
+int pobierz_z_kolejki_kubelkowej(kolejka_kubelkowa *kolejka, element_kubelka *wynik)
+{
+  kubelek *kubelekwsk;
+  int i, j;
 
-  nowa1->cel = wezel2;
-  nowa2->cel = wezel1;
-  nowa1->waga = waga1;
-  nowa2->waga = waga2;
-  nowa1->nastepny = NULL;
-  nowa2->nastepny = NULL;
-
-  krawedzwsk = wezel1->pierwszy;
-  if(krawedzwsk == NULL) /* przypadek gdy pusta lista krawedzi */
-    wezel1->pierwszy = nowa1;
-  else if(krawedzwsk->cel == wezel2)
-    return -2; /* krawedz zostala dodana juz wczesniej (pierwsza krawedz) */
-  else
+  if(kolejka->rozmiar == 0)
+    return -1;
+  if(kolejka->kubelki[0].rozmiar == 0)
   {
-    while(krawedzwsk->nastepny != NULL)
-    {
-      krawedzwsk = krawedzwsk->nastepny;
-      if(krawedzwsk->cel == wezel2)
-        return -2; /* krawedz zostala dodana juz wczesniej */
-    }
-    krawedzwsk->nastepny = nowa1;
-  }
-
-  krawedzwsk = wezel2->pierwszy;
-  if(krawedzwsk == NULL) /* przypadek gdy pusta lista krawedzi */
-    wezel2->pierwszy = nowa2;
-  else /* tutaj juz nie trzeba sprawdzac czy istnieje krawedz, bo gdyby */
-  { /* istniala to zostalaby wykryta przy przechodzeniu listy krawedzi */
-    while(krawedzwsk->nastepny != NULL) /* wychodzacych od wezla1 */
-      krawedzwsk = krawedzwsk->nastepny;
-    krawedzwsk->nastepny = nowa2;
+    for(i = 1; kolejka->kubelki[i].rozmiar == 0; i++);
+    kubelekwsk = &kolejka->kubelki[i];
+    kolejka->ostatni = kubelekwsk->tablica[0].odleglosc;
+    for(j = 1; j < kubelekwsk->rozmiar; j++)
+      if(kubelekwsk->tablica[j].odleglosc < kolejka->ostatni)
+        kolejka->ostatni = kubelekwsk->tablica[j].odleglosc;
+    for(j = 0; j < kubelekwsk->rozmiar; j++)
+      dodawanie_do_kubelka(&kolejka->kubelki[numer_kubelka(kolejka, kubelekwsk->tablica[j].odleglosc)],
+                           kubelekwsk->tablica[j]);
+    kubelekwsk->rozmiar = 0;
   }
+  kubelekwsk = &kolejka->kubelki[0];
+  kubelekwsk->rozmiar--;
+  *wynik = kubelekwsk->tablica[kubelekwsk->rozmiar];
+  kolejka->rozmiar--;
   return 0;
 }
 
-/* rekurencyjne usuwanie wszystkich krawedzi wychodzacych wezla */
-/* krawedzwsk na poczatku pokazuje na pierwsza krawedz z listy krawedzi wychodzacych */
-void usuwanie_krawedzi_wychodzacych(krawedz *krawedzwsk)
+/* oznaczanie celow wyszukiwania z jednego zrodla do wielu celow (powtorzenia */
+/* celow sa pomijane), zwraca liczbe roznych celow, a w zmiennej pozostalo liczbe */
+/* celow, ktore trzeba jeszcze osiagnac - cel bedacy zrodlem jest od razu osiagniety */
+/* funkcja jest wywolywana po nowe_zapytanie i ustawieniu odleglosci zrodla */
+int oznaczanie_celow(kontekst_wyszukiwania *kontekst, int zrodlo,
+                     int *cele, int liczba_celow, int *pozostalo)
 {
-  if(krawedzwsk == NULL)
-    return ;
-  usuwanie_krawedzi_wychodzacych(krawedzwsk->nastepny);
-  free(krawedzwsk);
-}
-
-/* jesli nie istnieje krawedz z wezla zrodlowego do wezla docelowego */
-/* to funkcja nie robic nic */
-void usuwanie_krawedzi_wchodzacej(wezel *zrodlo, wezel *cel)
-{
-  krawedz *krawedzwsk, *temp;
-  if(zrodlo->pierwszy == NULL)
-    return ; /* przypadek gdy pusta lista krawedzi */
+  stan_wezla *stan;
+  int i, liczba_roznych = 0;
 
-  /* przypadek gdy pierwsza krawedz wychodzaca wezla zrodlowego
-  jest krawedzia wchodzaca wezla docelowego */
-  if(zrodlo->pierwszy->cel == cel)
-  {
-    temp = zrodlo->pierwszy->nastepny;
-    free(zrodlo->pierwszy);
-    zrodlo->pierwszy = temp;
-    return ;
-  }
-  /* przypadek ogolny */
-  krawedzwsk = zrodlo->pierwszy;
-  while(krawedzwsk->nastepny != NULL)
+  *pozostalo = 0;
+  for(i = 0; i < liczba_celow; i++)
   {
-    if(krawedzwsk->nastepny->cel == cel)
+    stan = odswiezanie_wezla(kontekst, cele[i]);
+    if(stan->cel_wyszukiwania != 0)
+      continue;
+    liczba_roznych++;
+    if(cele[i] == zrodlo)
+      stan->cel_wyszukiwania = 2;
+    else
     {
-      temp = krawedzwsk->nastepny->nastepny;
-      free(krawedzwsk->nastepny);
-      krawedzwsk->nastepny = temp;
-      return ;
+      stan->cel_wyszukiwania = 1;
+      (*pozostalo)++;
     }
-    krawedzwsk = krawedzwsk->nastepny;
   }
+  return liczba_roznych;
 }
 
-/* usuwanie wezla razem ze wszystkimi krawedziami wchodzacymi i wychodzacymi */
-/* jesli wezel o identyfikatorze id nie istnieje w grafie funkcja zwraca -1 */
-/* w przeciwnym przypadku zwraca 0 */
-int usuwanie_wezla(graf *g, int id)
+/* po wyszukiwaniu funkcja sprawdza czy wezel zostal osiagniety ze zrodla */
+/* (dla celow wyszukiwania oznacza to, ze ich odleglosc jest juz ostateczna) */
+bool wezel_osiagniety(kontekst_wyszukiwania *kontekst, wezel *wezelwsk)
 {
-  wezel *usuwany, *wezelwsk, *temp;
-  bool usuniety = false;
-
-  usuwany = znajdz_wezel(g, id);
-
-  if(usuwany == NULL)
-    return -1;
-
-  usuwanie_krawedzi_wychodzacych(usuwany->pierwszy);
-  usuwany->pierwszy = NULL;
+  stan_wezla *stan = &kontekst->stany[wezelwsk->slot];
+  return stan->pokolenie == kontekst->pokolenie && stan->odleglosc != INT_MAX;
+}
 
-  /* przypadek gdy usuwany wezel to pierwszy wezel grafu */
-  if(g->zrodlo == usuwany)
+/* wyszukiwanie najskuteczniejszych sciezek (tryb == 2) algorytmem Dijkstry */
+/* z kolejka kubelkowa zamiast kopca - koszty krawedzi sa malymi liczbami calkowitymi, */
+/* a odleglosci pobierane z kolejki nie maleja, wiec kolejka kubelkowa jest szybsza */
+/* wynik i znaczenie argumentow takie same jak w funkcji algorytm_dijkstry_slotow */
+int algorytm_dijkstry_kubelkowy(graf *g, kontekst_wyszukiwania *kontekst, int zrodlo,
+                                int *cele, int liczba_celow)
+{
+  kolejka_kubelkowa *kolejka = &kontekst->kubelki;
+  migawka_csr *m = &g->migawka;
+  element_kubelka element;
+  stan_wezla *min, *stan_sasiada;
+  int i, j, sasiad, nowa_odleglosc, liczba_roznych, pozostalo;
+
+  aktualizacja_migawki(g);
+  nowe_zapytanie(kontekst, g);
+  for(i = 0; i < LICZBA_KUBELKOW; i++)
+    kolejka->kubelki[i].rozmiar = 0;
+  kolejka->rozmiar = 0;
+  kolejka->ostatni = 0;
+  odswiezanie_wezla(kontekst, zrodlo)->odleglosc = 0;
+  liczba_roznych = oznaczanie_celow(kontekst, zrodlo, cele, liczba_celow, &pozostalo);
+  if(liczba_celow > 0 && pozostalo == 0)
+    return liczba_roznych;
+  wstawianie_do_kolejki_kubelkowej(kolejka, zrodlo, 0);
+
+  while(pobierz_z_kolejki_kubelkowej(kolejka, &element) == 0)
   {
-    temp = g->zrodlo->nastepny;
-    free(g->zrodlo);
-    g->zrodlo = temp;
-    usuniety = true;
-  }
-  else
-    usuwanie_krawedzi_wchodzacej(g->zrodlo, usuwany);
+    min = &kontekst->stany[element.slot];
+    /* wpis nieaktualny - odleglosc wezla zostala pozniej zmniejszona */
+    if((int)element.odleglosc != min->odleglosc)
+      continue;
+    if(min->cel_wyszukiwania == 1)
+    {
+      min->cel_wyszukiwania = 2;
+      if(--pozostalo == 0)
+        break;
+    }
 
-  wezelwsk = g->zrodlo;
-  while(wezelwsk->nastepny != NULL)
-  {
-    if(!usuniety)
-      if(wezelwsk->nastepny == usuwany)
+    for(j = m->poczatki[element.slot]; j < m->konce[element.slot]; j++)
+    {
+      sasiad = m->sasiedzi[j];
+      stan_sasiada = odswiezanie_wezla(kontekst, sasiad);
+      nowa_odleglosc = min->odleglosc + (min->liczba_krawedzi+1)*(11-m->wagi[j]);
+      if(nowa_odleglosc < stan_sasiada->odleglosc)
       {
-        temp = usuwany->nastepny;
-        free(usuwany);
-        wezelwsk->nastepny = temp;
-        usuniety = true;
-        continue;
+        stan_sasiada->odleglosc = nowa_odleglosc;
+        stan_sasiada->poprzednik = element.slot;
+        stan_sasiada->liczba_krawedzi = min->liczba_krawedzi+1;
+        wstawianie_do_kolejki_kubelkowej(kolejka, sasiad, nowa_odleglosc);
       }
-    wezelwsk = wezelwsk->nastepny;
-    usuwanie_krawedzi_wchodzacej(wezelwsk, usuwany);
+    }
   }
-  return 0;
+  return liczba_roznych - pozostalo;
 }
 
-/* ogolne usuwanie krawedzi miedzy dwoma wezlami */
-/* funkcja zwraca -1 gdy w grafie nie istnieje ktorys z wezlow */
-/* o identyfikatorach id1 lub id2. Jesli krawedz miedzy tymi wezlami */
-/* nie istnieje to funkcja zwraca -2, w przeciwnym przypadku 0 */
-int usuwanie_krawedzi(graf *g, int id1, int id2)
+/* wyszukiwanie sciezek z jednego wezla (zrodla) do wielu celow w jednym przebiegu */
+/* algorytmu Dijkstry - przeszukiwanie konczy sie, gdy wszystkie osiagalne cele maja */
+/* juz ostateczne odleglosci (tryb == 1 - cel jest gotowy od razu po odkryciu, */
+/* tryb == 2 - po zdjeciu z kopca); jesli liczba_celow == 0 to wyznaczane jest */
+/* cale drzewo najkrotszych sciezek ze zrodla */
+/* funkcja zwraca liczbe roznych osiagnietych celow, sciezke do kazdego z nich */
+/* odtwarzamy za pomoca pola "poprzednik" stanow wezlow w kontekscie, a to czy */
+/* dany wezel zostal osiagniety sprawdza funkcja wezel_osiagniety */
+/* jesli kontekst->rodzaj_kolejki == KOLEJKA_KUBELKOWA to najskuteczniejsze sciezki */
+/* sa wyszukiwane z uzyciem kolejki kubelkowej zamiast kopca */
+/* zrodlo i cele sa podane numerami slotow - algorytm korzysta tylko z migawki CSR, */
+/* wiec dziala tez na grafie odwzorowanym z pliku binarnego (bez wezlow) */
+int algorytm_dijkstry_slotow(graf *g, kontekst_wyszukiwania *kontekst, int zrodlo,
+                             int *cele, int liczba_celow, int tryb)
 {
-  wezel *wezel1, *wezel2;
-  krawedz *krawedzwsk, *temp;
-  bool istnieje_krawedz = false;
-
-  wezel1 = znajdz_wezel(g, id1);
-  wezel2 = znajdz_wezel(g, id2);
+  migawka_csr *m = &g->migawka;
+  stan_wezla *min, *stan_sasiada;
+  int slot_min, j, sasiad, koszt, liczba_roznych, pozostalo;
+
+  if(tryb == 2 && kontekst->rodzaj_kolejki == KOLEJKA_KUBELKOWA)
+    return algorytm_dijkstry_kubelkowy(g, kontekst, zrodlo, cele, liczba_celow);
+
+  aktualizacja_migawki(g);
+  nowe_zapytanie(kontekst, g);
+  odswiezanie_wezla(kontekst, zrodlo)->odleglosc = 0;
+  liczba_roznych = oznaczanie_celow(kontekst, zrodlo, cele, liczba_celow, &pozostalo);
+  if(liczba_celow > 0 && pozostalo == 0)
+    return liczba_roznych;
+  wstawianie_do_kopca(kontekst, zrodlo);
+
+  /* gdy kopiec sie oprozni to przejrzelismy cala spojna skladowa grafu */
+  /* zawierajaca wezel zrodlowy, wiec nie ma sensu poszukiwac dalej najkrotszej sciezki */
+  while(kontekst->kopiec.rozmiar > 0)
+  {
+    slot_min = pobierz_minimalny(kontekst);
+    min = &kontekst->stany[slot_min];
 
-  if(wezel1 == NULL || wezel2 == NULL)
-    return -1;
+    /* wezel zdjety z kopca ma juz ostateczna odleglosc od zrodla */
+    if(tryb == 2 && min->cel_wyszukiwania == 1)
+    {
+      min->cel_wyszukiwania = 2;
+      if(--pozostalo == 0)
+        break;
+    }
 
-  krawedzwsk = wezel1->pierwszy;
-  if(krawedzwsk == NULL) /* przypadek gdy pusta lista krawedzi */
-    return -2;
-  else if(krawedzwsk->cel->id == id2)
-  {/* przypadek gdy szukana krawedz to pierwsza krawedz */
-    temp = krawedzwsk->nastepny;
-    free(krawedzwsk);
-    wezel1->pierwszy = temp;
-  }
-  else
-  {
-    while(krawedzwsk->nastepny != NULL)
+    /* przechodzimy po znajomych wezla min */
+    for(j = m->poczatki[slot_min]; j < m->konce[slot_min]; j++)
     {
-      krawedzwsk = krawedzwsk->nastepny;
-      if(krawedzwsk->cel->id == id2)
+      sasiad = m->sasiedzi[j];
+      stan_sasiada = odswiezanie_wezla(kontekst, sasiad);
+      if(tryb == 1)
       {
-        istnieje_krawedz = true;
-        temp = krawedzwsk->nastepny;
-        free(krawedzwsk);
-        krawedzwsk = temp;
-        break;
+        if(min->odleglosc+1 < stan_sasiada->odleglosc)
+        {
+          aktualizacja_odleglosci(kontekst, sasiad, min->odleglosc+1);
+          stan_sasiada->poprzednik = slot_min;
+        }
+        /* przy jednakowych kosztach krawedzi pierwsze odkrycie wezla */
+        /* wyznacza juz jego najkrotsza sciezke */
+        if(stan_sasiada->cel_wyszukiwania == 1)
+        {
+          stan_sasiada->cel_wyszukiwania = 2;
+          if(--pozostalo == 0)
+            return liczba_roznych;
+        }
+      }
+      else /* tryb == 2 */
+      {
+        koszt = min->odleglosc + (min->liczba_krawedzi+1)*(11-m->wagi[j]);
+        if(koszt < stan_sasiada->odleglosc)
+        {
+          aktualizacja_odleglosci(kontekst, sasiad, koszt);
+          stan_sasiada->poprzednik = slot_min;
+          stan_sasiada->liczba_krawedzi = min->liczba_krawedzi+1;
+        }
       }
     }
-    if(!istnieje_krawedz)
-      return -2;
   }
+  return liczba_roznych - pozostalo;
+}
 
-  /* tutaj mamy pewnosc ze szukana krawedz istnieje */
-  krawedzwsk = wezel2->pierwszy;
-  if(krawedzwsk->cel->id == id1)
-  {/* przypadek gdy szukana krawedz to pierwsza krawedz */
-    temp = krawedzwsk->nastepny;
-    free(krawedzwsk);
-    wezel2->pierwszy = temp;
+/* to samo co algorytm_dijkstry_slotow dla zrodla i celow podanych jako wezly */
+int algorytm_dijkstry_wiele_celow(graf *g, kontekst_wyszukiwania *kontekst, wezel *zrodlo,
+                                  wezel **cele, int liczba_celow, int tryb)
+{
+  int i;
+
+  if(kontekst->pojemnosc_celow < liczba_celow)
+  {
+    kontekst->pojemnosc_celow = liczba_celow;
+    kontekst->sloty_celow = (int*) realloc(kontekst->sloty_celow, liczba_celow*sizeof(int));
   }
-  else
-  {/* przypadek gdy szukana krawedz nie jeste pierwsza krawedzia */
-    while(krawedzwsk->nastepny != NULL)
+  for(i = 0; i < liczba_celow; i++)
+    kontekst->sloty_celow[i] = cele[i]->slot;
+  return algorytm_dijkstry_slotow(g, kontekst, zrodlo->slot, kontekst->sloty_celow,
+                                  liczba_celow, tryb);
+}
+
+/* jesli tryb == 1 to wyszukiwanie najszybszej sciezki, jesli tryb == 2 */
+/* to wyszukiwanie najskuteczniejszej sciezki */
+/* zrodlo i cel to wskazniki na wezly miedzy ktorymi szukamy najlepszej sciezki */
+/* zakladamy ze te wezly istnieja w grafie */
+/* jesli nie istnieje sciezka miedzy dwoma wezlami to funkcja zwraca NULL */
+/* w przeciwnym przypadku funkcja zwraca wskaznik do wezla cel, z ktorego mozemy */
+/* odtworzyc sciezke za pomoca pola "poprzednik" stanow wezlow w kontekscie */
+/* do kopca trafiaja tylko wezly odkryte w trakcie przeszukiwania, wiec koszt */
+/* zapytania zalezy od wielkosci przejrzanego fragmentu grafu, a nie calej bazy */
+wezel* algorytm_dijkstry(graf *g, kontekst_wyszukiwania *kontekst, wezel *zrodlo, wezel *cel, int tryb)
+{
+  if(algorytm_dijkstry_slotow(g, kontekst, zrodlo->slot, &cel->slot, 1, tryb) == 0)
+    return NULL; /* przypadek gdy nie istnieje sciezka miedzy dwoma wezlami */
+  return cel;
+}
+
+/************** dwukierunkowe przeszukiwanie wszerz *******************/
+
+/* dopisanie wezla na koniec kolejki, jesli tablica jest pelna to zwiekszamy ja dwukrotnie */
+void dodawanie_do_kolejki(kolejka_wezlow *kolejka, int slot)
+{
+  if(kolejka->rozmiar == kolejka->pojemnosc)
+  {
+    kolejka->pojemnosc = (kolejka->pojemnosc == 0)? 16 : 2*kolejka->pojemnosc;
+    kolejka->tablica = (int*) realloc(kolejka->tablica, kolejka->pojemnosc*sizeof(int));
+  }
+  kolejka->tablica[kolejka->rozmiar] = slot;
+  kolejka->rozmiar++;
+}
+
+/* wyszukiwanie najszybszej sciezki (najmniejsza liczba posrednikow) */
+/* przeszukujemy graf wszerz jednoczesnie od zrodla i od celu, za kazdym razem */
+/* rozwijajac caly poziom mniejszego frontu, az oba przeszukiwania sie spotkaja */
+/* znajomosci sa zawsze dodawane parami (dodawanie_krawedzi), wiec przeszukiwanie */
+/* od strony celu moze przechodzic po listach znajomych tak samo jak od zrodla */
+/* wynik jest taki sam jak w algorytmie Dijkstry dla tryb == 1 - funkcja zwraca */
+/* true, gdy sciezka istnieje (odtwarzamy ja od slotu celu za pomoca pola "poprzednik" */
+/* stanow wezlow), a false w przeciwnym przypadku; w kontekst->liczba_odwiedzonych */
+/* zostaje liczba odkrytych wezlow; zrodlo i cel sa podane numerami slotow */
+bool przeszukiwanie_dwukierunkowe_slotow(graf *g, kontekst_wyszukiwania *kontekst, int zrodlo, int cel)
+{
+  kolejka_wezlow *kolejka;
+  migawka_csr *m = &g->migawka;
+  stan_wezla *stan, *stan_sasiada;
+  int slot, sasiad, poprzedni, nastepny;
+  int spotkanie_zrodlo = -1, spotkanie_cel = -1; /* krawedz w ktorej spotkaly sie fronty */
+  int i, j, strona, koniec_poziomu, najkrotsza = INT_MAX;
+
+  aktualizacja_migawki(g);
+  nowe_zapytanie(kontekst, g);
+  kontekst->kolejki[0].rozmiar = kontekst->kolejki[0].poczatek = 0;
+  kontekst->kolejki[1].rozmiar = kontekst->kolejki[1].poczatek = 0;
+  stan = odswiezanie_wezla(kontekst, zrodlo);
+  stan->odleglosc = 0;
+  stan->strona = 1;
+  dodawanie_do_kolejki(&kontekst->kolejki[0], zrodlo);
+  stan = odswiezanie_wezla(kontekst, cel);
+  stan->odleglosc = 0;
+  stan->strona = 2;
+  dodawanie_do_kolejki(&kontekst->kolejki[1], cel);
+
+  /* jesli ktorys z frontow jest pusty to nie istnieje sciezka miedzy wezlami */
+  while(kontekst->kolejki[0].poczatek < kontekst->kolejki[0].rozmiar &&
+        kontekst->kolejki[1].poczatek < kontekst->kolejki[1].rozmiar)
+  {
+    /* wybieramy strone o mniejszym froncie */
+    if(kontekst->kolejki[0].rozmiar - kontekst->kolejki[0].poczatek <=
+       kontekst->kolejki[1].rozmiar - kontekst->kolejki[1].poczatek)
+      strona = 1;
+    else
+      strona = 2;
+    kolejka = &kontekst->kolejki[strona-1];
+
+    koniec_poziomu = kolejka->rozmiar;
+    for(i = kolejka->poczatek; i < koniec_poziomu; i++)
     {
-      krawedzwsk = krawedzwsk->nastepny;
-      if(krawedzwsk->cel->id == id1)
+      slot = kolejka->tablica[i];
+      stan = &kontekst->stany[slot];
+      for(j = m->poczatki[slot]; j < m->konce[slot]; j++)
       {
-        temp = krawedzwsk->nastepny;
-        free(krawedzwsk);
-        krawedzwsk = temp;
-        break;
+        sasiad = m->sasiedzi[j];
+        stan_sasiada = odswiezanie_wezla(kontekst, sasiad);
+        if(stan_sasiada->strona == 0)
+        {/* nowy wezel biezacego przeszukiwania */
+          stan_sasiada->strona = strona;
+          stan_sasiada->odleglosc = stan->odleglosc+1;
+          if(strona == 1)
+            stan_sasiada->poprzednik = slot;
+          else
+            stan_sasiada->nastepnik = slot;
+          dodawanie_do_kolejki(kolejka, sasiad);
+        }
+        else if(stan_sasiada->strona != strona &&
+                stan->odleglosc + 1 + stan_sasiada->odleglosc < najkrotsza)
+        {/* fronty sie spotkaly - zapamietujemy najkrotsze polaczenie w tym poziomie */
+          najkrotsza = stan->odleglosc + 1 + stan_sasiada->odleglosc;
+          spotkanie_zrodlo = (strona == 1)? slot : sasiad;
+          spotkanie_cel = (strona == 1)? sasiad : slot;
+        }
       }
     }
+    kolejka->poczatek = koniec_poziomu;
+    /* poziom zostal rozwiniety do konca, wiec znalezione polaczenie jest najkrotsze */
+    if(spotkanie_zrodlo >= 0)
+      break;
   }
-  return 0;
+  if(spotkanie_zrodlo < 0)
+    return false;
+
+  /* przepisujemy sciezke od miejsca spotkania do celu na pola "poprzednik" */
+  poprzedni = spotkanie_zrodlo;
+  slot = spotkanie_cel;
+  while(slot >= 0)
+  {
+    nastepny = kontekst->stany[slot].nastepnik;
+    kontekst->stany[slot].poprzednik = poprzedni;
+    poprzedni = slot;
+    slot = nastepny;
+  }
+  return true;
 }
 
-/* rekurencyjna funkcja uzywana w zwalnianiu pamieci calego grafu */
-/* usuwane sa w niej tez wszystkie krawedzie */
-/* wezelwsk na poczatku pokazuje na pierwszy wezel z listy wszystkich wezlow grafu */
-void usuwanie_wszystkich_wezlow(wezel *wezelwsk)
+/* to samo co przeszukiwanie_dwukierunkowe_slotow dla wezlow - funkcja zwraca */
+/* wezel cel lub NULL gdy sciezka nie istnieje */
+wezel* przeszukiwanie_dwukierunkowe(graf *g, kontekst_wyszukiwania *kontekst, wezel *zrodlo, wezel *cel)
 {
-  if(wezelwsk == NULL)
-    return ;
-  usuwanie_wszystkich_wezlow(wezelwsk->nastepny);
-  usuwanie_krawedzi_wychodzacych(wezelwsk->pierwszy);
-  free(wezelwsk);
+  if(!przeszukiwanie_dwukierunkowe_slotow(g, kontekst, zrodlo->slot, cel->slot))
+    return NULL;
+  return cel;
 }
 
 /*************************** sortowanie ***********************************/
@@ -548,11 +1247,77 @@ int string_compare(char* napis1, char* napis2)
   }
 }
 
+/* klucz sortowania napisu - pierwsze 16 znakow napisu po zamianie na male litery */
+/* (tak jak w string_compare) zapisane po jednym bajcie w dwoch liczbach 64-bitowych, */
+/* od najstarszego bajtu; tolower zwraca wartosci od -1 (EOF - znak 255) do 255, */
+/* ktore zapisujemy jako 0 - 254 (254 i 255 dostaja ten sam bajt), a koniec napisu */
+/* i dalsze bajty jako 255, bo w string_compare krotszy napis jest wiekszy; */
+/* rozne klucze sa wiec uporzadkowane tak samo jak napisy, a dopiero przy rownych */
+/* kluczach trzeba porownac cale napisy; funkcja zwraca true, gdy klucz zawiera */
+/* caly napis (krotszy niz 16 znakow i bez znakow o wspolnym bajcie) - rowne */
+/* pelne klucze oznaczaja rowne napisy */
+bool liczenie_klucza_sortowania(const char *napis, uint64_t *klucz)
+{
+  bool pelny = true;
+  int i, znak;
+
+  klucz[0] = klucz[1] = 0;
+  for(i = 0; i < 16; i++)
+  {
+    klucz[i/8] <<= 8;
+    if(*napis == '\0')
+      klucz[i/8] |= 255;
+    else
+    {
+      znak = tolower(*napis++);
+      if(znak <= 0 || znak >= 254)
+      {
+        pelny = false;
+        znak = (znak <= 0)? 0 : 254;
+      }
+      klucz[i/8] |= (uint64_t)znak;
+    }
+  }
+  return pelny && (klucz[1] & 255) == 255;
+}
+
+/* klucze sortowania liczymy raz, po wpisaniu imienia i nazwiska osoby */
+void ustawianie_kluczy_sortowania(wezel *wezelwsk)
+{
+  wezelwsk->pelny_klucz_imienia =
+    liczenie_klucza_sortowania(wezelwsk->pierwsze_imie, wezelwsk->klucz_imienia);
+  wezelwsk->pelny_klucz_nazwiska =
+    liczenie_klucza_sortowania(wezelwsk->nazwisko, wezelwsk->klucz_nazwiska);
+}
+
+/* klucz liczbowy osoby w trybach sortowania 1 (id), 4 (numer telefonu) i 5 (kod */
+/* pocztowy - cyfry kodu jako jedna liczba, np. "01-234" -> 1234); do liczb ze */
+/* znakiem dodajemy 2^31, zeby kolejnosc kluczy bez znaku byla kolejnoscia liczb */
+uint32_t klucz_liczbowy(wezel *wezelwsk, int tryb)
+{
+  uint32_t kod = 0;
+  int i;
+
+  if(tryb == 1)
+    return (uint32_t)wezelwsk->id ^ 0x80000000u;
+  if(tryb == 4)
+    return (uint32_t)wezelwsk->nr_telefonu ^ 0x80000000u;
+  for(i = 0; i < 7 && wezelwsk->adres.kod_pocztowy[i] != '\0'; i++)
+    if(isdigit((unsigned char)wezelwsk->adres.kod_pocztowy[i]))
+      kod = kod*10 + (uint32_t)(wezelwsk->adres.kod_pocztowy[i] - '0');
+  return kod;
+}
+
 /* porownywanie zwracajace 1 gdy pierwszy element wiekszy od drugiego, -1 gdy pierwszy mniejszy */
 /* od drugiego, 0 gdy sa rowne (tak samo jak biblioteczne funkcje porownujace np. strcmp) */
 /* tryb == 1 - porownywanie identyfikatorow, tryb == 2 - porownywanie imion, tryb == 3 - porownywanie nazwisk */
+/* tryb == 4 - porownywanie numerow telefonu, tryb == 5 - porownywanie kodow pocztowych */
+/* imiona i nazwiska porownujemy najpierw kluczami sortowania, a napisy tylko przy rownych kluczach */
 int porownywanie(wezel *wsk1, wezel *wsk2, int tryb)
 {
+  uint64_t *klucz1, *klucz2;
+  uint32_t liczba1, liczba2;
+
   if(tryb == 1)
   {
     if(wsk1->id > wsk2->id)
@@ -561,596 +1326,3788 @@ int porownywanie(wezel *wsk1, wezel *wsk2, int tryb)
       return -1;
     else return 0;
   }
-  else
-    return string_compare((tryb == 2)? wsk1->pierwsze_imie : wsk1->nazwisko,
-                          (tryb == 2)? wsk2->pierwsze_imie : wsk2->nazwisko);
-/* powyzej dwukrotnie zostalo uzyte wyrazenie warunkowe */
+  if(tryb >= 4)
+  {
+    liczba1 = klucz_liczbowy(wsk1, tryb);
+    liczba2 = klucz_liczbowy(wsk2, tryb);
+    return (liczba1 > liczba2) - (liczba1 < liczba2);
+  }
+  klucz1 = (tryb == 2)? wsk1->klucz_imienia : wsk1->klucz_nazwiska;
+  klucz2 = (tryb == 2)? wsk2->klucz_imienia : wsk2->klucz_nazwiska;
+  if(klucz1[0] != klucz2[0])
+    return (klucz1[0] > klucz2[0])? 1 : -1;
+  if(klucz1[1] != klucz2[1])
+    return (klucz1[1] > klucz2[1])? 1 : -1;
+  if((tryb == 2)? wsk1->pelny_klucz_imienia && wsk2->pelny_klucz_imienia :
+                  wsk1->pelny_klucz_nazwiska && wsk2->pelny_klucz_nazwiska)
+    return 0;
+  return string_compare((tryb == 2)? wsk1->pierwsze_imie : wsk1->nazwisko,
+                        (tryb == 2)? wsk2->pierwsze_imie : wsk2->nazwisko);
+/* powyzej kilkukrotnie zostalo uzyte wyrazenie warunkowe */
 /* jesli tryb == 2 to porownywane sa imiona dwoch osob jesli tryb == 3 to nazwiska */
 }
 
-/* wsk1 jest wskaznikiem na wezly pierwszej listy, wsk2 na wezly drugiej */
-/* na poczatku wsk1 i wsk2 pokazuja na pierwsze elementy obu list. wsk3 jest wskaznikiem na wezly */
-/* posortowanej listy bedacej wynikiem scalenia obu list wskazywanych przez wsk1 i wsk2 */
-/* funkcja zwraca wskaznik do pierwszego wezla posortowanej, scalonej listy */
-wezel* scalanie_list(wezel *wsk1, wezel *wsk2, int tryb)
+/* uruchomienie funkcji dla kazdego elementu tablicy argumentow (elementy maja */
+/* podany rozmiar) w osobnym watku - pierwszy element obsluguje watek wywolujacy; */
+/* funkcja czeka na zakonczenie wszystkich watkow */
+void uruchamianie_watkow(void *argumenty, size_t rozmiar_argumentu, int liczba_watkow,
+                         void* (*funkcja)(void*))
 {
-  wezel *wsk3;
-  wezel *pierwszy;
+  pthread_t *identyfikatory = (pthread_t*) malloc(liczba_watkow*sizeof(pthread_t));
+  int i;
+
+  for(i = 1; i < liczba_watkow; i++)
+    pthread_create(&identyfikatory[i], NULL, funkcja, (char*)argumenty + i*rozmiar_argumentu);
+  funkcja(argumenty);
+  for(i = 1; i < liczba_watkow; i++)
+    pthread_join(identyfikatory[i], NULL);
+  free(identyfikatory);
+}
+
+#define DLUGOSC_SERII_WSTAWIANIA 16 /* krotkie serie sortujemy przez wstawianie */
+#define PROG_SORTOWANIA_WATKAMI 32768 /* najmniejsza liczba osob na jeden watek */
+
+/* scalanie posortowanych fragmentow pierwszy[0..n1) i drugi[0..n2) do tablicy cel, */
+/* az do zapisania ile osob; przy rownych osobach najpierw bierzemy osobe */
+/* z pierwszego fragmentu - dzieki temu sortowanie jest stabilne */
+void scalanie_fragmentow(wezel **pierwszy, int n1, wezel **drugi, int n2,
+                         wezel **cel, int ile, int tryb)
+{
+  int i = 0, j = 0, k = 0;
 
-  if(porownywanie(wsk1, wsk2, tryb) < 0)
+  while(k < ile && i < n1 && j < n2)
   {
-    pierwszy = wsk1;
-    wsk1 = wsk1->nastepny;
+    if(porownywanie(drugi[j], pierwszy[i], tryb) < 0)
+      cel[k++] = drugi[j++];
+    else
+      cel[k++] = pierwszy[i++];
   }
-  else
+  if(k < ile && i < n1)
+    memcpy(cel+k, pierwszy+i, (ile-k)*sizeof(wezel*));
+  else if(k < ile)
+    memcpy(cel+k, drugi+j, (ile-k)*sizeof(wezel*));
+}
+
+/* liczba osob z fragmentu pierwszy[0..n1), ktore po scaleniu z fragmentem */
+/* drugi[0..n2) trafiaja na pierwsze k miejsc (wyszukiwanie binarne); pozwala */
+/* podzielic jedno scalanie miedzy kilka watkow */
+int podzial_scalania(wezel **pierwszy, int n1, wezel **drugi, int n2, int k, int tryb)
+{
+  int lewy = (k > n2)? k-n2 : 0;
+  int prawy = (k < n1)? k : n1;
+  int i;
+
+  while(lewy < prawy)
   {
-    pierwszy = wsk2;
-    wsk2 = wsk2->nastepny;
+    i = lewy + (prawy-lewy)/2;
+    if(porownywanie(drugi[k-i-1], pierwszy[i], tryb) < 0)
+      prawy = i;
+    else
+      lewy = i+1;
   }
-  wsk3 = pierwszy;
-  while(wsk1 != NULL && wsk2 != NULL)
+  return lewy;
+}
+
+/* stabilne sortowanie tablicy n osob przez scalanie od dolu: najpierw krotkie */
+/* serie przez wstawianie, potem scalanie serii coraz dluzszych na przemian */
+/* do bufora i z powrotem; bufor ma n miejsc, wynik jest zawsze w tablicy */
+void sortowanie_fragmentu(wezel **tablica, wezel **bufor, int n, int tryb)
+{
+  wezel **zrodlo = tablica, **cel = bufor, **temp, *wezelwsk;
+  int i, j, poczatek, srodek, koniec, szerokosc;
+
+  for(poczatek = 0; poczatek < n; poczatek += DLUGOSC_SERII_WSTAWIANIA)
   {
-    if(porownywanie(wsk1, wsk2, tryb) < 0)
+    koniec = (poczatek + DLUGOSC_SERII_WSTAWIANIA < n)? poczatek + DLUGOSC_SERII_WSTAWIANIA : n;
+    for(i = poczatek+1; i < koniec; i++)
     {
-      wsk3->nastepny = wsk1;
-      wsk3 = wsk3->nastepny;
-      wsk1 = wsk1->nastepny;
+      wezelwsk = tablica[i];
+      for(j = i; j > poczatek && porownywanie(wezelwsk, tablica[j-1], tryb) < 0; j--)
+        tablica[j] = tablica[j-1];
+      tablica[j] = wezelwsk;
     }
-    else
+  }
+  for(szerokosc = DLUGOSC_SERII_WSTAWIANIA; szerokosc < n; szerokosc *= 2)
+  {
+    for(poczatek = 0; poczatek < n; poczatek += 2*szerokosc)
     {
-      wsk3->nastepny = wsk2;
-      wsk3 = wsk3->nastepny;
-      wsk2 = wsk2->nastepny;
+      srodek = (poczatek + szerokosc < n)? poczatek + szerokosc : n;
+      koniec = (srodek + szerokosc < n)? srodek + szerokosc : n;
+      scalanie_fragmentow(zrodlo+poczatek, srodek-poczatek, zrodlo+srodek, koniec-srodek,
+                          cel+poczatek, koniec-poczatek, tryb);
     }
+    temp = zrodlo;
+    zrodlo = cel;
+    cel = temp;
   }
-  if(wsk1 != NULL)
-    wsk3->nastepny = wsk1;
-  if(wsk2 != NULL)
-    wsk3->nastepny = wsk2;
-  return pierwszy;
+  if(zrodlo != tablica)
+    memcpy(tablica, zrodlo, n*sizeof(wezel*));
 }
 
-/* pierwszy to wskaznik na pierwszy wezel listy ktora chcemy posortowac */
-/* funkcja zwraca wskaznik na pierwszy wezel posortowanej listy */
-/* tryb == 1 - sortowanie po identyfikatorach, tryb == 2 - sortowanie po imionach */
-/* tryb == 3 - sortowanie po nazwiskach */
-wezel* sortowanie_przez_scalanie(wezel *pierwszy, int n, int tryb)
+/* czesc sortowania wykonywana przez jeden watek: najpierw watek sortuje swoj */
+/* fragment tablicy, a potem w kazdej rundzie scalania wypelnia swoj fragment */
+/* wyniku [poczatek, koniec) - scalane serie opisuja wspolne granice */
+typedef struct
 {
-  int i, srodek;
-  wezel *wezelwsk, *temp;
-  wezel *pierwszy1, *pierwszy2;
-
-  if(n == 1)
-    return pierwszy;
-
-  srodek = (int) floor(n/2);
-  wezelwsk = pierwszy;
-  for(i = 1; i <= srodek-1; i++)
-    wezelwsk = wezelwsk->nastepny;
-  temp = wezelwsk->nastepny;
-  wezelwsk->nastepny = NULL;
+  wezel **zrodlo, **cel;
+  int *granice; /* serie to zrodlo[granice[i]..granice[i+1]) */
+  int liczba_serii;
+  int poczatek, koniec;
+  int tryb;
+} zadanie_sortowania;
+
+void* sortowanie_fragmentu_watkiem(void *argument)
+{
+  zadanie_sortowania *z = (zadanie_sortowania*) argument;
 
-  pierwszy1 = sortowanie_przez_scalanie(pierwszy, srodek, tryb);
-  pierwszy2 = sortowanie_przez_scalanie(temp, n-srodek, tryb);
-  return scalanie_list(pierwszy1, pierwszy2, tryb);
+  sortowanie_fragmentu(z->zrodlo + z->poczatek, z->cel + z->poczatek,
+                       z->koniec - z->poczatek, z->tryb);
+  return NULL;
 }
 
-/******************** wczytywanie danych z klawiatury ***********************/
-
-/* wczytywanie dowolnych danych w programie
-napis jest komunikatem wystwietalnym za kazdym razem gdy uzytkownik
-poda zla wartosc, kryterium sprawdza czy podana wartosc jest prawidlowa
-jesli typ_danych == 'i' to wczytujemy liczby
-jesli typ_danych == 's' to wczytujemy napisy */
-void wczytywanie(char *napis, bool (*kryterium)(char*), char typ_danych,
-                 void *wynik)
+/* scalanie kolejnych par serii; z kazdej pary watek tworzy tylko te miejsca */
+/* wyniku, ktore leza w jego fragmencie (nieparzysta ostatnia seria jest kopiowana) */
+void* scalanie_serii_watkiem(void *argument)
 {
-  int err;
-  char dane[32]; // wczytywane liczby i napisy trzymamy na poczatku
-  bool poprawna_wartosc = false; // w stringu dane
-  while(!poprawna_wartosc)
+  zadanie_sortowania *z = (zadanie_sortowania*) argument;
+  int i, a, b, c, od, po, k;
+
+  for(i = 0; i < z->liczba_serii; i += 2)
   {
-    printf("%s", napis);
-    err = scanf("%s", dane);
-    if(err == -1) printf("blad - znak konca pliku\n");
-    else if(err == 0) // scanf nie wczytal poprawnie wartosci
-    {// to sie raczej nie powinno wydarzyc bo napisy zawsze sie dobrze wczytuja
-      printf("podano niewlasciwe dane\n");
-      while('\n' != getchar()); // oczyszczamy bufor ze zbednych znakow (liczb)
+    a = z->granice[i];
+    b = z->granice[i+1];
+    c = (i+2 <= z->liczba_serii)? z->granice[i+2] : b;
+    od = (a > z->poczatek)? a : z->poczatek;
+    po = (c < z->koniec)? c : z->koniec;
+    if(od >= po)
       continue;
+    if(b == c)
+      memcpy(z->cel+od, z->zrodlo+od, (po-od)*sizeof(wezel*));
+    else
+    {
+      k = podzial_scalania(z->zrodlo+a, b-a, z->zrodlo+b, c-b, od-a, z->tryb);
+      scalanie_fragmentow(z->zrodlo+a+k, b-a-k, z->zrodlo+b+(od-a-k), c-b-(od-a-k),
+                          z->cel+od, po-od, z->tryb);
     }
-
-    poprawna_wartosc = kryterium(dane);
-    if(poprawna_wartosc == false)
-      printf("podano niepoprawne dane\n");
-    else break; // np. kod pocztowy 01_99 zamiast 01-111
   }
-  if(typ_danych == 'i') *((int*) wynik) = atoi(dane);// konwersja stringu na liczbe
-  else strcpy((char*) wynik, dane); /* typ_danych == 's' brak konwersji */
+  return NULL;
 }
 
-/* sprawdzamy czy napis zawiera tylko litery */
-bool kryterium_napisowe(char* napis)
+/* stabilne sortowanie tablicy n osob przez scalanie z uzyciem liczba_watkow */
+/* watkow: kazdy watek sortuje rowna czesc tablicy, a potem serie sa scalane */
+/* parami - w kazdej rundzie wszystkie watki tworza rowne czesci wyniku; */
+/* tryb jak w porownywanie (1 - id, 2 - imiona, 3 - nazwiska, ...) */
+void sortowanie_tablicy_przez_scalanie(wezel **osoby, int n, int tryb, int liczba_watkow)
 {
-  int i = 0;
-  while(*(napis+i) != '\0')
+  zadanie_sortowania *zadania;
+  wezel **bufor, **zrodlo, **cel, **temp;
+  int *granice;
+  int i, liczba_serii;
+
+  if(liczba_watkow > n / PROG_SORTOWANIA_WATKAMI)
+    liczba_watkow = n / PROG_SORTOWANIA_WATKAMI;
+  if(liczba_watkow < 1)
+    liczba_watkow = 1;
+  bufor = (wezel**) malloc((n > 0 ? n : 1)*sizeof(wezel*));
+  if(liczba_watkow == 1)
   {
-    if(!isalpha(napis[i])) // funkcja z ctype.h
-         return false;
-    i++;
+    sortowanie_fragmentu(osoby, bufor, n, tryb);
+    free(bufor);
+    return;
   }
-  return true;
+
+  granice = (int*) malloc((liczba_watkow+1)*sizeof(int));
+  zadania = (zadanie_sortowania*) malloc(liczba_watkow*sizeof(zadanie_sortowania));
+  for(i = 0; i <= liczba_watkow; i++)
+    granice[i] = (int)((long long)n * i / liczba_watkow);
+  for(i = 0; i < liczba_watkow; i++)
+  {
+    zadania[i].zrodlo = osoby;
+    zadania[i].cel = bufor;
+    zadania[i].granice = granice;
+    zadania[i].poczatek = granice[i];
+    zadania[i].koniec = granice[i+1];
+    zadania[i].tryb = tryb;
+  }
+  uruchamianie_watkow(zadania, sizeof(zadanie_sortowania), liczba_watkow,
+                      sortowanie_fragmentu_watkiem);
+
+  zrodlo = osoby;
+  cel = bufor;
+  for(liczba_serii = liczba_watkow; liczba_serii > 1; liczba_serii = (liczba_serii+1)/2)
+  {
+    for(i = 0; i < liczba_watkow; i++)
+    {
+      zadania[i].zrodlo = zrodlo;
+      zadania[i].cel = cel;
+      zadania[i].liczba_serii = liczba_serii;
+    }
+    uruchamianie_watkow(zadania, sizeof(zadanie_sortowania), liczba_watkow,
+                        scalanie_serii_watkiem);
+    for(i = 1; i <= (liczba_serii+1)/2; i++)
+      granice[i] = granice[(2*i < liczba_serii)? 2*i : liczba_serii];
+    temp = zrodlo;
+    zrodlo = cel;
+    cel = temp;
+  }
+  if(zrodlo != osoby)
+    memcpy(osoby, zrodlo, n*sizeof(wezel*));
+  free(zadania);
+  free(granice);
+  free(bufor);
 }
 
-/* sprawdzamy czy napis jest liczba */
-bool kryterium_liczbowe(char* napis)
+/* para klucz liczbowy - osoba; przy sortowaniu pozycyjnym przestawiamy pary, */
+/* wiec klucze sa czytane z kolejnych miejsc w pamieci, a nie z wezlow */
+typedef struct
 {
-  int i = 0;
-  while(*(napis+i) != '\0')
+  uint32_t klucz;
+  wezel *osoba;
+} para_sortowania;
+
+/* stabilne sortowanie pozycyjne (LSD) tablicy n osob wedlug klucza liczbowego */
+/* trybu 1, 4 lub 5: klucze liczymy raz do tablicy par, w jednym przejsciu */
+/* zliczamy wszystkie cztery bajty kluczy, a potem rozkladamy pary wedlug */
+/* kolejnych bajtow od najmlodszego; bajt jednakowy u wszystkich osob (np. */
+/* najstarszy bajt id) pomijamy - czas sortowania jest liniowy */
+void sortowanie_pozycyjne(wezel **osoby, int n, int tryb)
+{
+  para_sortowania *pary, *bufor, *temp;
+  int histogramy[4][256], pozycje[256];
+  int i, bajt, cyfra, suma;
+
+  if(n <= 1)
+    return;
+  pary = (para_sortowania*) malloc(n*sizeof(para_sortowania));
+  bufor = (para_sortowania*) malloc(n*sizeof(para_sortowania));
+  memset(histogramy, 0, sizeof(histogramy));
+  for(i = 0; i < n; i++)
   {
-    if(!isdigit(napis[i])) // funkcja z ctype.h
-         return false;
-    i++;
+    pary[i].klucz = klucz_liczbowy(osoby[i], tryb);
+    pary[i].osoba = osoby[i];
+    for(bajt = 0; bajt < 4; bajt++)
+      histogramy[bajt][(pary[i].klucz >> (8*bajt)) & 255]++;
   }
-  return true;
+  for(bajt = 0; bajt < 4; bajt++)
+  {
+    if(histogramy[bajt][(pary[0].klucz >> (8*bajt)) & 255] == n)
+      continue;
+    for(cyfra = 0, suma = 0; cyfra < 256; cyfra++)
+    {
+      pozycje[cyfra] = suma;
+      suma += histogramy[bajt][cyfra];
+    }
+    for(i = 0; i < n; i++)
+      bufor[pozycje[(pary[i].klucz >> (8*bajt)) & 255]++] = pary[i];
+    temp = pary;
+    pary = bufor;
+    bufor = temp;
+  }
+  for(i = 0; i < n; i++)
+    osoby[i] = pary[i].osoba;
+  free(bufor);
+  free(pary);
 }
 
-/* kryterium uzywane do sprawdzania czy stopien znajomosci */
-/* miedzy osobami miesci sie w przedziale <1, 10> */
-bool kryterium_wagowe(char* dane)
+/* para klucz - numer pozycji w tablicy danych (patrz import hurtowy); sortujemy */
+/* numery, wiec dane moga byc duze, a przestawiane sa tylko 16-bajtowe pary */
+typedef struct
 {
-  int liczba;
+  uint64_t klucz;
+  int numer;
+} klucz_pozycji;
+
+/* stabilne sortowanie pozycyjne (LSD) n par wedlug 64-bitowego klucza - tak */
+/* jak sortowanie_pozycyjne, ale bajtow klucza jest osiem; bajty jednakowe */
+/* we wszystkich parach pomijamy, wiec np. 32-bitowe klucze kosztuja cztery */
+/* przejscia; pary o rownych kluczach zostaja w poczatkowej kolejnosci */
+void sortowanie_pozycyjne_par(klucz_pozycji *pary, int n)
+{
+  klucz_pozycji *zrodlo = pary, *bufor, *temp;
+  int histogramy[8][256], pozycje[256];
+  int i, bajt, cyfra, suma;
+
+  if(n <= 1)
+    return;
+  bufor = (klucz_pozycji*) malloc(n*sizeof(klucz_pozycji));
+  memset(histogramy, 0, sizeof(histogramy));
+  for(i = 0; i < n; i++)
+    for(bajt = 0; bajt < 8; bajt++)
+      histogramy[bajt][(pary[i].klucz >> (8*bajt)) & 255]++;
+  for(bajt = 0; bajt < 8; bajt++)
+  {
+    if(histogramy[bajt][(zrodlo[0].klucz >> (8*bajt)) & 255] == n)
+      continue;
+    for(cyfra = 0, suma = 0; cyfra < 256; cyfra++)
+    {
+      pozycje[cyfra] = suma;
+      suma += histogramy[bajt][cyfra];
+    }
+    for(i = 0; i < n; i++)
+      bufor[pozycje[(zrodlo[i].klucz >> (8*bajt)) & 255]++] = zrodlo[i];
+    temp = zrodlo;
+    zrodlo = bufor;
+    bufor = temp;
+  }
+  if(zrodlo != pary)
+  {
+    memcpy(pary, zrodlo, n*sizeof(klucz_pozycji));
+    bufor = zrodlo;
+  }
+  free(bufor);
+}
 
-  if(kryterium_liczbowe(dane))
-    liczba = atoi(dane);
+/* stabilne sortowanie tablicy n osob: klucze liczbowe (tryby 1, 4 i 5) sortujemy */
+/* pozycyjnie, a imiona i nazwiska przez scalanie wszystkimi watkami */
+void sortowanie_tablicy_osob(wezel **osoby, int n, int tryb, int liczba_watkow)
+{
+  if(tryb == 1 || tryb >= 4)
+    sortowanie_pozycyjne(osoby, n, tryb);
   else
-    return false;
+    sortowanie_tablicy_przez_scalanie(osoby, n, tryb, liczba_watkow);
+}
 
-  if(liczba < 1 || 10 < liczba)
-    return false;
+/* pierwszy to wskaznik na pierwszy wezel listy ktora chcemy posortowac */
+/* funkcja zwraca wskaznik na pierwszy wezel posortowanej listy */
+/* tryb == 1 - sortowanie po identyfikatorach, tryb == 2 - sortowanie po imionach */
+/* tryb == 3 - sortowanie po nazwiskach, tryb == 4 - po numerach telefonu, */
+/* tryb == 5 - po kodach pocztowych; wskazniki na osoby zbieramy do tablicy, */
+/* sortujemy ja stabilnie (sortowanie_tablicy_osob) i raz przepinamy pola nastepny */
+wezel* sortowanie_listy_osob(wezel *pierwszy, int n, int tryb)
+{
+  wezel **osoby, *wezelwsk;
+  int i;
 
-  return true;
+  if(n <= 1)
+    return pierwszy;
+
+  osoby = (wezel**) malloc(n*sizeof(wezel*));
+  for(i = 0, wezelwsk = pierwszy; i < n; i++, wezelwsk = wezelwsk->nastepny)
+    osoby[i] = wezelwsk;
+  sortowanie_tablicy_osob(osoby, n, tryb, (int)sysconf(_SC_NPROCESSORS_ONLN));
+  for(i = 0; i < n-1; i++)
+    osoby[i]->nastepny = osoby[i+1];
+  osoby[n-1]->nastepny = NULL;
+  pierwszy = osoby[0];
+  free(osoby);
+  return pierwszy;
 }
 
-/* kryterium do funkcji main */
-bool kryterium1(char* dane)
+/********************* uporzadkowane widoki osob ***************************/
+
+/* porownywanie osob w widoku odpowiadajacym trybowi sortowania - rowne imiona */
+/* (nazwiska) rozstrzyga id, wiec kazde dwie rozne osoby maja ustalona kolejnosc */
+int porownywanie_w_widoku(wezel *wsk1, wezel *wsk2, int tryb)
 {
-  int liczba;
+  int wynik = porownywanie(wsk1, wsk2, tryb);
 
-  if(kryterium_liczbowe(dane))
-    liczba = atoi(dane);
-  else
-    return false;
+  if(wynik == 0 && tryb != 1)
+    wynik = porownywanie(wsk1, wsk2, 1);
+  return wynik;
+}
 
-  return liczba == 1 || liczba == 2 || liczba == 3 || liczba == 4 || liczba == 5 ||
-  liczba == 6 || liczba == 7 || liczba == 8 || liczba == 9 || liczba == 10 || liczba == 11;
+/* wysokosc wiezy nowej osoby - kazdy kolejny poziom z prawdopodobienstwem 1/4 */
+/* (dwa kolejne bity liczby losowej rowne zero; generator xorshift) */
+int losowanie_wysokosci(widoki_osob *w)
+{
+  unsigned int x = w->stan_losowania;
+  int wysokosc = 1;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  w->stan_losowania = x;
+  while(wysokosc < MAKS_POZIOM_WIDOKU && (x & 3) == 0)
+  {
+    wysokosc++;
+    x >>= 2;
+  }
+  return wysokosc;
 }
 
-/* kryterium do funkcji sortowanie */
-bool kryterium2(char* dane)
+/* adres wskaznika na nastepna osobe po osobie poprzedni na danym poziomie */
+/* widoku; poprzedni == NULL oznacza poczatek widoku */
+wezel** nastepny_na_poziomie(widoki_osob *w, int widok, wezel *poprzedni, int poziom)
 {
-  int liczba;
+  return (poprzedni == NULL)? &w->poczatki[widok][poziom] : &poprzedni->wieze[widok][poziom];
+}
 
-  if(kryterium_liczbowe(dane))
-    liczba = atoi(dane);
-  else
-    return false;
+/* ostatnie osoby mniejsze od osoby wzor na kolejnych poziomach widoku */
+/* (NULL - zadna osoba na tym poziomie nie jest mniejsza) */
+void szukanie_poprzednikow(widoki_osob *w, int widok, wezel *wzor, wezel **poprzedniki)
+{
+  wezel *poprzedni = NULL, *nastepny;
+  int poziom;
 
-  return liczba == 1 || liczba == 2 || liczba == 3;
+  for(poziom = w->liczba_poziomow[widok]-1; poziom >= 0; poziom--)
+  {
+    while((nastepny = *nastepny_na_poziomie(w, widok, poprzedni, poziom)) != NULL &&
+          porownywanie_w_widoku(nastepny, wzor, widok+1) < 0)
+      poprzedni = nastepny;
+    poprzedniki[poziom] = poprzedni;
+  }
 }
 
-/* kryterium uzywane do wyborow typu tak lub nie */
-bool kryterium3(char* dane)
+/* budowanie wszystkich widokow od nowa: osoby sortujemy w tablicy, a wieze */
+/* dolaczamy w kolejnosci do konca kazdego poziomu; imiona i nazwiska sortujemy */
+/* stabilnie zaczynajac od kolejnosci id, wiec rowne imiona (nazwiska) zostaja */
+/* uporzadkowane wedlug id - tak jak w porownywanie_w_widoku */
+void budowanie_widokow(graf *g)
 {
-  int liczba;
-
-  if(kryterium_liczbowe(dane))
-    liczba = atoi(dane);
-  else
-    return false;
-
-  return liczba == 1 || liczba == 2;
-}
-
-// kryterium do sprawdzania czy kod pocztowy zostal poprawnie wpisany
-// np. "01-234"
-bool kryterium_kod_pocztowy(char* kod)
-{
-  int i = 0;
-  // petla wykonuje sie az napotkamy znak null lub przekroczymy dlugosc
-  while((*(kod+i) != '\0') && (i < 6)) // kodu pocztowego
+  widoki_osob *w = &g->widoki;
+  wezel **wedlug_id, **osoby, *ostatnie[MAKS_POZIOM_WIDOKU], *wezelwsk;
+  int i, n = 0, widok, poziom, wysokosc;
+  int liczba_watkow = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+    n++;
+  wedlug_id = (wezel**) malloc((n > 0 ? n : 1)*sizeof(wezel*));
+  osoby = (wezel**) malloc((n > 0 ? n : 1)*sizeof(wezel*));
+  for(i = 0, wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+    wedlug_id[i++] = wezelwsk;
+  sortowanie_tablicy_osob(wedlug_id, n, 1, liczba_watkow);
+  for(i = 0; i < MAKS_POZIOM_WIDOKU; i++)
+    resetowanie_puli(&w->pule_wiez[i]);
+  for(widok = 0; widok < LICZBA_WIDOKOW; widok++)
   {
-    if(i == 2)
+    memcpy(osoby, wedlug_id, n*sizeof(wezel*));
+    if(widok > 0)
+      sortowanie_tablicy_osob(osoby, n, widok+1, liczba_watkow);
+    for(poziom = 0; poziom < MAKS_POZIOM_WIDOKU; poziom++)
     {
-      if(kod[i] != '-') return false;
+      w->poczatki[widok][poziom] = NULL;
+      ostatnie[poziom] = NULL;
     }
-    else
+    w->liczba_poziomow[widok] = 1;
+    for(i = 0; i < n; i++)
     {
-      if(!(kod[i] >= '0' && kod[i] <= '9')) return false;
+      wysokosc = losowanie_wysokosci(w);
+      osoby[i]->wieze[widok] = (wezel**) przydzielanie_z_puli(&w->pule_wiez[wysokosc-1]);
+      osoby[i]->wysokosci_wiez[widok] = (unsigned char) wysokosc;
+      for(poziom = 0; poziom < wysokosc; poziom++)
+      {
+        osoby[i]->wieze[widok][poziom] = NULL;
+        *nastepny_na_poziomie(w, widok, ostatnie[poziom], poziom) = osoby[i];
+        ostatnie[poziom] = osoby[i];
+      }
+      if(wysokosc > w->liczba_poziomow[widok])
+        w->liczba_poziomow[widok] = wysokosc;
     }
-    i++;
-    if(i == 6 && kod[6] == '\0') return true; // caly kod jest poprawny
   }
-  return false;
+  free(osoby);
+  free(wedlug_id);
+  w->nieaktualne = false;
 }
 
-/**************** operacje wejscia, wyjscia z uzyciem plikow ******************/
-
-/* najpierw sa wczytywane glowne informacje o grafie, potem informacje */
-/* o wszystkich wezlach, a na koncu informacje o krawedziach miedzy wezlami */
-void wczytywanie_bazy(baza *b)
+/* widoki sa budowane od nowa, jesli od ostatniego uzycia wczytano wiele osob naraz */
+void aktualizacja_widokow(graf *g)
 {
-  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  FILE *plik;
-  int id, waga, wybor;
-  wezel *wezelwsk, *poprzednik_wezla;
-  krawedz *krawedzwsk, *poprzednik_krawedzi;
-  bool pierwszy_wezel_dodany = false, pierwsza_krawedz_dodana = false;
-  char *tekst =
-  "Nacisnij klawisz 1 lub 2\n"
-  "1 - wczytywanie przykladowej bazy z pliku\n"
-  "2 - wczytywanie bazy zapisanej wczesniej przez uzytkownika (z pliku)\n";
-  char pierwsze_imie[32], nazwisko[32], napis[256];
+  if(g->widoki.nieaktualne)
+    budowanie_widokow(g);
+}
 
-  wczytywanie(tekst, kryterium3, 'i', &wybor);
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+/* dodanie nowej osoby (po wpisaniu jej danych) do wszystkich widokow */
+void dodawanie_do_widokow(graf *g, wezel *nowy)
+{
+  widoki_osob *w = &g->widoki;
+  wezel *poprzedniki[MAKS_POZIOM_WIDOKU], **nastepny;
+  int widok, poziom, wysokosc;
 
-  switch(wybor)
+  if(w->nieaktualne)
+    return ; /* osoba trafi do widokow przy ich budowaniu */
+  for(widok = 0; widok < LICZBA_WIDOKOW; widok++)
   {
-    case 1:
-    if((plik = fopen("przykladowa_baza.txt", "r")) == NULL)
-    {
-      printf("blad, nie znaleziono pliku zawierajacego ksiazke adresowa\n");
-      return ;
-    }
-    break;
-    case 2:
-    if((plik = fopen("ksiazka_adresowa.txt", "r")) == NULL)
+    szukanie_poprzednikow(w, widok, nowy, poprzedniki);
+    wysokosc = losowanie_wysokosci(w);
+    for(poziom = w->liczba_poziomow[widok]; poziom < wysokosc; poziom++)
+      poprzedniki[poziom] = NULL;
+    if(wysokosc > w->liczba_poziomow[widok])
+      w->liczba_poziomow[widok] = wysokosc;
+    nowy->wieze[widok] = (wezel**) przydzielanie_z_puli(&w->pule_wiez[wysokosc-1]);
+    nowy->wysokosci_wiez[widok] = (unsigned char) wysokosc;
+    for(poziom = 0; poziom < wysokosc; poziom++)
     {
-      printf("blad, nie znaleziono pliku zawierajacego ksiazke adresowa\n");
-      return ;
+      nastepny = nastepny_na_poziomie(w, widok, poprzedniki[poziom], poziom);
+      nowy->wieze[widok][poziom] = *nastepny;
+      *nastepny = nowy;
     }
-    break;
   }
-  /* oczyszczanie bazy z poprzednich danych */
-  usuwanie_wszystkich_wezlow(b->zrodlo);
-  inicjalizacja_bazy(b);
-  printf("Wczytywanie bazy...\n");
+}
 
-  /* wczytywanie glownych informacji o bazie (grafie) z pliku */
-  fscanf(plik, "Ksiazka adresowo-spolecznosciowa\n");
-  fscanf(plik, "Liczba elementow: %d, biezacy id: %d\n",
-          &b->liczba_elementow, &b->biezacy_id);
+/* usuniecie osoby ze wszystkich widokow (przed zwolnieniem jej wezla) */
+void usuwanie_z_widokow(graf *g, wezel *usuwany)
+{
+  widoki_osob *w = &g->widoki;
+  wezel *poprzedniki[MAKS_POZIOM_WIDOKU];
+  int widok, poziom;
 
-  /* wczytywanie informacji o kazdym wezle z pliku */
-  /* warunek w petli while sprawdza czy w pliku sa jeszcze jakies osoby (wezly) */
-  fgets(napis, 256, plik);
-  while((sscanf(napis, "Osoba, id %d\n", &id)) > 0)
+  if(w->nieaktualne)
+    return ;
+  for(widok = 0; widok < LICZBA_WIDOKOW; widok++)
   {
-    wezelwsk = (wezel*) malloc(sizeof(wezel));
-    wezelwsk->id = id;
-    fscanf(plik, "Dane osobowe:\n");
-    fscanf(plik, "%s %s %s nr telefonu: %d\n", wezelwsk->pierwsze_imie,
-      wezelwsk->drugie_imie, wezelwsk->nazwisko, &wezelwsk->nr_telefonu);
+    szukanie_poprzednikow(w, widok, usuwany, poprzedniki);
+    for(poziom = 0; poziom < usuwany->wysokosci_wiez[widok]; poziom++)
+      *nastepny_na_poziomie(w, widok, poprzedniki[poziom], poziom) = usuwany->wieze[widok][poziom];
+    zwracanie_do_puli(&w->pule_wiez[usuwany->wysokosci_wiez[widok]-1], usuwany->wieze[widok]);
+    while(w->liczba_poziomow[widok] > 1 &&
+          w->poczatki[widok][w->liczba_poziomow[widok]-1] == NULL)
+      w->liczba_poziomow[widok]--;
+  }
+}
 
-    fscanf(plik, "Adres:\n");
-    fscanf(plik, "Ulica %s %d/%d, kod pocztowy: %7s miasto: %s\n",
-      wezelwsk->adres.ulica, &wezelwsk->adres.nr_domu, &wezelwsk->adres.nr_mieszkania,
-      wezelwsk->adres.kod_pocztowy, wezelwsk->adres.miasto);
+/* pierwsza osoba w kolejnosci trybu sortowania (1 - id, 2 - pierwsze imie, */
+/* 3 - nazwisko) lub NULL, gdy graf jest pusty */
+wezel* pierwszy_w_widoku(graf *g, int tryb)
+{
+  aktualizacja_widokow(g);
+  return g->widoki.poczatki[tryb-1][0];
+}
 
-    /* odtwarzamy liste wezlow grafu */
-    if(!pierwszy_wezel_dodany)
-    {
-      b->zrodlo = wezelwsk;
-      poprzednik_wezla = b->zrodlo;
-      b->zrodlo->nastepny = NULL;
-      pierwszy_wezel_dodany = true;
-    }
-    else
-    {
-      poprzednik_wezla->nastepny = wezelwsk;
-      wezelwsk->nastepny = NULL;
-      poprzednik_wezla = wezelwsk;
-    }
-    fgets(napis, 256, plik);
-  }
-  fgets(napis, 256, plik); /* wczytujemy znak nowej linii */
-  fgets(napis, 256, plik);
-  /* wczytujemy informacje o znajomosciach miedzy osobami z pliku */
-  wezelwsk = b->zrodlo;
-  while(wezelwsk != NULL)
-  {
-    wezelwsk->pierwszy = NULL;
-    fgets(napis, 256, plik);
-    while((sscanf(napis, "Id %d %s %s stopien znajomosci: %d\n",
-      &id, pierwsze_imie, nazwisko, &waga)) > 0)
-    {
-      krawedzwsk = (krawedz*) malloc(sizeof(krawedz));
-      krawedzwsk->cel = znajdz_wezel(b, id);
-      krawedzwsk->waga = waga;
-      if(!pierwsza_krawedz_dodana) /* odtwarzamy liste krawedzi danego wezla */
-      {
-        wezelwsk->pierwszy = krawedzwsk;
-        poprzednik_krawedzi = wezelwsk->pierwszy;
-        wezelwsk->pierwszy->nastepny = NULL;
-        pierwsza_krawedz_dodana = true;
-      }
-      else
-      {
-        poprzednik_krawedzi->nastepny = krawedzwsk;
-        krawedzwsk->nastepny = NULL;
-        poprzednik_krawedzi = krawedzwsk;
-      }
-      if(fgets(napis, 256, plik) == NULL) break; /* przerywany gdy dojdziemy do konca pliku */
-    }
-    wezelwsk = wezelwsk->nastepny;
-    pierwsza_krawedz_dodana = false;
-    if(fgets(napis, 256, plik) == NULL) break; /* przerywany gdy dojdziemy do konca pliku */
-  }
+/* osoba nastepna po wezelwsk w kolejnosci trybu sortowania lub NULL */
+wezel* nastepny_w_widoku(wezel *wezelwsk, int tryb)
+{
+  return wezelwsk->wieze[tryb-1][0];
+}
 
-  fclose(plik);
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+/* pierwsza osoba nie mniejsza od osoby wzor w kolejnosci trybu sortowania */
+/* (wzor nie musi nalezec do grafu - wystarczy, ze ma wypelnione porownywane */
+/* pola, klucze sortowania i id); pozwala wypisywac strony widoku od dowolnego miejsca */
+wezel* szukanie_w_widoku(graf *g, wezel *wzor, int tryb)
+{
+  wezel *poprzedniki[MAKS_POZIOM_WIDOKU];
+
+  aktualizacja_widokow(g);
+  szukanie_poprzednikow(&g->widoki, tryb-1, wzor, poprzedniki);
+  return *nastepny_na_poziomie(&g->widoki, tryb-1, poprzedniki[0], 0);
 }
 
-/* najpierw sa zapisywane glowne informacje o grafie, potem informacje */
-/* o wszystkich wezlach, a na koncu informacje o krawedziach miedzy wezlami */
-void zapisywanie_bazy(baza *b)
+/* ulozenie listy wszystkich wezlow grafu w kolejnosci trybu sortowania - */
+/* kolejnosc jest juz w widoku, wiec wystarczy przepiac wskazniki w czasie O(n) */
+void ukladanie_wedlug_widoku(graf *g, int tryb)
 {
-  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  FILE *plik;
-  wezel *wezelwsk;
-  krawedz *krawedzwsk;
+  wezel *wezelwsk, *poprzedni = NULL;
 
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Zapisywanie bazy do pliku ksiazka_adresowa.txt\n");
-  plik = fopen("ksiazka_adresowa.txt", "w");
+  g->zrodlo = pierwszy_w_widoku(g, tryb);
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = nastepny_w_widoku(wezelwsk, tryb))
+  {
+    wezelwsk->poprzedni = poprzedni;
+    if(poprzedni != NULL)
+      poprzedni->nastepny = wezelwsk;
+    poprzedni = wezelwsk;
+  }
+  if(poprzedni != NULL)
+    poprzedni->nastepny = NULL;
+  g->ostatni_wezel = poprzedni;
+}
 
-  /* zapisywanie glownych informacji o bazie (grafie) do pliku */
-  fprintf(plik, "Ksiazka adresowo-spolecznosciowa\n");
-  fprintf(plik, "Liczba elementow: %d, biezacy id: %d\n",
-          b->liczba_elementow, b->biezacy_id);
-  /* zapisywanie informacji o kazdym wezle do pliku */
-  wezelwsk = b->zrodlo;
-  while(wezelwsk != NULL)
+/* ulozenie listy wszystkich wezlow grafu wedlug klucza liczbowego (tryb 4 - numer */
+/* telefonu, tryb 5 - kod pocztowy), dla ktorego nie ma widoku: osoby bierzemy */
+/* z widoku wedlug id i sortujemy stabilnie pozycyjnie, wiec osoby o rownych */
+/* kluczach zostaja w kolejnosci id */
+void ukladanie_wedlug_klucza(graf *g, int tryb)
+{
+  wezel **osoby, *wezelwsk, *poprzedni = NULL;
+  int i, n = 0;
+
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+    n++;
+  if(n == 0)
+    return;
+  osoby = (wezel**) malloc(n*sizeof(wezel*));
+  for(i = 0, wezelwsk = pierwszy_w_widoku(g, 1); wezelwsk != NULL;
+      wezelwsk = nastepny_w_widoku(wezelwsk, 1))
+    osoby[i++] = wezelwsk;
+  sortowanie_pozycyjne(osoby, n, tryb);
+  g->zrodlo = osoby[0];
+  for(i = 0; i < n; i++)
   {
-    fprintf(plik, "\nOsoba, id %d\n", wezelwsk->id);
-    fprintf(plik, "Dane osobowe:\n");
-    fprintf(plik, "%s %s %s nr telefonu: %d\n", wezelwsk->pierwsze_imie,
-      wezelwsk->drugie_imie, wezelwsk->nazwisko, wezelwsk->nr_telefonu);
+    osoby[i]->poprzedni = poprzedni;
+    osoby[i]->nastepny = (i+1 < n)? osoby[i+1] : NULL;
+    poprzedni = osoby[i];
+  }
+  g->ostatni_wezel = poprzedni;
+  free(osoby);
+}
 
-    fprintf(plik, "Adres:\n");
-    fprintf(plik, "Ulica %s %d/%d, kod pocztowy: %s miasto: %s\n",
-      wezelwsk->adres.ulica, wezelwsk->adres.nr_domu, wezelwsk->adres.nr_mieszkania,
-      wezelwsk->adres.kod_pocztowy, wezelwsk->adres.miasto);
+/*********************** operacje na grafie *******************************/
 
-    wezelwsk = wezelwsk->nastepny;
+/* przydzielenie wezlowi numeru slotu - najpierw wykorzystujemy sloty zwolnione */
+/* przez usuniete wezly, dzieki czemu numery slotow pozostaja geste */
+void przydzielanie_slotu(graf *g, wezel *nowy)
+{
+  if(g->liczba_wolnych_slotow > 0)
+  {
+    g->liczba_wolnych_slotow--;
+    nowy->slot = g->wolne_sloty[g->liczba_wolnych_slotow];
   }
-  /* zapisywanie informacji o wszystkich krawedziach do pliku */
-  fprintf(plik, "\nInformacje o znajomosciach miedzy osobami\n");
-  wezelwsk = b->zrodlo;
-  while(wezelwsk != NULL)
+  else
   {
-    fprintf(plik, "\nZnajomi osoby o identyfikatorze %d:\n", wezelwsk->id);
-    krawedzwsk = wezelwsk->pierwszy;
-    while(krawedzwsk != NULL)
+    if(g->liczba_slotow == g->pojemnosc_slotow)
     {
-      fprintf(plik, "Id %d %s %s stopien znajomosci: %d\n",
-        krawedzwsk->cel->id, krawedzwsk->cel->pierwsze_imie,
-        krawedzwsk->cel->nazwisko, krawedzwsk->waga);
-        krawedzwsk = krawedzwsk->nastepny;
+      g->pojemnosc_slotow = (g->pojemnosc_slotow == 0)? 16 : 2*g->pojemnosc_slotow;
+      g->sloty = (wezel**) realloc(g->sloty, g->pojemnosc_slotow*sizeof(wezel*));
+      g->wolne_sloty = (int*) realloc(g->wolne_sloty, g->pojemnosc_slotow*sizeof(int));
     }
-    wezelwsk = wezelwsk->nastepny;
+    nowy->slot = g->liczba_slotow;
+    g->liczba_slotow++;
   }
+  g->sloty[nowy->slot] = nowy;
+  dodawanie_wezla_do_migawki(g, nowy->slot);
+}
 
-  fclose(plik);
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+/* zwolnienie slotu usuwanego wezla, slot zostanie wykorzystany przez kolejny nowy wezel */
+void zwalnianie_slotu(graf *g, wezel *usuwany)
+{
+  g->sloty[usuwany->slot] = NULL;
+  g->wolne_sloty[g->liczba_wolnych_slotow] = usuwany->slot;
+  g->liczba_wolnych_slotow++;
+  zwalnianie_z_migawki(g, usuwany->slot);
 }
 
-/********************* operacje na ksiazce adresowej ***********************/
+/* miejsce w tablicy mieszajacej o podanej pojemnosci (potedze dwojki), od ktorego */
+/* zaczynamy szukanie elementu o danym id */
+/* (mnozenie przez stala Knutha i wymieszanie wyzszych bitow z nizszymi) */
+int mieszanie_id(int id, int pojemnosc)
+{
+  unsigned int h = (unsigned int)id * 2654435761u;
+  return (int)((h ^ (h >> 16)) & (unsigned int)(pojemnosc-1));
+}
 
-/* wszystkie wczytane dane trzymamy na poczatku w zmiennych lokalnych funkcji
-   potem przepisujemy je do ksiazki adresowej */
-void dodawanie_osoby(baza *b)
+/* indeks miejsca zajmowanego przez wezel o danym id, a jesli takiego wezla */
+/* nie ma w indeksie - indeks wolnego miejsca, w ktorym zakonczylo sie szukanie */
+int miejsce_w_indeksie(indeks_id *indeks, int id)
 {
-  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  int wybor;
-  char pierwsze_imie[32], drugie_imie[32],
-  nazwisko[32], ulica[32], miasto[32];
-  char kod_pocztowy[7];
-  int nr_telefonu, nr_domu, nr_mieszkania;
-  char* napis1 = "Podaj pierwsze imie\n";
-  char* napis2 = "Nacisnij klawisz\n1 - tak\n2 - nie\n";
-  char* napis3 = "Podaj drugie imie\n";
-  char* napis4 = "Podaj nazwisko\n";
-  char* napis5 = "Podaj numer telefonu\n";
-  char* napis6 = "Podaj nazwe ulicy\n";
-  char* napis7 = "Podaj numer domu\n";
-  char* napis8 = "Podaj numer mieszkania\n";
-  char* napis9 = "Podaj kod pocztowy w formacie \"01-234\"\n";
-  char* napis10 = "Podaj miasto\n";
-  wezel *wezelwsk;
-  wezel *nowy;
+  int i = mieszanie_id(id, indeks->pojemnosc);
 
-  printf("dodawanie nowej pozycji\n");
+  while(indeks->tablica[i] != NULL && indeks->tablica[i]->id != id)
+    i = (i+1) & (indeks->pojemnosc-1);
+  return i;
+}
 
-  wczytywanie(napis1, kryterium_napisowe, 's', pierwsze_imie);
+/* zmiana pojemnosci tablicy indeksu (potegi dwojki) - wszystkie wezly */
+/* wstawiamy od nowa, bo ich miejsca zaleza od pojemnosci */
+void zmiana_pojemnosci_indeksu(indeks_id *indeks, int nowa_pojemnosc)
+{
+  wezel **stara = indeks->tablica;
+  int i, stara_pojemnosc = indeks->pojemnosc;
+
+  indeks->pojemnosc = nowa_pojemnosc;
+  indeks->tablica = (wezel**) calloc(indeks->pojemnosc, sizeof(wezel*));
+  for(i = 0; i < stara_pojemnosc; i++)
+    if(stara[i] != NULL)
+      indeks->tablica[miejsce_w_indeksie(indeks, stara[i]->id)] = stara[i];
+  free(stara);
+}
 
-  printf("Czy dana osoba ma drugie imie?\n");
-  wczytywanie(napis2, kryterium3, 'i', &wybor);
-  if(wybor == 1)
-    wczytywanie(napis3, kryterium_napisowe, 's', drugie_imie);
-  else
-    strcpy(drugie_imie, "_");
+/* dodanie wezla do indeksu identyfikatorow - gdy tablica jest zapelniona */
+/* w polowie to zwiekszamy ja dwukrotnie i wstawiamy wszystkie wezly od nowa */
+void dodawanie_do_indeksu(graf *g, wezel *nowy)
+{
+  indeks_id *indeks = &g->indeks;
+  int i;
 
-  wczytywanie(napis4, kryterium_napisowe, 's', nazwisko);
-  wczytywanie(napis5, kryterium_liczbowe, 'i', &nr_telefonu);
-  // ---------- wczytywanie adresu  ---------- //
-  wczytywanie(napis6, kryterium_napisowe, 's', ulica);
-  wczytywanie(napis7, kryterium_liczbowe, 'i', &nr_domu);
-  wczytywanie(napis8, kryterium_liczbowe, 'i', &nr_mieszkania);
-  wczytywanie(napis9, kryterium_kod_pocztowy, 's', kod_pocztowy);
-  wczytywanie(napis10, kryterium_napisowe, 's', miasto);
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+  if(2*(indeks->liczba_wezlow+1) > indeks->pojemnosc)
+    zmiana_pojemnosci_indeksu(indeks, (indeks->pojemnosc == 0)? 64 : 2*indeks->pojemnosc);
+  i = miejsce_w_indeksie(indeks, nowy->id);
+  if(indeks->tablica[i] == NULL)
+    indeks->liczba_wezlow++;
+  indeks->tablica[i] = nowy;
+}
 
-  /* sprawdzanie czy osoba o danym imieniu i nazwisku
-  nie istnieje juz w bazie */
-  wezelwsk = b->zrodlo;
-  while(wezelwsk != NULL)
+/* usuniecie wezla z indeksu - kolejne wezle z tego samego ciagu zajetych */
+/* miejsc przesuwamy w zwolnione miejsce (jesli moga tam lezec), dzieki czemu */
+/* szukanie nadal konczy sie na pierwszym wolnym miejscu */
+void usuwanie_z_indeksu(graf *g, wezel *usuwany)
+{
+  indeks_id *indeks = &g->indeks;
+  int maska = indeks->pojemnosc-1;
+  int wolne, i, poczatek;
+
+  if(indeks->pojemnosc == 0)
+    return ;
+  wolne = miejsce_w_indeksie(indeks, usuwany->id);
+  if(indeks->tablica[wolne] == NULL)
+    return ; /* wezla nie ma w indeksie */
+  indeks->tablica[wolne] = NULL;
+  indeks->liczba_wezlow--;
+  for(i = (wolne+1) & maska; indeks->tablica[i] != NULL; i = (i+1) & maska)
   {
-    if(strcmp(wezelwsk->pierwsze_imie, pierwsze_imie) == 0 &&
-      strcmp(wezelwsk->nazwisko, nazwisko) == 0)
+    poczatek = mieszanie_id(indeks->tablica[i]->id, indeks->pojemnosc);
+    /* wezel mozna przesunac, jesli jego miejsce poczatkowe nie lezy */
+    /* (cyklicznie) w przedziale (wolne, i] */
+    if(((i - poczatek) & maska) >= ((i - wolne) & maska))
     {
-      printf("Osoba o danym imieniu i nazwisku istnieje juz w ksiazce adresowej\n");
-      printf("Aktualizacja adresu i numeru telefonu\n");
-
-      /* przepisywanie danych*/
-      wezelwsk->nr_telefonu = nr_telefonu;
-      strcpy(wezelwsk->adres.ulica, ulica);
-      wezelwsk->adres.nr_domu = nr_domu;
-      wezelwsk->adres.nr_mieszkania = nr_mieszkania;
-      strcpy(wezelwsk->adres.kod_pocztowy, kod_pocztowy);
-      strcpy(wezelwsk->adres.miasto, miasto);
-      return ;
+      indeks->tablica[wolne] = indeks->tablica[i];
+      indeks->tablica[i] = NULL;
+      wolne = i;
     }
-    wezelwsk = wezelwsk->nastepny;
   }
-  /* wczytana osoba nie istnieje w bazie  */
-  b->liczba_elementow++;
-  nowy = dodawanie_wezla(b, b->biezacy_id);
-  b->biezacy_id = (b->biezacy_id+1) % INT_MAX;
-  /* przepisywanie danych*/
-  strcpy(nowy->pierwsze_imie, pierwsze_imie);
-  strcpy(nowy->drugie_imie, drugie_imie);
-  strcpy(nowy->nazwisko, nazwisko);
-  nowy->nr_telefonu = nr_telefonu;
-  strcpy(nowy->adres.ulica, ulica);
-  nowy->adres.nr_domu = nr_domu;
-  nowy->adres.nr_mieszkania = nr_mieszkania;
-  strcpy(nowy->adres.kod_pocztowy, kod_pocztowy);
-  strcpy(nowy->adres.miasto, miasto);
-
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
 }
 
-void usuwanie_osoby(baza *b)
+/* wartosc funkcji mieszajacej pary pierwsze imie - nazwisko (FNV-1a, napisy */
+/* rozdzielone znakiem '\0', zeby np. "Ann" "aNowak" i "Anna" "Nowak" sie roznily) */
+unsigned int mieszanie_nazwiska(const char *pierwsze_imie, const char *nazwisko)
 {
-  int id = -1;
-  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  char* napis = "Podaj identyfikator osoby ktora chcesz usunac z bazy\n";
-  wezel *usuwany;
+  uint32_t h = 2166136261u;
+
+  do
+    h = (h ^ (unsigned char)*pierwsze_imie) * 16777619u;
+  while(*pierwsze_imie++ != '\0');
+  do
+    h = (h ^ (unsigned char)*nazwisko) * 16777619u;
+  while(*nazwisko++ != '\0');
+  return h ^ (h >> 16);
+}
 
-  wczytywanie(napis, kryterium_liczbowe, 'i', &id);
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+/* indeks miejsca zajmowanego przez imiennikow o danym imieniu i nazwisku, a jesli */
+/* takich osob nie ma - indeks wolnego miejsca, w ktorym zakonczylo sie szukanie */
+int miejsce_w_indeksie_nazwisk(indeks_nazwisk *indeks, unsigned int skrot,
+                               const char *pierwsze_imie, const char *nazwisko)
+{
+  int i = (int)(skrot & (unsigned int)(indeks->pojemnosc-1));
+
+  while(indeks->tablica[i] != NULL &&
+        (indeks->tablica[i]->skrot_nazwiska != skrot ||
+         strcmp(indeks->tablica[i]->pierwsze_imie, pierwsze_imie) != 0 ||
+         strcmp(indeks->tablica[i]->nazwisko, nazwisko) != 0))
+    i = (i+1) & (indeks->pojemnosc-1);
+  return i;
+}
 
-  /* sprawdzanie czy osoba o podanym id istnieje w bazie */
-  if((usuwany = znajdz_wezel(b, id)) == NULL)
-    printf("Osoba o danym identyfikatorze nie wsytepuje w bazie\n");
-  else
-  {/* osoba o podanym przez uzytkownika id istnieje w bazie */
-    usuwanie_wezla(b, id);
-    b->liczba_elementow--;
-    printf("Osoba usunieta\n");
-  }
+/* zmiana pojemnosci tablicy indeksu nazwisk - tak jak dla indeksu identyfikatorow; */
+/* rozne pary imie - nazwisko leza w tablicy tylko raz, wiec wystarczy porownac skroty */
+void zmiana_pojemnosci_indeksu_nazwisk(indeks_nazwisk *indeks, int nowa_pojemnosc)
+{
+  wezel **stara = indeks->tablica;
+  int i, j, stara_pojemnosc = indeks->pojemnosc;
 
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+  indeks->pojemnosc = nowa_pojemnosc;
+  indeks->tablica = (wezel**) calloc(indeks->pojemnosc, sizeof(wezel*));
+  for(i = 0; i < stara_pojemnosc; i++)
+    if(stara[i] != NULL)
+    {
+      j = (int)(stara[i]->skrot_nazwiska & (unsigned int)(indeks->pojemnosc-1));
+      while(indeks->tablica[j] != NULL)
+        j = (j+1) & (indeks->pojemnosc-1);
+      indeks->tablica[j] = stara[i];
+    }
+  free(stara);
 }
 
-void sortowanie(baza *b)
+/* dodanie osoby do indeksu nazwisk (po wpisaniu jej imienia i nazwiska) - osoba */
+/* o nowym imieniu i nazwisku zajmuje wolne miejsce tablicy, a imiennik kogos, */
+/* kto juz jest w indeksie, trafia na liste imiennikow zaraz za pierwsza osoba */
+void dodawanie_do_indeksu_nazwisk(graf *g, wezel *nowy)
 {
-  int wybor;
-  clock_t poczatek, koniec;/* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  char *napis =
-  "Nacisnij klawisz 1, 2 lub 3\n"
-  "1 - sortowanie po identyfikatorach\n"
-  "2 - sortowanie po pierwszych imionach\n"
-  "3 - sortowanie po nazwiskach\n";
+  indeks_nazwisk *indeks = &g->nazwiska;
+  wezel *pierwszy;
+  int i;
 
-  if(b->liczba_elementow == 0)
+  if(2*(indeks->liczba_nazwisk+1) > indeks->pojemnosc)
+    zmiana_pojemnosci_indeksu_nazwisk(indeks, (indeks->pojemnosc == 0)? 64 : 2*indeks->pojemnosc);
+  /* osoba trafia do indeksu zawsze zaraz po wpisaniu imienia i nazwiska, */
+  /* wiec tu liczymy tez jej klucze sortowania */
+  ustawianie_kluczy_sortowania(nowy);
+  nowy->skrot_nazwiska = mieszanie_nazwiska(nowy->pierwsze_imie, nowy->nazwisko);
+  i = miejsce_w_indeksie_nazwisk(indeks, nowy->skrot_nazwiska, nowy->pierwsze_imie, nowy->nazwisko);
+  nowy->poprzedni_imiennik = NULL;
+  nowy->nastepny_imiennik = NULL;
+  if((pierwszy = indeks->tablica[i]) == NULL)
   {
-    printf("Baza jest pusta, brak poztcji do sortowania\n");
+    indeks->tablica[i] = nowy;
+    indeks->liczba_nazwisk++;
     return ;
   }
-  wczytywanie(napis, kryterium2, 'i', &wybor);
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Sortowanie...\n");
-  switch(wybor)
-  {
-    case 1:
-      b->zrodlo = sortowanie_przez_scalanie(b->zrodlo, b->liczba_elementow, 1);
-    break;
-    case 2:
-      b->zrodlo = sortowanie_przez_scalanie(b->zrodlo, b->liczba_elementow, 2);
-    break;
-    case 3:
-      b->zrodlo = sortowanie_przez_scalanie(b->zrodlo, b->liczba_elementow, 3);
-    break;
-  }
-
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+  nowy->poprzedni_imiennik = pierwszy;
+  nowy->nastepny_imiennik = pierwszy->nastepny_imiennik;
+  if(pierwszy->nastepny_imiennik != NULL)
+    pierwszy->nastepny_imiennik->poprzedni_imiennik = nowy;
+  pierwszy->nastepny_imiennik = nowy;
 }
 
-/* wypisywanie bazy posortowanej wzgledem nazwisk */
-void wypisywanie_bazy(baza *b)
+/* usuniecie osoby z indeksu nazwisk - imiennika wystarczy odlaczyc od listy; */
+/* gdy usuwamy pierwsza osobe listy, jej miejsce w tablicy zajmuje nastepny */
+/* imiennik, a jesli go nie ma - miejsce zwalniamy jak w usuwanie_z_indeksu */
+void usuwanie_z_indeksu_nazwisk(graf *g, wezel *usuwany)
 {
-  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  wezel *wezelwsk;
-  krawedz *krawedzwsk;
+  indeks_nazwisk *indeks = &g->nazwiska;
+  int maska = indeks->pojemnosc-1;
+  int wolne, i, poczatek;
 
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
-
-  printf("Wypisywanie bazy posortowanej wzgledem nazwisk osob:\n");
-  /* ponizej sortowanie po nazwiskach, szczegoly w czesci "sortowanie" */
-  b->zrodlo = sortowanie_przez_scalanie(b->zrodlo, b->liczba_elementow, 3);
-
-
-  wezelwsk = b->zrodlo;
-  while(wezelwsk != NULL)
+  if(usuwany->poprzedni_imiennik != NULL)
   {
-    printf("Id = %d\nImiona: %s %s, Nazwisko: %s\n", wezelwsk->id,
-      wezelwsk->pierwsze_imie, wezelwsk->drugie_imie, wezelwsk->nazwisko);
-    printf("Adres:\n");
-    printf("ulica %s %d/%d, kod pocztowy: %s, miasto: %s\n",
-      wezelwsk->adres.ulica, wezelwsk->adres.nr_domu, wezelwsk->adres.nr_mieszkania,
-      wezelwsk->adres.kod_pocztowy, wezelwsk->adres.miasto);
-    printf("nr telefonu: %d\n\n", wezelwsk->nr_telefonu);
-    printf("Znajomi osoby:\n");
-    krawedzwsk = wezelwsk->pierwszy;
-    while(krawedzwsk != NULL)
+    usuwany->poprzedni_imiennik->nastepny_imiennik = usuwany->nastepny_imiennik;
+    if(usuwany->nastepny_imiennik != NULL)
+      usuwany->nastepny_imiennik->poprzedni_imiennik = usuwany->poprzedni_imiennik;
+    return ;
+  }
+  if(indeks->pojemnosc == 0)
+    return ;
+  wolne = (int)(usuwany->skrot_nazwiska & (unsigned int)maska);
+  while(indeks->tablica[wolne] != NULL && indeks->tablica[wolne] != usuwany)
+    wolne = (wolne+1) & maska;
+  if(indeks->tablica[wolne] == NULL)
+    return ; /* osoby nie ma w indeksie */
+  if(usuwany->nastepny_imiennik != NULL)
+  {
+    indeks->tablica[wolne] = usuwany->nastepny_imiennik;
+    usuwany->nastepny_imiennik->poprzedni_imiennik = NULL;
+    return ;
+  }
+  indeks->tablica[wolne] = NULL;
+  indeks->liczba_nazwisk--;
+  for(i = (wolne+1) & maska; indeks->tablica[i] != NULL; i = (i+1) & maska)
+  {
+    poczatek = (int)(indeks->tablica[i]->skrot_nazwiska & (unsigned int)maska);
+    if(((i - poczatek) & maska) >= ((i - wolne) & maska))
     {
-      printf("id %d, %s %s, stopien znajomosci: %d\n", krawedzwsk->cel->id,
-        krawedzwsk->cel->pierwsze_imie, krawedzwsk->cel->nazwisko, krawedzwsk->waga);
-      krawedzwsk = krawedzwsk->nastepny;
+      indeks->tablica[wolne] = indeks->tablica[i];
+      indeks->tablica[i] = NULL;
+      wolne = i;
     }
-    printf("\n");
-    wezelwsk = wezelwsk->nastepny;
   }
-
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
 }
 
-void dodawanie_znajomosci(baza *b)
+/* przygotowanie miejsca na n wezlow w tablicy slotow i w indeksie, zeby przy */
+/* dodawaniu wielu wezli naraz (wczytywanie) tablice nie byly wielokrotnie powiekszane */
+void rezerwowanie_miejsca_na_wezly(graf *g, int n)
 {
-  int id1, id2, wynik, stopien_znajomosci1, stopien_znajomosci2;
-  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  char* napis1 = "Podaj identyfikator pierwszej osoby\n";
-  char* napis2 = "Podaj identyfikator drugiej osoby\n";
-  char* napis3 = "Podaj stopien w jakim pierwsza osoba zna osobe druga\n";
-  char* napis4 = "Podaj stopien w jakim druga osoba zna osobe pierwsza\n";
-  wezel *wsk1, *wsk2;
-
-  printf("Dodawanie znajomosci miedzy dwiema osobami\n");
+  int pojemnosc = (g->indeks.pojemnosc == 0)? 64 : g->indeks.pojemnosc;
+
+  if(n > g->pojemnosc_slotow)
+  {
+    g->pojemnosc_slotow = n;
+    g->sloty = (wezel**) realloc(g->sloty, g->pojemnosc_slotow*sizeof(wezel*));
+    g->wolne_sloty = (int*) realloc(g->wolne_sloty, g->pojemnosc_slotow*sizeof(int));
+  }
+  while(pojemnosc < 2*n)
+    pojemnosc *= 2;
+  if(pojemnosc != g->indeks.pojemnosc)
+    zmiana_pojemnosci_indeksu(&g->indeks, pojemnosc);
+  /* zakladamy, ze imiona i nazwiska sie nie powtarzaja */
+  if(pojemnosc > g->nazwiska.pojemnosc)
+    zmiana_pojemnosci_indeksu_nazwisk(&g->nazwiska, pojemnosc);
+}
+
+/* funkcja szuka w grafie wezla o identyfikatorze podanym jako argument
+   jesli wezel o podanym id istnieje w grafie to funkcja zwraca wskaznik
+   do tego wezla, w przeciwnym przypadku funkcja zwraca NULL */
+wezel* znajdz_wezel(graf *g, int id)
+{
+  if(g->indeks.liczba_wezlow == 0) /* przypadek gdy graf pusty */
+    return NULL;
+  return g->indeks.tablica[miejsce_w_indeksie(&g->indeks, id)];
+}
+
+/* funkcja zwraca wskaznik do pierwszej osoby o podanym pierwszym imieniu */
+/* i nazwisku (kolejne osoby o tych samych danych sa na liscie nastepny_imiennik) */
+/* lub NULL, jesli takiej osoby nie ma w grafie */
+wezel* znajdz_osobe(graf *g, const char *pierwsze_imie, const char *nazwisko)
+{
+  if(g->nazwiska.liczba_nazwisk == 0)
+    return NULL;
+  return g->nazwiska.tablica[miejsce_w_indeksie_nazwisk(&g->nazwiska,
+           mieszanie_nazwiska(pierwsze_imie, nazwisko), pierwsze_imie, nazwisko)];
+}
+
+/* indeks miejsca zajmowanego w zbiorze przez krawedz do wezla o danym id, a jesli */
+/* takiej krawedzi nie ma - indeks wolnego miejsca, w ktorym zakonczylo sie szukanie */
+int miejsce_w_zbiorze(zbior_sasiadow *zbior, int id)
+{
+  int i = mieszanie_id(id, zbior->pojemnosc);
+
+  while(zbior->tablica[i] != NULL && zbior->tablica[i]->cel->id != id)
+    i = (i+1) & (zbior->pojemnosc-1);
+  return i;
+}
+
+/* dodanie krawedzi do zbioru sasiadow - gdy tablica jest zapelniona w polowie */
+/* to zwiekszamy ja dwukrotnie i wstawiamy wszystkie krawedzie od nowa */
+void dodawanie_do_zbioru(zbior_sasiadow *zbior, krawedz *nowa)
+{
+  krawedz **stara = zbior->tablica;
+  int i, stara_pojemnosc = zbior->pojemnosc;
+
+  if(2*(zbior->liczba_krawedzi+1) > zbior->pojemnosc)
+  {
+    zbior->pojemnosc = (stara_pojemnosc == 0)? 4*PROG_ZBIORU_SASIADOW : 2*stara_pojemnosc;
+    zbior->tablica = (krawedz**) calloc(zbior->pojemnosc, sizeof(krawedz*));
+    for(i = 0; i < stara_pojemnosc; i++)
+      if(stara[i] != NULL)
+        zbior->tablica[miejsce_w_zbiorze(zbior, stara[i]->cel->id)] = stara[i];
+    free(stara);
+  }
+  zbior->tablica[miejsce_w_zbiorze(zbior, nowa->cel->id)] = nowa;
+  zbior->liczba_krawedzi++;
+}
+
+/* usuniecie krawedzi ze zbioru sasiadow - tak samo jak w usuwanie_z_indeksu */
+/* przesuwamy kolejne krawedzie z ciagu zajetych miejsc w zwolnione miejsce */
+void usuwanie_ze_zbioru(zbior_sasiadow *zbior, krawedz *usuwana)
+{
+  int maska = zbior->pojemnosc-1;
+  int wolne, i, poczatek;
+
+  wolne = miejsce_w_zbiorze(zbior, usuwana->cel->id);
+  zbior->tablica[wolne] = NULL;
+  zbior->liczba_krawedzi--;
+  for(i = (wolne+1) & maska; zbior->tablica[i] != NULL; i = (i+1) & maska)
+  {
+    poczatek = mieszanie_id(zbior->tablica[i]->cel->id, zbior->pojemnosc);
+    if(((i - poczatek) & maska) >= ((i - wolne) & maska))
+    {
+      zbior->tablica[wolne] = zbior->tablica[i];
+      zbior->tablica[i] = NULL;
+      wolne = i;
+    }
+  }
+}
+
+void zwalnianie_zbioru_sasiadow(graf *g, wezel *wezelwsk)
+{
+  zbior_sasiadow *zbior = wezelwsk->zbior;
+
+  if(zbior == NULL)
+    return ;
+  if(zbior->poprzedni == NULL)
+    g->zbiory = zbior->nastepny;
+  else
+    zbior->poprzedni->nastepny = zbior->nastepny;
+  if(zbior->nastepny != NULL)
+    zbior->nastepny->poprzedni = zbior->poprzedni;
+  free(zbior->tablica);
+  free(zbior);
+  wezelwsk->zbior = NULL;
+}
+
+/* funkcja zwraca krawedz z wezla1 do wezla2 lub NULL, gdy taka krawedz nie istnieje */
+/* dla wezlow o duzym stopniu czas jest staly, dla pozostalych przegladamy ich */
+/* (krotka) liste krawedzi */
+krawedz* znajdz_krawedz(wezel *wezel1, wezel *wezel2)
+{
+  krawedz *krawedzwsk;
+
+  if(wezel1->zbior != NULL)
+    return wezel1->zbior->tablica[miejsce_w_zbiorze(wezel1->zbior, wezel2->id)];
+  for(krawedzwsk = wezel1->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+    if(krawedzwsk->cel == wezel2)
+      return krawedzwsk;
+  return NULL;
+}
+
+/* dopisanie krawedzi na koniec listy krawedzi wezla - gdy stopien wezla */
+/* osiagnie PROG_ZBIORU_SASIADOW to tworzymy zbior jego sasiadow */
+void dopisywanie_krawedzi(graf *g, wezel *wezelwsk, krawedz *nowa)
+{
+  krawedz *krawedzwsk;
+
+  nowa->nastepny = NULL;
+  nowa->poprzedni = wezelwsk->ostatni;
+  if(wezelwsk->ostatni == NULL) /* przypadek gdy pusta lista krawedzi */
+    wezelwsk->pierwszy = nowa;
+  else
+    wezelwsk->ostatni->nastepny = nowa;
+  wezelwsk->ostatni = nowa;
+  wezelwsk->stopien++;
+
+  if(wezelwsk->zbior != NULL)
+    dodawanie_do_zbioru(wezelwsk->zbior, nowa);
+  else if(wezelwsk->stopien >= PROG_ZBIORU_SASIADOW)
+  {
+    wezelwsk->zbior = (zbior_sasiadow*) malloc(sizeof(zbior_sasiadow));
+    wezelwsk->zbior->tablica = NULL;
+    wezelwsk->zbior->pojemnosc = 0;
+    wezelwsk->zbior->liczba_krawedzi = 0;
+    wezelwsk->zbior->poprzedni = NULL;
+    wezelwsk->zbior->nastepny = g->zbiory;
+    if(g->zbiory != NULL)
+      g->zbiory->poprzedni = wezelwsk->zbior;
+    g->zbiory = wezelwsk->zbior;
+    for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+      dodawanie_do_zbioru(wezelwsk->zbior, krawedzwsk);
+  }
+}
+
+/* odlaczenie krawedzi od listy krawedzi wezla (bez zwalniania pamieci) */
+void odlaczanie_krawedzi(wezel *wezelwsk, krawedz *usuwana)
+{
+  if(usuwana->poprzedni == NULL)
+    wezelwsk->pierwszy = usuwana->nastepny;
+  else
+    usuwana->poprzedni->nastepny = usuwana->nastepny;
+  if(usuwana->nastepny == NULL)
+    wezelwsk->ostatni = usuwana->poprzedni;
+  else
+    usuwana->nastepny->poprzedni = usuwana->poprzedni;
+  wezelwsk->stopien--;
+  if(wezelwsk->zbior != NULL)
+    usuwanie_ze_zbioru(wezelwsk->zbior, usuwana);
+}
+
+/* Jesli nie istnieje krawedz miedzy wezlami o identyfikatorach */
+/* id1, id2 to funkcja zwraca -1, w przeciwnym przypadku zwraca 0 */
+/* zmiana jest od razu nanoszona na aktualna migawke grafu - bez jej przebudowy */
+int zmiana_wagi_krawedzi(graf *g, wezel *wezel1, wezel *wezel2, int nowa_waga)
+{
+  krawedz *krawedzwsk;
+
+  if((krawedzwsk = znajdz_krawedz(wezel1, wezel2)) == NULL)
+    return -1;
+  krawedzwsk->waga = nowa_waga;
+  if(!g->migawka.nieaktualna)
+    g->migawka.wagi[krawedzwsk->indeks_w_migawce] = (unsigned char) nowa_waga;
+  return 0;
+}
+
+/* dopisanie wezla na koniec listy wszystkich wezlow grafu */
+void dopisywanie_wezla(graf *g, wezel *nowy)
+{
+  nowy->nastepny = NULL;
+  nowy->poprzedni = g->ostatni_wezel;
+  if(g->ostatni_wezel == NULL) /* graf pusty */
+    g->zrodlo = nowy;
+  else
+    g->ostatni_wezel->nastepny = nowy;
+  g->ostatni_wezel = nowy;
+}
+
+/* po zmianie kolejnosci wezlow (sortowaniu), ktore ustawia tylko pola "nastepny", */
+/* odtwarzamy pola "poprzedni" i wskaznik na ostatni wezel */
+void odtwarzanie_poprzednikow(graf *g)
+{
+  wezel *wezelwsk, *poprzedni = NULL;
+
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+  {
+    wezelwsk->poprzedni = poprzedni;
+    poprzedni = wezelwsk;
+  }
+  g->ostatni_wezel = poprzedni;
+}
+
+/* zakladamy ze wezel o podanym id nie istnieje w grafie */
+/* funkcja zwraca wskaznik na nowo dodany wezel */
+wezel* dodawanie_wezla(graf *g, int id)
+{
+  wezel *nowy = (wezel*) przydzielanie_z_puli(&g->pula_wezlow);
+
+  nowy->id = id;
+  nowy->pierwszy = NULL;
+  nowy->ostatni = NULL;
+  nowy->stopien = 0;
+  nowy->zbior = NULL;
+  przydzielanie_slotu(g, nowy);
+  dodawanie_do_indeksu(g, nowy);
+  dopisywanie_wezla(g, nowy);
+  return nowy;
+}
+
+/* waga1 mowi w jakim stopniu osoba 1 zna osobe 2, waga2 odwrotnie */
+/* Jesli waga1 lub waga2 nie miesci sie w przedziale [1, 10] albo wezly */
+/* sa tym samym wezlem to funkcja zwraca -1, jesli krawedz istniala juz wczesniej */
+/* to funkcja zwraca -2, w przeciwnym przypadku funkcja zwraca 0 */
+int dodawanie_krawedzi(graf *g, wezel *wezel1, wezel *wezel2, int waga1, int waga2)
+{
+  krawedz *nowa1, *nowa2;
+
+  if(waga1 < 1 || 10 < waga1 || waga2 < 1 || 10 < waga2 || wezel1 == wezel2)
+    return -1;
+  /* krawedzie sa dodawane parami, wiec wystarczy sprawdzic jeden kierunek */
+  if(znajdz_krawedz(wezel1, wezel2) != NULL)
+    return -2;
+
+  nowa1 = (krawedz*) przydzielanie_z_puli(&g->pula_krawedzi);
+  nowa2 = (krawedz*) przydzielanie_z_puli(&g->pula_krawedzi);
+  nowa1->cel = wezel2;
+  nowa2->cel = wezel1;
+  nowa1->waga = waga1;
+  nowa2->waga = waga2;
+  nowa1->blizniacza = nowa2;
+  nowa2->blizniacza = nowa1;
+  dopisywanie_krawedzi(g, wezel1, nowa1);
+  dopisywanie_krawedzi(g, wezel2, nowa2);
+  dopisywanie_do_migawki(g, wezel1, nowa1);
+  dopisywanie_do_migawki(g, wezel2, nowa2);
+  return 0;
+}
+
+/* usuwanie wszystkich krawedzi wychodzacych wezla (razem z jego zbiorem sasiadow) */
+void usuwanie_krawedzi_wychodzacych(graf *g, wezel *wezelwsk)
+{
+  krawedz *krawedzwsk, *temp;
+
+  for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL; krawedzwsk = temp)
+  {
+    temp = krawedzwsk->nastepny;
+    zwracanie_do_puli(&g->pula_krawedzi, krawedzwsk);
+  }
+  wezelwsk->pierwszy = wezelwsk->ostatni = NULL;
+  wezelwsk->stopien = 0;
+  zwalnianie_zbioru_sasiadow(g, wezelwsk);
+}
+
+/* usuwanie wezla razem ze wszystkimi krawedziami wchodzacymi i wychodzacymi */
+/* jesli wezel o identyfikatorze id nie istnieje w grafie funkcja zwraca -1 */
+/* w przeciwnym przypadku zwraca 0 */
+/* krawedzie wchodzace to krawedzie blizniacze krawedzi wychodzacych, wiec koszt */
+/* usuwania zalezy tylko od liczby znajomych usuwanej osoby, a nie od wielkosci grafu */
+int usuwanie_wezla(graf *g, int id)
+{
+  wezel *usuwany;
+  krawedz *krawedzwsk;
+
+  usuwany = znajdz_wezel(g, id);
+
+  if(usuwany == NULL)
+    return -1;
+
+  /* krawedzie wchodzace usuwamy zanim zwolnimy wezel, bo w zbiorach */
+  /* sasiadow krawedzie sa wyszukiwane wedlug id wezla docelowego */
+  for(krawedzwsk = usuwany->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+    if(krawedzwsk->blizniacza != NULL)
+    {
+      usuwanie_z_migawki(g, krawedzwsk->cel, krawedzwsk->blizniacza);
+      odlaczanie_krawedzi(krawedzwsk->cel, krawedzwsk->blizniacza);
+      zwracanie_do_puli(&g->pula_krawedzi, krawedzwsk->blizniacza);
+    }
+
+  usuwanie_krawedzi_wychodzacych(g, usuwany);
+  zwalnianie_slotu(g, usuwany);
+  usuwanie_z_indeksu(g, usuwany);
+  usuwanie_z_indeksu_nazwisk(g, usuwany);
+  usuwanie_z_widokow(g, usuwany);
+
+  if(usuwany->poprzedni == NULL) /* przypadek gdy usuwany wezel to pierwszy wezel grafu */
+    g->zrodlo = usuwany->nastepny;
+  else
+    usuwany->poprzedni->nastepny = usuwany->nastepny;
+  if(usuwany->nastepny == NULL)
+    g->ostatni_wezel = usuwany->poprzedni;
+  else
+    usuwany->nastepny->poprzedni = usuwany->poprzedni;
+  zwracanie_do_puli(&g->pula_wezlow, usuwany);
+  return 0;
+}
+
+/* ogolne usuwanie krawedzi miedzy dwoma wezlami */
+/* funkcja zwraca -1 gdy w grafie nie istnieje ktorys z wezlow */
+/* o identyfikatorach id1 lub id2. Jesli krawedz miedzy tymi wezlami */
+/* nie istnieje to funkcja zwraca -2, w przeciwnym przypadku 0 */
+int usuwanie_krawedzi(graf *g, int id1, int id2)
+{
+  wezel *wezel1, *wezel2;
+  krawedz *krawedzwsk;
+
+  wezel1 = znajdz_wezel(g, id1);
+  wezel2 = znajdz_wezel(g, id2);
+
+  if(wezel1 == NULL || wezel2 == NULL)
+    return -1;
+  if((krawedzwsk = znajdz_krawedz(wezel1, wezel2)) == NULL)
+    return -2;
+  if(krawedzwsk->blizniacza != NULL)
+  {
+    usuwanie_z_migawki(g, wezel2, krawedzwsk->blizniacza);
+    odlaczanie_krawedzi(wezel2, krawedzwsk->blizniacza);
+    zwracanie_do_puli(&g->pula_krawedzi, krawedzwsk->blizniacza);
+  }
+  usuwanie_z_migawki(g, wezel1, krawedzwsk);
+  odlaczanie_krawedzi(wezel1, krawedzwsk);
+  zwracanie_do_puli(&g->pula_krawedzi, krawedzwsk);
+  return 0;
+}
+
+/* krawedz powrotna bez pary dla krawedzi krawedzwsk wychodzacej z wezla wezelwsk; */
+/* jesli jej nie ma (znajomosc zapisana w pliku tylko u jednej osoby albo u jednej */
+/* osoby kilka razy) to ja tworzymy z ta sama waga - dzieki temu kazda krawedz ma */
+/* blizniacza i usuwanie osoby nie zostawia krawedzi prowadzacych do zwolnionego wezla */
+krawedz* krawedz_powrotna_bez_pary(graf *g, wezel *wezelwsk, krawedz *krawedzwsk)
+{
+  krawedz *powrotna = znajdz_krawedz(krawedzwsk->cel, wezelwsk);
+
+  /* zbior sasiadow znajduje tylko jedna krawedz, a powtorzone szukamy na liscie */
+  if(powrotna != NULL && powrotna->blizniacza != NULL)
+    for(powrotna = krawedzwsk->cel->pierwszy; powrotna != NULL; powrotna = powrotna->nastepny)
+      if(powrotna->cel == wezelwsk && powrotna->blizniacza == NULL)
+        break;
+  if(powrotna == NULL)
+  {
+    powrotna = (krawedz*) przydzielanie_z_puli(&g->pula_krawedzi);
+    powrotna->cel = wezelwsk;
+    powrotna->waga = krawedzwsk->waga;
+    powrotna->blizniacza = NULL;
+    dopisywanie_krawedzi(g, krawedzwsk->cel, powrotna);
+    g->migawka.nieaktualna = true;
+  }
+  return powrotna;
+}
+
+/* laczenie w pary krawedzi blizniaczych po wczytaniu grafu z pliku - zwykle */
+/* kazda znajomosc jest zapisana u obu osob, a brakujace krawedzie powrotne */
+/* tworzy krawedz_powrotna_bez_pary, wiec po wczytaniu graf jest symetryczny */
+void laczenie_krawedzi_blizniaczych(graf *g)
+{
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+    for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+      if(krawedzwsk->blizniacza == NULL)
+      {
+        krawedzwsk->blizniacza = krawedz_powrotna_bez_pary(g, wezelwsk, krawedzwsk);
+        krawedzwsk->blizniacza->blizniacza = krawedzwsk;
+      }
+}
+
+/* usuwanie calej zawartosci bazy (wezlow, krawedzi i danych pomocniczych) */
+/* po wykonaniu funkcji baza jest pusta i gotowa do ponownego uzycia */
+/* wezly i krawedzie sa zwalniane razem z pulami, bez przegladania grafu */
+void czyszczenie_bazy(baza *b)
+{
+  zbior_sasiadow *temp;
+  int i;
+
+  while(b->zbiory != NULL)
+  {
+    temp = b->zbiory->nastepny;
+    free(b->zbiory->tablica);
+    free(b->zbiory);
+    b->zbiory = temp;
+  }
+  resetowanie_puli(&b->pula_wezlow);
+  resetowanie_puli(&b->pula_krawedzi);
+  for(i = 0; i < MAKS_POZIOM_WIDOKU; i++)
+    resetowanie_puli(&b->widoki.pule_wiez[i]);
+  free(b->sloty);
+  free(b->wolne_sloty);
+  zwalnianie_migawki(&b->migawka);
+  free(b->indeks.tablica);
+  free(b->nazwiska.tablica);
+  inicjalizacja_bazy(b);
+}
+
+/******************** wczytywanie danych z klawiatury ***********************/
+
+/* wczytywanie dowolnych danych w programie
+napis jest komunikatem wystwietalnym za kazdym razem gdy uzytkownik
+poda zla wartosc, kryterium sprawdza czy podana wartosc jest prawidlowa
+jesli typ_danych == 'i' to wczytujemy liczby
+jesli typ_danych == 's' to wczytujemy napisy */
+void wczytywanie(char *napis, bool (*kryterium)(char*), char typ_danych,
+                 void *wynik)
+{
+  int err;
+  char dane[32]; // wczytywane liczby i napisy trzymamy na poczatku
+  bool poprawna_wartosc = false; // w stringu dane
+  while(!poprawna_wartosc)
+  {
+    printf("%s", napis);
+    err = scanf("%s", dane);
+    if(err == -1) printf("blad - znak konca pliku\n");
+    else if(err == 0) // scanf nie wczytal poprawnie wartosci
+    {// to sie raczej nie powinno wydarzyc bo napisy zawsze sie dobrze wczytuja
+      printf("podano niewlasciwe dane\n");
+      while('\n' != getchar()); // oczyszczamy bufor ze zbednych znakow (liczb)
+      continue;
+    }
+
+    poprawna_wartosc = kryterium(dane);
+    if(poprawna_wartosc == false)
+      printf("podano niepoprawne dane\n");
+    else break; // np. kod pocztowy 01_99 zamiast 01-111
+  }
+  if(typ_danych == 'i') *((int*) wynik) = atoi(dane);// konwersja stringu na liczbe
+  else strcpy((char*) wynik, dane); /* typ_danych == 's' brak konwersji */
+}
+
+/* sprawdzamy czy napis zawiera tylko litery */
+bool kryterium_napisowe(char* napis)
+{
+  int i = 0;
+  while(*(napis+i) != '\0')
+  {
+    if(!isalpha(napis[i])) // funkcja z ctype.h
+         return false;
+    i++;
+  }
+  return true;
+}
+
+/* sprawdzamy czy napis jest liczba */
+bool kryterium_liczbowe(char* napis)
+{
+  int i = 0;
+  while(*(napis+i) != '\0')
+  {
+    if(!isdigit(napis[i])) // funkcja z ctype.h
+         return false;
+    i++;
+  }
+  return true;
+}
+
+/* kryterium uzywane do sprawdzania czy stopien znajomosci */
+/* miedzy osobami miesci sie w przedziale <1, 10> */
+bool kryterium_wagowe(char* dane)
+{
+  int liczba;
+
+  if(kryterium_liczbowe(dane))
+    liczba = atoi(dane);
+  else
+    return false;
+
+  if(liczba < 1 || 10 < liczba)
+    return false;
+
+  return true;
+}
+
+/* kryterium do funkcji main */
+bool kryterium1(char* dane)
+{
+  int liczba;
+
+  if(kryterium_liczbowe(dane))
+    liczba = atoi(dane);
+  else
+    return false;
+
+  return liczba == 1 || liczba == 2 || liczba == 3 || liczba == 4 || liczba == 5 ||
+  liczba == 6 || liczba == 7 || liczba == 8 || liczba == 9 || liczba == 10 || liczba == 11;
+}
+
+/* kryterium do funkcji sortowanie */
+bool kryterium2(char* dane)
+{
+  int liczba;
+
+  if(kryterium_liczbowe(dane))
+    liczba = atoi(dane);
+  else
+    return false;
+
+  return liczba >= 1 && liczba <= 5;
+}
+
+/* kryterium uzywane do wyborow typu tak lub nie */
+bool kryterium3(char* dane)
+{
+  int liczba;
+
+  if(kryterium_liczbowe(dane))
+    liczba = atoi(dane);
+  else
+    return false;
+
+  return liczba == 1 || liczba == 2;
+}
+
+// kryterium do sprawdzania czy kod pocztowy zostal poprawnie wpisany
+// np. "01-234"
+bool kryterium_kod_pocztowy(char* kod)
+{
+  int i = 0;
+  // petla wykonuje sie az napotkamy znak null lub przekroczymy dlugosc
+  while((*(kod+i) != '\0') && (i < 6)) // kodu pocztowego
+  {
+    if(i == 2)
+    {
+      if(kod[i] != '-') return false;
+    }
+    else
+    {
+      if(!(kod[i] >= '0' && kod[i] <= '9')) return false;
+    }
+    i++;
+    if(i == 6 && kod[6] == '\0') return true; // caly kod jest poprawny
+  }
+  return false;
+}
+
+/**************** operacje wejscia, wyjscia z uzyciem plikow ******************/
+
+/* czas rzeczywisty w sekundach - clock() sumuje czas procesora wszystkich */
+/* watkow, wiec nie nadaje sie do mierzenia przepustowosci */
+double czas_zegarowy(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec*1e-9;
+}
+
+/* tekst pliku odwzorowany w pamieci (albo wczytany do bufora, gdy odwzorowanie */
+/* sie nie powiodlo) i biezaca pozycja w nim - pola wezlow sa kopiowane prosto */
+/* z tego tekstu, bez posrednich buforow na linie */
+typedef struct
+{
+  char *tekst;
+  long rozmiar;
+  bool odwzorowany; /* true - tekst z mmap, false - tekst w buforze z malloc */
+  const char *pozycja;
+  const char *koniec;
+} czytnik_tekstu;
+
+/* otwarcie pliku do czytania; jesli pliku nie udalo sie otworzyc funkcja zwraca -1 */
+int otwieranie_czytnika(czytnik_tekstu *c, char *nazwa_pliku)
+{
+  struct stat informacje;
+  long przeczytane = 0, n;
+  int plik;
+
+  if((plik = open(nazwa_pliku, O_RDONLY)) == -1)
+    return -1;
+  if(fstat(plik, &informacje) == -1)
+  {
+    close(plik);
+    return -1;
+  }
+  c->rozmiar = informacje.st_size;
+  c->tekst = MAP_FAILED;
+  if(c->rozmiar > 0)
+    c->tekst = mmap(NULL, c->rozmiar, PROT_READ, MAP_PRIVATE, plik, 0);
+  c->odwzorowany = (c->tekst != MAP_FAILED);
+  if(c->odwzorowany)
+    madvise(c->tekst, c->rozmiar, MADV_SEQUENTIAL); /* strony czytamy po kolei */
+  else
+  { /* pusty plik lub plik, ktorego nie da sie odwzorowac - czytamy duzymi blokami */
+    c->tekst = (char*) malloc(c->rozmiar + 1);
+    while(przeczytane < c->rozmiar &&
+          (n = read(plik, c->tekst + przeczytane, c->rozmiar - przeczytane)) > 0)
+      przeczytane += n;
+    c->rozmiar = przeczytane;
+  }
+  close(plik);
+  c->pozycja = c->tekst;
+  c->koniec = c->tekst + c->rozmiar;
+  return 0;
+}
+
+/* czytnik calego standardowego wejscia (np. potoku, ktorego nie da sie */
+/* odwzorowac) - tekst jest czytany duzymi blokami do rosnacego bufora */
+int otwieranie_czytnika_wejscia(czytnik_tekstu *c)
+{
+  long pojemnosc = 1 << 20, n;
+
+  c->tekst = (char*) malloc(pojemnosc);
+  c->rozmiar = 0;
+  c->odwzorowany = false;
+  while((n = read(0, c->tekst + c->rozmiar, pojemnosc - c->rozmiar)) > 0)
+  {
+    c->rozmiar += n;
+    if(c->rozmiar == pojemnosc)
+    {
+      pojemnosc *= 2;
+      c->tekst = (char*) realloc(c->tekst, pojemnosc);
+    }
+  }
+  if(n == -1)
+  {
+    free(c->tekst);
+    return -1;
+  }
+  c->pozycja = c->tekst;
+  c->koniec = c->tekst + c->rozmiar;
+  return 0;
+}
+
+void zamykanie_czytnika(czytnik_tekstu *c)
+{
+  if(c->odwzorowany)
+    munmap(c->tekst, c->rozmiar);
+  else
+    free(c->tekst);
+}
+
+void pomijanie_odstepow(czytnik_tekstu *c)
+{
+  while(c->pozycja < c->koniec && isspace((unsigned char)*c->pozycja))
+    c->pozycja++;
+}
+
+/* dopasowanie stalego tekstu tak jak w formacie scanf - odstep we wzorcu */
+/* pasuje do dowolnej liczby bialych znakow; jesli tekst nie pasuje to pozycja */
+/* czytnika sie nie zmienia i funkcja zwraca false */
+bool dopasowanie_tekstu(czytnik_tekstu *c, const char *wzorzec)
+{
+  const char *poczatek = c->pozycja;
+
+  for(; *wzorzec != '\0'; wzorzec++)
+  {
+    if(isspace((unsigned char)*wzorzec))
+      pomijanie_odstepow(c);
+    else if(c->pozycja < c->koniec && *c->pozycja == *wzorzec)
+      c->pozycja++;
+    else
+    {
+      c->pozycja = poczatek;
+      return false;
+    }
+  }
+  return true;
+}
+
+/* odpowiednik %s - slowo do najblizszego bialego znaku jest kopiowane do pola */
+/* o podanym rozmiarze (dluzsze slowo jest obcinane); zwraca false gdy brak slowa */
+bool czytanie_slowa(czytnik_tekstu *c, char *cel, int rozmiar)
+{
+  int dlugosc = 0;
+
+  pomijanie_odstepow(c);
+  while(c->pozycja < c->koniec && !isspace((unsigned char)*c->pozycja))
+  {
+    if(dlugosc < rozmiar-1)
+      cel[dlugosc++] = *c->pozycja;
+    c->pozycja++;
+  }
+  cel[dlugosc] = '\0';
+  return dlugosc > 0;
+}
+
+/* odpowiednik %d; zwraca false gdy na biezacej pozycji nie ma liczby */
+bool czytanie_liczby(czytnik_tekstu *c, int *liczba)
+{
+  bool ujemna = false;
+  int wynik = 0;
+
+  pomijanie_odstepow(c);
+  if(c->pozycja < c->koniec && *c->pozycja == '-')
+  {
+    ujemna = true;
+    c->pozycja++;
+  }
+  if(c->pozycja == c->koniec || !isdigit((unsigned char)*c->pozycja))
+    return false;
+  while(c->pozycja < c->koniec && isdigit((unsigned char)*c->pozycja))
+    wynik = 10*wynik + (*c->pozycja++ - '0');
+  *liczba = ujemna? -wynik : wynik;
+  return true;
+}
+
+/* wezel o danym id w czasie wczytywania - gdy identyfikatory sa geste (mniejsze */
+/* od biezacego id z naglowka pliku) to wezly sa w zwyklej tablicy indeksowanej */
+/* przez id, co oszczedza przegladanie tablicy mieszajacej przy kazdej znajomosci */
+wezel* wezel_wczytywany(baza *b, wezel **wezly_wg_id, int zakres, int id)
+{
+  if(wezly_wg_id != NULL && id >= 0 && id < zakres)
+    return wezly_wg_id[id];
+  return znajdz_wezel(b, id);
+}
+
+/* dane osobowe i adres osoby (po naglowku "Osoba, id ...") - wspolne dla */
+/* wczytywania szeregowego i rownoleglego; funkcja zwraca true, gdy wszystkie */
+/* pola osoby byly na swoich miejscach */
+bool czytanie_danych_osoby(czytnik_tekstu *c, wezel *wezelwsk)
+{
+  bool poprawne = dopasowanie_tekstu(c, " Dane osobowe:");
+
+  poprawne &= czytanie_slowa(c, wezelwsk->pierwsze_imie, sizeof(wezelwsk->pierwsze_imie));
+  poprawne &= czytanie_slowa(c, wezelwsk->drugie_imie, sizeof(wezelwsk->drugie_imie));
+  poprawne &= czytanie_slowa(c, wezelwsk->nazwisko, sizeof(wezelwsk->nazwisko));
+  poprawne &= dopasowanie_tekstu(c, " nr telefonu:");
+  poprawne &= czytanie_liczby(c, &wezelwsk->nr_telefonu);
+
+  poprawne &= dopasowanie_tekstu(c, " Adres: Ulica");
+  poprawne &= czytanie_slowa(c, wezelwsk->adres.ulica, sizeof(wezelwsk->adres.ulica));
+  poprawne &= czytanie_liczby(c, &wezelwsk->adres.nr_domu);
+  poprawne &= dopasowanie_tekstu(c, "/");
+  poprawne &= czytanie_liczby(c, &wezelwsk->adres.nr_mieszkania);
+  poprawne &= dopasowanie_tekstu(c, ", kod pocztowy:");
+  poprawne &= czytanie_slowa(c, wezelwsk->adres.kod_pocztowy, sizeof(wezelwsk->adres.kod_pocztowy));
+  poprawne &= dopasowanie_tekstu(c, " miasto:");
+  poprawne &= czytanie_slowa(c, wezelwsk->adres.miasto, sizeof(wezelwsk->adres.miasto));
+  return poprawne;
+}
+
+/* reszta wiersza znajomosci (po "Id <id>") - imie i nazwisko znajomego sa w pliku */
+/* tylko dla czytelnika; funkcja zwraca true, gdy wiersz byl kompletny */
+bool czytanie_wagi_znajomosci(czytnik_tekstu *c, int *waga)
+{
+  char pomijane_imie[32];
+  bool poprawne = czytanie_slowa(c, pomijane_imie, sizeof(pomijane_imie));
+
+  poprawne &= czytanie_slowa(c, pomijane_imie, sizeof(pomijane_imie));
+  poprawne &= dopasowanie_tekstu(c, " stopien znajomosci:");
+  poprawne &= czytanie_liczby(c, waga);
+  return poprawne;
+}
+
+/* nowy wezel wczytanej osoby - dolaczany do grafu w kolejnosci osob w pliku */
+void dodawanie_wczytanej_osoby(baza *b, wezel *wezelwsk, wezel **wezly_wg_id, int zakres)
+{
+  wezelwsk->pierwszy = wezelwsk->ostatni = NULL;
+  wezelwsk->stopien = 0;
+  wezelwsk->zbior = NULL;
+  przydzielanie_slotu(b, wezelwsk);
+  dodawanie_do_indeksu(b, wezelwsk);
+  dodawanie_do_indeksu_nazwisk(b, wezelwsk);
+  b->widoki.nieaktualne = true; /* widoki zbudujemy naraz, gdy beda potrzebne */
+  b->migawka.nieaktualna = true; /* migawke tez */
+  if(wezly_wg_id != NULL && wezelwsk->id >= 0 && wezelwsk->id < zakres)
+    wezly_wg_id[wezelwsk->id] = wezelwsk;
+  dopisywanie_wezla(b, wezelwsk); /* odtwarzamy liste wezlow grafu */
+}
+
+/* nowa krawedz wczytanej znajomosci - dopisywana na koniec listy krawedzi osoby; */
+/* znajomosc osoby z soba sama pomijamy (dodawanie_krawedzi tez jej nie tworzy) */
+void dodawanie_wczytanej_znajomosci(baza *b, wezel *wezelwsk, wezel *cel, int waga)
+{
+  krawedz *krawedzwsk;
+
+  if(cel == wezelwsk)
+    return;
+  krawedzwsk = (krawedz*) przydzielanie_z_puli(&b->pula_krawedzi);
+  krawedzwsk->cel = cel;
+  krawedzwsk->waga = waga;
+  krawedzwsk->blizniacza = NULL;
+  dopisywanie_krawedzi(b, wezelwsk, krawedzwsk);
+}
+
+/* wczytywanie osob i znajomosci jednym watkiem, od biezacej pozycji czytnika */
+/* (za naglowkiem pliku) do konca pliku */
+void wczytywanie_szeregowe(baza *b, czytnik_tekstu *c, wezel **wezly_wg_id, int zakres)
+{
+  wezel *wezelwsk, *cel;
+  int id, waga;
+
+  /* wczytywanie informacji o kazdym wezle z pliku */
+  /* warunek w petli while sprawdza czy w pliku sa jeszcze jakies osoby (wezly) */
+  while(dopasowanie_tekstu(c, " Osoba, id") && czytanie_liczby(c, &id))
+  {
+    wezelwsk = (wezel*) przydzielanie_z_puli(&b->pula_wezlow);
+    wezelwsk->id = id;
+    czytanie_danych_osoby(c, wezelwsk);
+    dodawanie_wczytanej_osoby(b, wezelwsk, wezly_wg_id, zakres);
+  }
+  /* wczytujemy informacje o znajomosciach miedzy osobami z pliku */
+  dopasowanie_tekstu(c, " Informacje o znajomosciach miedzy osobami");
+  while(dopasowanie_tekstu(c, " Znajomi osoby o identyfikatorze") && czytanie_liczby(c, &id))
+  {
+    dopasowanie_tekstu(c, ":");
+    wezelwsk = wezel_wczytywany(b, wezly_wg_id, zakres, id);
+    while(dopasowanie_tekstu(c, " Id") && czytanie_liczby(c, &id))
+    {
+      czytanie_wagi_znajomosci(c, &waga);
+      if(wezelwsk != NULL && (cel = wezel_wczytywany(b, wezly_wg_id, zakres, id)) != NULL)
+        dodawanie_wczytanej_znajomosci(b, wezelwsk, cel, waga);
+    }
+  }
+  laczenie_krawedzi_blizniaczych(b);
+}
+
+/* znajomosc przeczytana przez watek - cel ustalamy dopiero wtedy, */
+/* gdy w grafie sa juz wszystkie osoby */
+typedef struct
+{
+  int id;
+  int waga;
+  wezel *cel;
+} wczytana_znajomosc;
+
+/* znajomi jednej osoby - znajomosci [pierwsza, pierwsza+liczba) tablicy fragmentu */
+typedef struct
+{
+  int id;
+  int pierwsza, liczba;
+  wezel *wezelwsk;
+} wczytani_znajomi;
+
+/* fragment pliku wczytywany przez jeden watek: czesc osob i czesc znajomosci */
+/* (fragmenty zaczynaja sie na granicach rekordow) oraz to, co z nich wczytano */
+typedef struct
+{
+  baza *b;
+  wezel **wezly_wg_id;
+  int zakres;
+  czytnik_tekstu osoby_w_pliku, znajomosci_w_pliku;
+  wezel *osoby;
+  int liczba_osob, pojemnosc_osob;
+  wczytani_znajomi *znajomi;
+  int liczba_znajomych, pojemnosc_znajomych;
+  wczytana_znajomosc *znajomosci;
+  int liczba_znajomosci, pojemnosc_znajomosci;
+  int pierwszy_slot, koniec_slotow; /* wezly, ktorych krawedzie blizniacze laczy watek */
+  /* false - fragment nie ma oczekiwanej postaci (lub w grafie sa powtorzone */
+  /* znajomosci) i baze trzeba wczytac szeregowo, zeby wynik byl taki sam */
+  bool poprawny;
+} fragment_wczytywania;
+
+/* pierwsze wystapienie wzorca w tekscie [poczatek, koniec) lub koniec gdy go nie ma */
+const char* szukanie_tekstu(const char *poczatek, const char *koniec, const char *wzorzec)
+{
+  int dlugosc = strlen(wzorzec);
+
+  for(; koniec - poczatek >= dlugosc; poczatek++)
+  {
+    poczatek = memchr(poczatek, wzorzec[0], koniec - poczatek - dlugosc + 1);
+    if(poczatek == NULL)
+      break;
+    if(memcmp(poczatek, wzorzec, dlugosc) == 0)
+      return poczatek;
+  }
+  return koniec;
+}
+
+/* podzial tekstu na n fragmentow (granice[0..n]) o zblizonej dlugosci - kazda */
+/* granica wewnatrz tekstu lezy na poczatku wzorca, ktory rozpoczyna rekord */
+void podzial_na_fragmenty(const char *poczatek, const char *koniec, const char *wzorzec,
+                          int n, const char **granice)
+{
+  int i;
+
+  granice[0] = poczatek;
+  for(i = 1; i < n; i++)
+  {
+    granice[i] = szukanie_tekstu(poczatek + (koniec - poczatek)/n*i, koniec, wzorzec);
+    if(granice[i] < granice[i-1])
+      granice[i] = granice[i-1];
+  }
+  granice[n] = koniec;
+}
+
+/* pierwszy etap wczytywania rownoleglego - watek czyta swoje osoby i znajomosci */
+/* do wlasnych tablic, graf nie jest jeszcze zmieniany */
+void* wczytywanie_fragmentu(void *argument)
+{
+  fragment_wczytywania *f = (fragment_wczytywania*) argument;
+  czytnik_tekstu *c = &f->osoby_w_pliku;
+  wczytani_znajomi *znajomi;
+  int id, waga;
+
+  while(dopasowanie_tekstu(c, " Osoba, id") && czytanie_liczby(c, &id))
+  {
+    if(f->liczba_osob == f->pojemnosc_osob)
+    {
+      f->pojemnosc_osob = (f->pojemnosc_osob == 0)? 1024 : 2*f->pojemnosc_osob;
+      f->osoby = (wezel*) realloc(f->osoby, f->pojemnosc_osob*sizeof(wezel));
+    }
+    f->osoby[f->liczba_osob].id = id;
+    f->poprawny &= czytanie_danych_osoby(c, &f->osoby[f->liczba_osob]);
+    f->liczba_osob++;
+  }
+  pomijanie_odstepow(c);
+  f->poprawny &= (c->pozycja == c->koniec);
+
+  c = &f->znajomosci_w_pliku;
+  while(dopasowanie_tekstu(c, " Znajomi osoby o identyfikatorze") && czytanie_liczby(c, &id))
+  {
+    f->poprawny &= dopasowanie_tekstu(c, ":");
+    if(f->liczba_znajomych == f->pojemnosc_znajomych)
+    {
+      f->pojemnosc_znajomych = (f->pojemnosc_znajomych == 0)? 1024 : 2*f->pojemnosc_znajomych;
+      f->znajomi = (wczytani_znajomi*) realloc(f->znajomi, f->pojemnosc_znajomych*sizeof(wczytani_znajomi));
+    }
+    znajomi = &f->znajomi[f->liczba_znajomych++];
+    znajomi->id = id;
+    znajomi->pierwsza = f->liczba_znajomosci;
+    while(dopasowanie_tekstu(c, " Id") && czytanie_liczby(c, &id))
+    {
+      f->poprawny &= czytanie_wagi_znajomosci(c, &waga);
+      if(f->liczba_znajomosci == f->pojemnosc_znajomosci)
+      {
+        f->pojemnosc_znajomosci = (f->pojemnosc_znajomosci == 0)? 4096 : 2*f->pojemnosc_znajomosci;
+        f->znajomosci = (wczytana_znajomosc*) realloc(f->znajomosci,
+          f->pojemnosc_znajomosci*sizeof(wczytana_znajomosc));
+      }
+      f->znajomosci[f->liczba_znajomosci].id = id;
+      f->znajomosci[f->liczba_znajomosci].waga = waga;
+      f->liczba_znajomosci++;
+    }
+    znajomi->liczba = f->liczba_znajomosci - znajomi->pierwsza;
+  }
+  pomijanie_odstepow(c);
+  f->poprawny &= (c->pozycja == c->koniec);
+  return NULL;
+}
+
+/* drugi etap - wszystkie osoby sa juz w grafie (indeksy sa tylko czytane), */
+/* wiec watki ustalaja wezly osob i celow swoich znajomosci niezaleznie */
+void* ustalanie_celow_fragmentu(void *argument)
+{
+  fragment_wczytywania *f = (fragment_wczytywania*) argument;
+  int i;
+
+  for(i = 0; i < f->liczba_znajomych; i++)
+    f->znajomi[i].wezelwsk = wezel_wczytywany(f->b, f->wezly_wg_id, f->zakres, f->znajomi[i].id);
+  for(i = 0; i < f->liczba_znajomosci; i++)
+    f->znajomosci[i].cel = wezel_wczytywany(f->b, f->wezly_wg_id, f->zakres, f->znajomosci[i].id);
+  return NULL;
+}
+
+/* trzeci etap - laczenie krawedzi blizniaczych wezlow z przedzialu slotow; */
+/* kazdy watek zmienia tylko krawedzie wychodzace ze swoich wezlow, a listy */
+/* krawedzi sa tylko czytane; wynik jest taki sam jak w laczenie_krawedzi_blizniaczych, */
+/* jesli zadna osoba nie ma dwoch znajomosci z ta sama osoba i kazda znajomosc jest */
+/* zapisana u obu osob - wtedy to sprawdzamy */
+void* laczenie_blizniaczych_fragmentu(void *argument)
+{
+  fragment_wczytywania *f = (fragment_wczytywania*) argument;
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+  int i;
+
+  for(i = f->pierwszy_slot; i < f->koniec_slotow; i++)
+    for(wezelwsk = f->b->sloty[i], krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL;
+        krawedzwsk = krawedzwsk->nastepny)
+    {
+      krawedzwsk->blizniacza = znajdz_krawedz(krawedzwsk->cel, wezelwsk);
+      if(krawedzwsk->blizniacza == NULL || znajdz_krawedz(wezelwsk, krawedzwsk->cel) != krawedzwsk)
+        f->poprawny = false; /* znajomosc zapisana u jednej osoby albo powtorzona */
+    }
+  return NULL;
+}
+
+/* wczytywanie osob i znajomosci wieloma watkami: plik dzielimy na fragmenty */
+/* na granicach rekordow, watki czytaja je do wlasnych tablic, osoby i krawedzie */
+/* sa dolaczane do grafu w kolejnosci z pliku (tak jak przy wczytywaniu szeregowym), */
+/* a cele znajomosci i krawedzie blizniacze sa ustalane rownolegle; jesli plik nie */
+/* ma oczekiwanej postaci to graf nie jest zmieniany i funkcja zwraca false */
+/* - wtedy plik trzeba wczytac szeregowo */
+bool wczytywanie_rownolegle(baza *b, czytnik_tekstu *c, wezel **wezly_wg_id, int zakres,
+                            int liczba_watkow)
+{
+  char *znacznik = "\nInformacje o znajomosciach miedzy osobami";
+  fragment_wczytywania *fragmenty, *f;
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+  const char **granice_osob, **granice_znajomosci;
+  const char *koniec_osob;
+  bool poprawny = true;
+  int i, j, k;
+
+  koniec_osob = szukanie_tekstu(c->pozycja, c->koniec, znacznik);
+  if(koniec_osob == c->koniec)
+    return false;
+  fragmenty = (fragment_wczytywania*) calloc(liczba_watkow, sizeof(fragment_wczytywania));
+  granice_osob = (const char**) malloc((liczba_watkow+1)*sizeof(char*));
+  granice_znajomosci = (const char**) malloc((liczba_watkow+1)*sizeof(char*));
+  podzial_na_fragmenty(c->pozycja, koniec_osob, "\nOsoba, id", liczba_watkow, granice_osob);
+  podzial_na_fragmenty(koniec_osob + strlen(znacznik), c->koniec, "\nZnajomi osoby",
+                       liczba_watkow, granice_znajomosci);
+  for(i = 0; i < liczba_watkow; i++)
+  {
+    f = &fragmenty[i];
+    f->b = b;
+    f->wezly_wg_id = wezly_wg_id;
+    f->zakres = zakres;
+    f->osoby_w_pliku.pozycja = granice_osob[i];
+    f->osoby_w_pliku.koniec = granice_osob[i+1];
+    f->znajomosci_w_pliku.pozycja = granice_znajomosci[i];
+    f->znajomosci_w_pliku.koniec = granice_znajomosci[i+1];
+    f->poprawny = true;
+  }
+  uruchamianie_watkow(fragmenty, sizeof(fragment_wczytywania), liczba_watkow,
+                      wczytywanie_fragmentu);
+  for(i = 0; i < liczba_watkow; i++)
+    poprawny &= fragmenty[i].poprawny;
+
+  if(poprawny)
+  {
+    /* osoby i krawedzie dolaczamy w kolejnosci z pliku, wiec dostaja te same */
+    /* sloty i miejsca na listach co przy wczytywaniu szeregowym */
+    for(i = 0; i < liczba_watkow; i++)
+      for(f = &fragmenty[i], j = 0; j < f->liczba_osob; j++)
+      {
+        wezelwsk = (wezel*) przydzielanie_z_puli(&b->pula_wezlow);
+        *wezelwsk = f->osoby[j];
+        dodawanie_wczytanej_osoby(b, wezelwsk, wezly_wg_id, zakres);
+      }
+    uruchamianie_watkow(fragmenty, sizeof(fragment_wczytywania), liczba_watkow,
+                        ustalanie_celow_fragmentu);
+    for(i = 0; i < liczba_watkow; i++)
+      for(f = &fragmenty[i], j = 0; j < f->liczba_znajomych; j++)
+        if(f->znajomi[j].wezelwsk != NULL)
+          for(k = f->znajomi[j].pierwsza; k < f->znajomi[j].pierwsza + f->znajomi[j].liczba; k++)
+            if(f->znajomosci[k].cel != NULL)
+              dodawanie_wczytanej_znajomosci(b, f->znajomi[j].wezelwsk, f->znajomosci[k].cel,
+                                             f->znajomosci[k].waga);
+
+    for(i = 0; i < liczba_watkow; i++)
+    {
+      fragmenty[i].pierwszy_slot = (long)b->liczba_slotow*i/liczba_watkow;
+      fragmenty[i].koniec_slotow = (long)b->liczba_slotow*(i+1)/liczba_watkow;
+    }
+    uruchamianie_watkow(fragmenty, sizeof(fragment_wczytywania), liczba_watkow,
+                        laczenie_blizniaczych_fragmentu);
+    for(i = 0; i < liczba_watkow && fragmenty[i].poprawny; i++);
+    if(i < liczba_watkow)
+    { /* jednostronne lub powtorzone znajomosci - pary krawedzi ustalamy (i brakujace */
+      /* krawedzie tworzymy) tak jak przy wczytywaniu szeregowym */
+      for(wezelwsk = b->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+        for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+          krawedzwsk->blizniacza = NULL;
+      laczenie_krawedzi_blizniaczych(b);
+    }
+  }
+
+  for(i = 0; i < liczba_watkow; i++)
+  {
+    free(fragmenty[i].osoby);
+    free(fragmenty[i].znajomi);
+    free(fragmenty[i].znajomosci);
+  }
+  free(fragmenty);
+  free(granice_osob);
+  free(granice_znajomosci);
+  return poprawny;
+}
+
+/* wczytywanie bazy z pliku o podanej nazwie, dotychczasowa zawartosc bazy jest usuwana */
+/* jesli pliku nie udalo sie otworzyc to funkcja zwraca -1 (baza pozostaje bez zmian), */
+/* w przeciwnym przypadku liczbe wczytanych bajtow - najpierw sa wczytywane glowne */
+/* informacje o grafie, potem informacje o wszystkich wezlach, a na koncu informacje */
+/* o krawedziach miedzy wezlami; osoby wskazywane w znajomosciach sa wyszukiwane */
+/* w indeksie identyfikatorow, a znajomosci z nieistniejacymi osobami pomijamy; */
+/* duze pliki sa czytane podana liczba watkow - wynik jest taki sam jak dla jednego */
+long wczytywanie_bazy_z_pliku_watkami(baza *b, char *nazwa_pliku, int liczba_watkow)
+{
+  czytnik_tekstu c;
+  int liczba_elementow = 0, biezacy_id = 1;
+  wezel **wezly_wg_id = NULL;
+
+  if(otwieranie_czytnika(&c, nazwa_pliku) == -1)
+    return -1;
+  /* oczyszczanie bazy z poprzednich danych */
+  czyszczenie_bazy(b);
+
+  /* wczytywanie glownych informacji o bazie (grafie) z pliku */
+  if(dopasowanie_tekstu(&c, "Ksiazka adresowo-spolecznosciowa Liczba elementow:") &&
+     czytanie_liczby(&c, &liczba_elementow) && dopasowanie_tekstu(&c, ", biezacy id:"))
+    czytanie_liczby(&c, &biezacy_id);
+  b->liczba_elementow = liczba_elementow;
+  b->biezacy_id = biezacy_id;
+  rezerwowanie_miejsca_na_wezly(b, liczba_elementow);
+  /* tablice id -> wezel tworzymy tylko gdy nie jest duzo wieksza od liczby osob */
+  if(biezacy_id > 0 && biezacy_id <= 4*liczba_elementow + 1024)
+    wezly_wg_id = (wezel**) calloc(biezacy_id, sizeof(wezel*));
+
+  if(liczba_watkow < 2 || c.rozmiar < PROG_WCZYTYWANIA_ROWNOLEGLEGO ||
+     !wczytywanie_rownolegle(b, &c, wezly_wg_id, biezacy_id, liczba_watkow))
+    wczytywanie_szeregowe(b, &c, wezly_wg_id, biezacy_id);
+
+  free(wezly_wg_id);
+  zamykanie_czytnika(&c);
+  return c.rozmiar;
+}
+
+/* wczytywanie bazy wszystkimi dostepnymi procesorami */
+long wczytywanie_bazy_z_pliku(baza *b, char *nazwa_pliku)
+{
+  return wczytywanie_bazy_z_pliku_watkami(b, nazwa_pliku, (int)sysconf(_SC_NPROCESSORS_ONLN));
+}
+
+/* tekst skladany recznie (bez fprintf i analizy formatu przy kazdej linii) */
+/* w buforze, ktory jest zapisywany do pliku duzymi blokami */
+typedef struct
+{
+  char *dane;
+  long dlugosc;
+  long pojemnosc;
+} bufor_tekstu;
+
+/* zapewnienie w buforze miejsca na co najmniej potrzebne bajty - funkcje */
+/* dopisujace tekst nie sprawdzaja juz rozmiaru bufora */
+void rezerwowanie_bufora(bufor_tekstu *bufor, long potrzebne)
+{
+  if(bufor->dlugosc + potrzebne <= bufor->pojemnosc)
+    return;
+  while(bufor->dlugosc + potrzebne > bufor->pojemnosc)
+    bufor->pojemnosc = (bufor->pojemnosc == 0)? (1 << 16) : 2*bufor->pojemnosc;
+  bufor->dane = (char*) realloc(bufor->dane, bufor->pojemnosc);
+}
+
+void dopisywanie_napisu(bufor_tekstu *bufor, const char *napis)
+{
+  char *cel = bufor->dane + bufor->dlugosc;
+
+  while(*napis != '\0')
+    *cel++ = *napis++;
+  bufor->dlugosc = cel - bufor->dane;
+}
+
+/* odpowiednik %d */
+void dopisywanie_liczby(bufor_tekstu *bufor, int liczba)
+{
+  char cyfry[12];
+  unsigned int wartosc = (liczba < 0)? -(unsigned int)liczba : (unsigned int)liczba;
+  int n = 0;
+
+  if(liczba < 0)
+    bufor->dane[bufor->dlugosc++] = '-';
+  do
+  {
+    cyfry[n++] = '0' + wartosc % 10;
+    wartosc /= 10;
+  } while(wartosc > 0);
+  while(n > 0)
+    bufor->dane[bufor->dlugosc++] = cyfry[--n];
+}
+
+/* rekord osoby w pliku tekstowym - napisy w wezle maja najwyzej 31 znakow, */
+/* wiec caly rekord miesci sie w 512 bajtach */
+void formatowanie_osoby(bufor_tekstu *bufor, wezel *wezelwsk)
+{
+  rezerwowanie_bufora(bufor, 512);
+  dopisywanie_napisu(bufor, "\nOsoba, id ");
+  dopisywanie_liczby(bufor, wezelwsk->id);
+  dopisywanie_napisu(bufor, "\nDane osobowe:\n");
+  dopisywanie_napisu(bufor, wezelwsk->pierwsze_imie);
+  dopisywanie_napisu(bufor, " ");
+  dopisywanie_napisu(bufor, wezelwsk->drugie_imie);
+  dopisywanie_napisu(bufor, " ");
+  dopisywanie_napisu(bufor, wezelwsk->nazwisko);
+  dopisywanie_napisu(bufor, " nr telefonu: ");
+  dopisywanie_liczby(bufor, wezelwsk->nr_telefonu);
+
+  dopisywanie_napisu(bufor, "\nAdres:\nUlica ");
+  dopisywanie_napisu(bufor, wezelwsk->adres.ulica);
+  dopisywanie_napisu(bufor, " ");
+  dopisywanie_liczby(bufor, wezelwsk->adres.nr_domu);
+  dopisywanie_napisu(bufor, "/");
+  dopisywanie_liczby(bufor, wezelwsk->adres.nr_mieszkania);
+  dopisywanie_napisu(bufor, ", kod pocztowy: ");
+  dopisywanie_napisu(bufor, wezelwsk->adres.kod_pocztowy);
+  dopisywanie_napisu(bufor, " miasto: ");
+  dopisywanie_napisu(bufor, wezelwsk->adres.miasto);
+  dopisywanie_napisu(bufor, "\n");
+}
+
+/* lista znajomych osoby w pliku tekstowym - linia znajomosci ma najwyzej 128 bajtow; */
+/* znajomi leza w przypadkowych miejscach pamieci, wiec najpierw zlecamy pobranie */
+/* ich id i nazwisk (pierwsze 128 bajtow wezla) dla calej listy naraz, zamiast */
+/* czekac na kazdego znajomego osobno */
+void formatowanie_znajomych(bufor_tekstu *bufor, wezel *wezelwsk)
+{
+  krawedz *krawedzwsk;
+
+  for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+  {
+    POBIERANIE_Z_WYPRZEDZENIEM(krawedzwsk->cel);
+    POBIERANIE_Z_WYPRZEDZENIEM((char*)krawedzwsk->cel + 64);
+  }
+  rezerwowanie_bufora(bufor, 64 + 128L*wezelwsk->stopien);
+  dopisywanie_napisu(bufor, "\nZnajomi osoby o identyfikatorze ");
+  dopisywanie_liczby(bufor, wezelwsk->id);
+  dopisywanie_napisu(bufor, ":\n");
+  for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+  {
+    dopisywanie_napisu(bufor, "Id ");
+    dopisywanie_liczby(bufor, krawedzwsk->cel->id);
+    dopisywanie_napisu(bufor, " ");
+    dopisywanie_napisu(bufor, krawedzwsk->cel->pierwsze_imie);
+    dopisywanie_napisu(bufor, " ");
+    dopisywanie_napisu(bufor, krawedzwsk->cel->nazwisko);
+    dopisywanie_napisu(bufor, " stopien znajomosci: ");
+    dopisywanie_liczby(bufor, krawedzwsk->waga);
+    dopisywanie_napisu(bufor, "\n");
+  }
+}
+
+/* zapisanie calego bufora do pliku i oproznienie bufora; zwraca -1 gdy */
+/* zapis sie nie powiodl */
+int oproznianie_bufora(bufor_tekstu *bufor, int plik)
+{
+  long zapisane = 0, n;
+
+  while(zapisane < bufor->dlugosc)
+  {
+    if((n = write(plik, bufor->dane + zapisane, bufor->dlugosc - zapisane)) <= 0)
+      return -1;
+    zapisane += n;
+  }
+  bufor->dlugosc = 0;
+  return 0;
+}
+
+/* kolejne wezly (w kolejnosci listy wezlow) formatowane przez jeden watek */
+/* do wlasnego bufora - bufory watkow sa zapisywane do pliku po kolei */
+typedef struct
+{
+  wezel **wezly;
+  int pierwszy, koniec; /* przedzial [pierwszy, koniec) tablicy wezly */
+  bool znajomi; /* false - rekordy osob, true - listy znajomych */
+  bufor_tekstu bufor;
+} fragment_zapisu;
+
+void* formatowanie_fragmentu(void *argument)
+{
+  fragment_zapisu *f = (fragment_zapisu*) argument;
+  int i;
+
+  for(i = f->pierwszy; i < f->koniec; i++)
+    if(f->znajomi)
+      formatowanie_znajomych(&f->bufor, f->wezly[i]);
+    else
+      formatowanie_osoby(&f->bufor, f->wezly[i]);
+  return NULL;
+}
+
+/* zapisywanie bazy do pliku o podanej nazwie - najpierw sa zapisywane glowne */
+/* informacje o grafie, potem informacje o wszystkich wezlach, a na koncu */
+/* informacje o krawedziach miedzy wezlami; wezly sa formatowane porcjami */
+/* po WEZLOW_W_PORCJI_ZAPISU przez podana liczbe watkow, a bufory watkow sa */
+/* zapisywane w kolejnosci wezlow, wiec plik nie zalezy od liczby watkow; */
+/* jesli pliku nie udalo sie utworzyc lub zapisac to funkcja zwraca -1, */
+/* w przeciwnym przypadku liczbe zapisanych bajtow */
+long zapisywanie_bazy_do_pliku_watkami(baza *b, char *nazwa_pliku, int liczba_watkow)
+{
+  fragment_zapisu *fragmenty;
+  bufor_tekstu naglowek = {NULL, 0, 0};
+  wezel *wezelwsk, **wezly;
+  long rozmiar = 0;
+  int plik, n = 0, i, poczatek, etap, wynik = 0;
+
+  if((plik = open(nazwa_pliku, O_WRONLY | O_CREAT | O_TRUNC, 0666)) == -1)
+    return -1;
+  if(liczba_watkow < 1)
+    liczba_watkow = 1;
+  wezly = (wezel**) malloc((b->liczba_slotow + 1)*sizeof(wezel*));
+  for(wezelwsk = b->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+    wezly[n++] = wezelwsk;
+  fragmenty = (fragment_zapisu*) calloc(liczba_watkow, sizeof(fragment_zapisu));
+  for(i = 0; i < liczba_watkow; i++)
+    fragmenty[i].wezly = wezly;
+
+  /* zapisywanie glownych informacji o bazie (grafie) do pliku */
+  rezerwowanie_bufora(&naglowek, 128);
+  dopisywanie_napisu(&naglowek, "Ksiazka adresowo-spolecznosciowa\nLiczba elementow: ");
+  dopisywanie_liczby(&naglowek, b->liczba_elementow);
+  dopisywanie_napisu(&naglowek, ", biezacy id: ");
+  dopisywanie_liczby(&naglowek, b->biezacy_id);
+  dopisywanie_napisu(&naglowek, "\n");
+  /* etap 0 - informacje o kazdym wezle, etap 1 - informacje o krawedziach */
+  for(etap = 0; etap < 2 && wynik == 0; etap++)
+  {
+    if(etap == 1)
+    {
+      rezerwowanie_bufora(&naglowek, 64);
+      dopisywanie_napisu(&naglowek, "\nInformacje o znajomosciach miedzy osobami\n");
+    }
+    rozmiar += naglowek.dlugosc;
+    wynik = oproznianie_bufora(&naglowek, plik);
+    for(poczatek = 0; poczatek < n && wynik == 0; poczatek += liczba_watkow*WEZLOW_W_PORCJI_ZAPISU)
+    {
+      for(i = 0; i < liczba_watkow; i++)
+      {
+        fragmenty[i].pierwszy = poczatek + i*WEZLOW_W_PORCJI_ZAPISU;
+        fragmenty[i].koniec = fragmenty[i].pierwszy + WEZLOW_W_PORCJI_ZAPISU;
+        if(fragmenty[i].pierwszy > n)
+          fragmenty[i].pierwszy = n;
+        if(fragmenty[i].koniec > n)
+          fragmenty[i].koniec = n;
+        fragmenty[i].znajomi = (etap == 1);
+      }
+      uruchamianie_watkow(fragmenty, sizeof(fragment_zapisu), liczba_watkow,
+                          formatowanie_fragmentu);
+      for(i = 0; i < liczba_watkow && wynik == 0; i++)
+      {
+        rozmiar += fragmenty[i].bufor.dlugosc;
+        wynik = oproznianie_bufora(&fragmenty[i].bufor, plik);
+      }
+    }
+  }
+
+  for(i = 0; i < liczba_watkow; i++)
+    free(fragmenty[i].bufor.dane);
+  free(fragmenty);
+  free(wezly);
+  free(naglowek.dane);
+  if(close(plik) == -1 || wynik == -1)
+    return -1;
+  return rozmiar;
+}
+
+/* zapisywanie bazy wszystkimi dostepnymi procesorami */
+long zapisywanie_bazy_do_pliku(baza *b, char *nazwa_pliku)
+{
+  return zapisywanie_bazy_do_pliku_watkami(b, nazwa_pliku, (int)sysconf(_SC_NPROCESSORS_ONLN));
+}
+
+/******************** ksiazka w formacie binarnym ***************************/
+
+/* plik binarny sklada sie z naglowka i sekcji: rekordow osob o stalym rozmiarze, */
+/* krawedzi w formacie CSR (tak jak migawka grafu) oraz indeksu identyfikatorow; */
+/* przesuniecia sekcji sa liczone od poczatku pliku, wiec plik odwzorowany */
+/* w pamieci pod dowolnym adresem jest od razu gotowy do wyszukiwania sciezek, */
+/* bez przetwarzania go i tworzenia wezlow; liczby sa zapisane w porzadku bajtow */
+/* komputera, na ktorym plik utworzono */
+typedef struct
+{
+  char sygnatura[8]; /* SYGNATURA_PLIKU_BINARNEGO */
+  uint32_t wersja; /* WERSJA_PLIKU_BINARNEGO */
+  int32_t liczba_osob;
+  int32_t biezacy_id;
+  int32_t liczba_krawedzi;
+  int32_t pojemnosc_indeksu; /* potega dwojki */
+  int32_t zarezerwowane;
+  uint64_t przesuniecie_osob; /* liczba_osob rekordow osob */
+  uint64_t przesuniecie_poczatkow; /* liczba_osob+1 liczb - jak poczatki w migawce CSR */
+  uint64_t przesuniecie_sasiadow; /* liczba_krawedzi numerow rekordow osob */
+  uint64_t przesuniecie_wag; /* liczba_krawedzi bajtow */
+  uint64_t przesuniecie_indeksu; /* pojemnosc_indeksu wpisow indeksu */
+  uint64_t rozmiar_pliku;
+} naglowek_pliku_binarnego;
+
+/* osoba w pliku binarnym - numer rekordu pelni role numeru slotu w migawce */
+typedef struct
+{
+  int32_t id;
+  int32_t nr_telefonu;
+  int32_t nr_domu;
+  int32_t nr_mieszkania;
+  char pierwsze_imie[32];
+  char drugie_imie[32];
+  char nazwisko[32];
+  char ulica[32];
+  char kod_pocztowy[8];
+  char miasto[32];
+} rekord_osoby;
+
+/* wpis indeksu identyfikatorow (adresowanie otwarte, sondowanie liniowe, miejsce */
+/* poczatkowe wyznacza mieszanie_id) - id jest w samym wpisie, wiec szukanie */
+/* nie siega do rekordow osob; numer == -1 oznacza wolne miejsce */
+typedef struct
+{
+  int32_t id;
+  int32_t numer;
+} wpis_indeksu_binarnego;
+
+/* ksiazka binarna odwzorowana w pamieci (tylko do odczytu) */
+typedef struct
+{
+  char *dane;
+  long rozmiar;
+  naglowek_pliku_binarnego *naglowek;
+  rekord_osoby *osoby;
+  wpis_indeksu_binarnego *indeks;
+  /* graf bez wezlow - jego migawka CSR wskazuje na sekcje krawedzi pliku, */
+  /* a sloty to numery rekordow; wystarcza to algorytmom wyszukiwania sciezek */
+  graf graf;
+} ksiazka_binarna;
+
+/* zaokraglenie przesuniecia sekcji w gore do wielokrotnosci 8 bajtow */
+uint64_t wyrownanie_sekcji(uint64_t przesuniecie)
+{
+  return (przesuniecie + 7) & ~(uint64_t)7;
+}
+
+/* dopisanie zer do pliku az do podanego przesuniecia (wyrownanie sekcji); */
+/* funkcja zwraca false, gdy zapis sie nie udal */
+bool dopelnianie_pliku(FILE *plik, uint64_t przesuniecie)
+{
+  while((uint64_t)ftell(plik) < przesuniecie)
+    if(fputc(0, plik) == EOF)
+      return false;
+  return true;
+}
+
+/* zapisywanie bazy do pliku binarnego - rekordy osob sa w kolejnosci listy wezlow; */
+/* jesli pliku nie udalo sie utworzyc lub zapisac to funkcja zwraca -1 (czesciowo */
+/* zapisany plik jest usuwany), w przeciwnym przypadku 0 */
+int zapisywanie_ksiazki_binarnej(baza *b, char *nazwa_pliku)
+{
+  FILE *plik;
+  naglowek_pliku_binarnego naglowek;
+  rekord_osoby rekord;
+  wpis_indeksu_binarnego *indeks;
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+  int *numery, *poczatki, *sasiedzi;
+  unsigned char *wagi;
+  int n = 0, m = 0, i, j, k;
+  bool poprawny;
+
+  if((plik = fopen(nazwa_pliku, "wb")) == NULL)
+    return -1;
+  /* numery rekordow osob wedlug slotow wezlow */
+  numery = (int*) malloc((b->liczba_slotow > 0 ? b->liczba_slotow : 1)*sizeof(int));
+  for(wezelwsk = b->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+  {
+    numery[wezelwsk->slot] = n++;
+    m += wezelwsk->stopien;
+  }
+
+  memset(&naglowek, 0, sizeof(naglowek));
+  memcpy(naglowek.sygnatura, SYGNATURA_PLIKU_BINARNEGO, sizeof(naglowek.sygnatura));
+  naglowek.wersja = WERSJA_PLIKU_BINARNEGO;
+  naglowek.liczba_osob = n;
+  naglowek.biezacy_id = b->biezacy_id;
+  naglowek.liczba_krawedzi = m;
+  for(naglowek.pojemnosc_indeksu = 64; naglowek.pojemnosc_indeksu < 2*n; )
+    naglowek.pojemnosc_indeksu *= 2;
+  naglowek.przesuniecie_osob = wyrownanie_sekcji(sizeof(naglowek));
+  naglowek.przesuniecie_poczatkow =
+    wyrownanie_sekcji(naglowek.przesuniecie_osob + (uint64_t)n*sizeof(rekord_osoby));
+  naglowek.przesuniecie_sasiadow =
+    wyrownanie_sekcji(naglowek.przesuniecie_poczatkow + (uint64_t)(n+1)*sizeof(int32_t));
+  naglowek.przesuniecie_wag =
+    wyrownanie_sekcji(naglowek.przesuniecie_sasiadow + (uint64_t)m*sizeof(int32_t));
+  naglowek.przesuniecie_indeksu = wyrownanie_sekcji(naglowek.przesuniecie_wag + m);
+  naglowek.rozmiar_pliku = naglowek.przesuniecie_indeksu +
+    (uint64_t)naglowek.pojemnosc_indeksu*sizeof(wpis_indeksu_binarnego);
+
+  /* sekcje krawedzi i indeksu budujemy w pamieci, rekordy osob zapisujemy od razu */
+  poczatki = (int*) malloc((n+1)*sizeof(int));
+  sasiedzi = (int*) malloc((m > 0 ? m : 1)*sizeof(int));
+  wagi = (unsigned char*) malloc(m > 0 ? m : 1);
+  indeks = (wpis_indeksu_binarnego*) malloc(naglowek.pojemnosc_indeksu*sizeof(wpis_indeksu_binarnego));
+  for(i = 0; i < naglowek.pojemnosc_indeksu; i++)
+    indeks[i].numer = indeks[i].id = -1;
+
+  poprawny = (fwrite(&naglowek, sizeof(naglowek), 1, plik) == 1);
+  poprawny &= dopelnianie_pliku(plik, naglowek.przesuniecie_osob);
+  for(wezelwsk = b->zrodlo, i = 0, k = 0; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny, i++)
+  {
+    memset(&rekord, 0, sizeof(rekord)); /* nieuzywane bajty napisow sa zerami */
+    rekord.id = wezelwsk->id;
+    rekord.nr_telefonu = wezelwsk->nr_telefonu;
+    rekord.nr_domu = wezelwsk->adres.nr_domu;
+    rekord.nr_mieszkania = wezelwsk->adres.nr_mieszkania;
+    strcpy(rekord.pierwsze_imie, wezelwsk->pierwsze_imie);
+    strcpy(rekord.drugie_imie, wezelwsk->drugie_imie);
+    strcpy(rekord.nazwisko, wezelwsk->nazwisko);
+    strcpy(rekord.ulica, wezelwsk->adres.ulica);
+    strncpy(rekord.kod_pocztowy, wezelwsk->adres.kod_pocztowy, sizeof(rekord.kod_pocztowy)-1);
+    strcpy(rekord.miasto, wezelwsk->adres.miasto);
+    poprawny &= (fwrite(&rekord, sizeof(rekord), 1, plik) == 1);
+
+    poczatki[i] = k;
+    for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny, k++)
+    {
+      sasiedzi[k] = numery[krawedzwsk->cel->slot];
+      wagi[k] = (unsigned char) krawedzwsk->waga;
+    }
+    j = mieszanie_id(wezelwsk->id, naglowek.pojemnosc_indeksu);
+    while(indeks[j].numer != -1)
+      j = (j+1) & (naglowek.pojemnosc_indeksu-1);
+    indeks[j].id = wezelwsk->id;
+    indeks[j].numer = i;
+  }
+  poczatki[n] = m;
+
+  poprawny &= dopelnianie_pliku(plik, naglowek.przesuniecie_poczatkow);
+  poprawny &= (fwrite(poczatki, sizeof(int), n+1, plik) == (size_t)(n+1));
+  poprawny &= dopelnianie_pliku(plik, naglowek.przesuniecie_sasiadow);
+  poprawny &= (fwrite(sasiedzi, sizeof(int), m, plik) == (size_t)m);
+  poprawny &= dopelnianie_pliku(plik, naglowek.przesuniecie_wag);
+  poprawny &= (fwrite(wagi, 1, m, plik) == (size_t)m);
+  poprawny &= dopelnianie_pliku(plik, naglowek.przesuniecie_indeksu);
+  poprawny &= (fwrite(indeks, sizeof(wpis_indeksu_binarnego), naglowek.pojemnosc_indeksu, plik) ==
+               (size_t)naglowek.pojemnosc_indeksu);
+
+  poprawny &= (fclose(plik) == 0);
+  free(numery);
+  free(poczatki);
+  free(sasiedzi);
+  free(wagi);
+  free(indeks);
+  if(!poprawny)
+  { /* niepelny plik nie moze zostac wziety za ksiazke */
+    remove(nazwa_pliku);
+    return -1;
+  }
+  return 0;
+}
+
+/* sprawdzenie czy sekcja pliku o podanym przesunieciu i dlugosci miesci sie w pliku */
+bool sekcja_w_pliku(naglowek_pliku_binarnego *naglowek, uint64_t przesuniecie, uint64_t dlugosc)
+{
+  return przesuniecie % 4 == 0 && przesuniecie <= naglowek->rozmiar_pliku &&
+         dlugosc <= naglowek->rozmiar_pliku - przesuniecie;
+}
+
+/* napis w rekordzie pliku binarnego musi sie konczyc w swoim polu */
+bool napis_w_polu(const char *pole, size_t rozmiar)
+{
+  return memchr(pole, '\0', rozmiar) != NULL;
+}
+
+/* sprawdzenie zawartosci sekcji jednym przejsciem (bez przetwarzania tekstu): */
+/* poczatki rosna od 0 do liczby krawedzi, sasiedzi sa numerami rekordow, wagi */
+/* mieszcza sie w [1, 10], napisy rekordow sa zakonczone, a indeks wskazuje rekordy */
+/* o swoich id i ma wolne miejsce (inaczej wyszukiwanie nieistniejacego id */
+/* nigdy by sie nie skonczylo) - dzieki temu uszkodzony plik nie powoduje */
+/* czytania poza sekcjami ani przepelnienia napisow przy budowie bazy */
+bool poprawna_zawartosc_ksiazki_binarnej(ksiazka_binarna *k)
+{
+  naglowek_pliku_binarnego *naglowek = k->naglowek;
+  int32_t *poczatki = (int32_t*) (k->dane + naglowek->przesuniecie_poczatkow);
+  int32_t *sasiedzi = (int32_t*) (k->dane + naglowek->przesuniecie_sasiadow);
+  unsigned char *wagi = (unsigned char*) (k->dane + naglowek->przesuniecie_wag);
+  rekord_osoby *rekord;
+  int n = naglowek->liczba_osob, m = naglowek->liczba_krawedzi, i, wolne = 0;
+
+  if(poczatki[0] != 0 || poczatki[n] != m)
+    return false;
+  for(i = 0; i < n; i++)
+    if(poczatki[i] > poczatki[i+1])
+      return false;
+  for(i = 0; i < m; i++)
+    if(sasiedzi[i] < 0 || sasiedzi[i] >= n || wagi[i] < 1 || wagi[i] > 10)
+      return false;
+  for(i = 0; i < n; i++)
+  {
+    rekord = &k->osoby[i];
+    if(!napis_w_polu(rekord->pierwsze_imie, sizeof(rekord->pierwsze_imie)) ||
+       !napis_w_polu(rekord->drugie_imie, sizeof(rekord->drugie_imie)) ||
+       !napis_w_polu(rekord->nazwisko, sizeof(rekord->nazwisko)) ||
+       !napis_w_polu(rekord->ulica, sizeof(rekord->ulica)) ||
+       !napis_w_polu(rekord->kod_pocztowy, sizeof(rekord->kod_pocztowy)) ||
+       !napis_w_polu(rekord->miasto, sizeof(rekord->miasto)))
+      return false;
+  }
+  for(i = 0; i < naglowek->pojemnosc_indeksu; i++)
+  {
+    if(k->indeks[i].numer == -1)
+      wolne++;
+    else if(k->indeks[i].numer < 0 || k->indeks[i].numer >= n ||
+            k->osoby[k->indeks[i].numer].id != k->indeks[i].id)
+      return false;
+  }
+  return wolne > 0;
+}
+
+/* odwzorowanie pliku binarnego w pamieci - sprawdzamy naglowek, granice sekcji */
+/* i jednym przejsciem ich zawartosc, ale niczego nie przetwarzamy ani nie tworzymy */
+/* wezlow (plik jest od razu gotowy do wyszukiwania); jesli pliku nie udalo sie */
+/* otworzyc funkcja zwraca -1, jesli plik nie zaczyna sie sygnatura pliku */
+/* binarnego (np. jest to plik tekstowy) -2, */
+/* jesli jest to plik binarny w innej wersji lub uszkodzony -3, a w przeciwnym */
+/* przypadku 0 - ksiazke zamykamy funkcja zamykanie_ksiazki_binarnej */
+int otwieranie_ksiazki_binarnej(ksiazka_binarna *k, char *nazwa_pliku)
+{
+  naglowek_pliku_binarnego *naglowek;
+  struct stat informacje;
+  int plik;
+
+  if((plik = open(nazwa_pliku, O_RDONLY)) == -1)
+    return -1;
+  if(fstat(plik, &informacje) == -1)
+  {
+    close(plik);
+    return -1;
+  }
+  if(informacje.st_size < (long)sizeof(naglowek_pliku_binarnego))
+  {
+    close(plik);
+    return -2;
+  }
+  k->rozmiar = informacje.st_size;
+  k->dane = mmap(NULL, k->rozmiar, PROT_READ, MAP_PRIVATE, plik, 0);
+  close(plik);
+  if(k->dane == MAP_FAILED)
+    return -1;
+
+  naglowek = k->naglowek = (naglowek_pliku_binarnego*) k->dane;
+  if(memcmp(naglowek->sygnatura, SYGNATURA_PLIKU_BINARNEGO, sizeof(naglowek->sygnatura)) != 0)
+  {
+    munmap(k->dane, k->rozmiar);
+    return -2;
+  }
+  if(naglowek->wersja != WERSJA_PLIKU_BINARNEGO || naglowek->rozmiar_pliku != (uint64_t)k->rozmiar ||
+     naglowek->liczba_osob < 0 || naglowek->liczba_krawedzi < 0 ||
+     naglowek->pojemnosc_indeksu < 2*naglowek->liczba_osob || naglowek->pojemnosc_indeksu <= 0 ||
+     (naglowek->pojemnosc_indeksu & (naglowek->pojemnosc_indeksu-1)) != 0 ||
+     !sekcja_w_pliku(naglowek, naglowek->przesuniecie_osob,
+                     (uint64_t)naglowek->liczba_osob*sizeof(rekord_osoby)) ||
+     !sekcja_w_pliku(naglowek, naglowek->przesuniecie_poczatkow,
+                     (uint64_t)(naglowek->liczba_osob+1)*sizeof(int32_t)) ||
+     !sekcja_w_pliku(naglowek, naglowek->przesuniecie_sasiadow,
+                     (uint64_t)naglowek->liczba_krawedzi*sizeof(int32_t)) ||
+     !sekcja_w_pliku(naglowek, naglowek->przesuniecie_wag, naglowek->liczba_krawedzi) ||
+     !sekcja_w_pliku(naglowek, naglowek->przesuniecie_indeksu,
+                     (uint64_t)naglowek->pojemnosc_indeksu*sizeof(wpis_indeksu_binarnego)))
+  {
+    munmap(k->dane, k->rozmiar);
+    return -3;
+  }
+  k->osoby = (rekord_osoby*) (k->dane + naglowek->przesuniecie_osob);
+  k->indeks = (wpis_indeksu_binarnego*) (k->dane + naglowek->przesuniecie_indeksu);
+  if(!poprawna_zawartosc_ksiazki_binarnej(k))
+  {
+    munmap(k->dane, k->rozmiar);
+    return -3;
+  }
+
+  /* tablice migawki wskazuja na plik - migawka jest aktualna i nigdy nie jest */
+  /* budowana od nowa, bo graf nie ma wezlow ani krawedzi, ktore mozna zmienic */
+  inicjalizacja_bazy(&k->graf);
+  k->graf.liczba_elementow = naglowek->liczba_osob;
+  k->graf.biezacy_id = naglowek->biezacy_id;
+  k->graf.liczba_slotow = k->graf.pojemnosc_slotow = naglowek->liczba_osob;
+  k->graf.migawka.poczatki = (int*) (k->dane + naglowek->przesuniecie_poczatkow);
+  k->graf.migawka.konce = k->graf.migawka.poczatki + 1; /* zakresy leza jeden za drugim */
+  k->graf.migawka.sasiedzi = (int*) (k->dane + naglowek->przesuniecie_sasiadow);
+  k->graf.migawka.wagi = (unsigned char*) (k->dane + naglowek->przesuniecie_wag);
+  k->graf.migawka.liczba_wezlow = naglowek->liczba_osob;
+  k->graf.migawka.liczba_krawedzi = naglowek->liczba_krawedzi;
+  k->graf.migawka.nieaktualna = false;
+  return 0;
+}
+
+/* graf ksiazki binarnej nie jest zwalniany przez czyszczenie_bazy, bo jego */
+/* tablice naleza do odwzorowanego pliku */
+void zamykanie_ksiazki_binarnej(ksiazka_binarna *k)
+{
+  munmap(k->dane, k->rozmiar);
+}
+
+/* numer rekordu osoby o danym id lub -1 gdy takiej osoby nie ma w ksiazce */
+int numer_osoby_binarnej(ksiazka_binarna *k, int id)
+{
+  int maska = k->naglowek->pojemnosc_indeksu-1;
+  int i;
+
+  for(i = mieszanie_id(id, maska+1); k->indeks[i].numer != -1; i = (i+1) & maska)
+    if(k->indeks[i].id == id)
+      return k->indeks[i].numer;
+  return -1;
+}
+
+/* odtworzenie zwyklej bazy (wezly i listy krawedzi) z ksiazki binarnej, */
+/* np. zeby zapisac ja w formacie tekstowym lub zmieniac ja w menu */
+void budowanie_bazy_z_ksiazki_binarnej(baza *b, ksiazka_binarna *k)
+{
+  migawka_csr *m = &k->graf.migawka;
+  rekord_osoby *rekord;
+  wezel **wezly, *wezelwsk;
+  krawedz *krawedzwsk;
+  int i, j, n = k->naglowek->liczba_osob;
+
+  czyszczenie_bazy(b);
+  rezerwowanie_miejsca_na_wezly(b, n);
+  wezly = (wezel**) malloc((n > 0 ? n : 1)*sizeof(wezel*));
+  for(i = 0; i < n; i++)
+  {
+    rekord = &k->osoby[i];
+    wezelwsk = wezly[i] = dodawanie_wezla(b, rekord->id);
+    wezelwsk->nr_telefonu = rekord->nr_telefonu;
+    wezelwsk->adres.nr_domu = rekord->nr_domu;
+    wezelwsk->adres.nr_mieszkania = rekord->nr_mieszkania;
+    strcpy(wezelwsk->pierwsze_imie, rekord->pierwsze_imie);
+    strcpy(wezelwsk->drugie_imie, rekord->drugie_imie);
+    strcpy(wezelwsk->nazwisko, rekord->nazwisko);
+    strcpy(wezelwsk->adres.ulica, rekord->ulica);
+    memcpy(wezelwsk->adres.kod_pocztowy, rekord->kod_pocztowy, sizeof(wezelwsk->adres.kod_pocztowy));
+    wezelwsk->adres.kod_pocztowy[sizeof(wezelwsk->adres.kod_pocztowy)-1] = '\0';
+    strcpy(wezelwsk->adres.miasto, rekord->miasto);
+    dodawanie_do_indeksu_nazwisk(b, wezelwsk);
+  }
+  b->widoki.nieaktualne = true;
+  for(i = 0; i < n; i++)
+    for(j = m->poczatki[i]; j < m->konce[i]; j++)
+    {
+      krawedzwsk = (krawedz*) przydzielanie_z_puli(&b->pula_krawedzi);
+      krawedzwsk->cel = wezly[m->sasiedzi[j]];
+      krawedzwsk->waga = m->wagi[j];
+      krawedzwsk->blizniacza = NULL;
+      dopisywanie_krawedzi(b, wezly[i], krawedzwsk);
+    }
+  laczenie_krawedzi_blizniaczych(b);
+  b->liczba_elementow = n;
+  b->biezacy_id = k->naglowek->biezacy_id;
+  free(wezly);
+}
+
+/* konwersja pliku tekstowego na binarny (do_binarnego == true) lub odwrotnie, */
+/* wywolywana z linii polecen; zwraca kod zakonczenia programu */
+int konwersja_ksiazki(char *plik_zrodlowy, char *plik_docelowy, bool do_binarnego)
+{
+  ksiazka_binarna k;
+  baza b;
+  double poczatek = czas_zegarowy();
+  int wynik;
+
+  inicjalizacja_bazy(&b);
+  if(do_binarnego)
+  {
+    if(wczytywanie_bazy_z_pliku(&b, plik_zrodlowy) == -1)
+    {
+      printf("blad, nie znaleziono pliku zawierajacego ksiazke adresowa\n");
+      return 1;
+    }
+    wynik = zapisywanie_ksiazki_binarnej(&b, plik_docelowy);
+  }
+  else
+  {
+    if((wynik = otwieranie_ksiazki_binarnej(&k, plik_zrodlowy)) != 0)
+    {
+      if(wynik == -1)
+        printf("blad, nie znaleziono pliku zawierajacego ksiazke adresowa\n");
+      else
+        printf("blad, plik %s nie jest ksiazka binarna w wersji %d lub jest uszkodzony\n",
+               plik_zrodlowy, WERSJA_PLIKU_BINARNEGO);
+      return 1;
+    }
+    budowanie_bazy_z_ksiazki_binarnej(&b, &k);
+    zamykanie_ksiazki_binarnej(&k);
+    wynik = (zapisywanie_bazy_do_pliku(&b, plik_docelowy) == -1)? -1 : 0;
+  }
+  if(wynik == -1)
+    printf("blad, nie udalo sie utworzyc lub zapisac pliku %s\n", plik_docelowy);
+  else
+    printf("Przekonwertowano %d osob w %.6f sekund\n", b.liczba_elementow,
+           czas_zegarowy() - poczatek);
+  czyszczenie_bazy(&b);
+  return (wynik == -1)? 1 : 0;
+}
+
+/************************* dziennik zmian ********************************/
+
+/* kazda zmiana bazy wykonana w menu (dodanie, usuniecie i zmiana danych osoby, */
+/* dodanie, usuniecie i zmiana stopnia znajomosci, sortowanie) jest dopisywana */
+/* jako krotki rekord do dziennika, zamiast zapisywac cala baze; po awarii baza */
+/* jest odtwarzana z ostatniej migawki (pliku tekstowego) i rekordow dziennika */
+/* pliki dziennika: <ksiazka>.dziennik - biezacy dziennik, <ksiazka>.dziennik.stary */
+/* - poprzedni dziennik w czasie kompaktowania, <ksiazka>.tmp - nowa migawka */
+/* przed zamiana z ksiazka (pliki sa zamieniane funkcja rename, ktora jest atomowa) */
+
+/* znacznik pliku migawki - plik o innym rozmiarze, numerze i-wezla lub czasie */
+/* modyfikacji jest inna migawka niz ta, od ktorej zaczyna sie dziennik */
+typedef struct
+{
+  int64_t rozmiar;
+  uint64_t i_wezel;
+  int64_t czas_sekundy;
+  int64_t czas_nanosekundy;
+} znacznik_pliku;
+
+/* naglowek pliku dziennika - od czego zaczynamy odtwarzanie zmian */
+typedef struct
+{
+  char sygnatura[8]; /* SYGNATURA_DZIENNIKA bez koncowego znaku '\0' */
+  uint32_t wersja;
+  uint32_t rodzaj_bazy; /* BAZA_PUSTA, BAZA_Z_PLIKU lub BAZA_ZE_STAREGO_DZIENNIKA */
+  znacznik_pliku znacznik; /* tylko dla BAZA_Z_PLIKU */
+  char nazwa_bazy[256]; /* tylko dla BAZA_Z_PLIKU */
+} naglowek_dziennika;
+
+/* rekord dziennika w pliku: dlugosc tresci (4 bajty), suma kontrolna tresci */
+/* (4 bajty) i tresc - rodzaj zmiany (1 bajt) i jej argumenty; liczby sa zapisane */
+/* w kolejnosci bajtow komputera, a napisy jako dlugosc (1 bajt) i znaki */
+typedef struct
+{
+  unsigned char dane[ROZMIAR_REKORDU_DZIENNIKA];
+  int dlugosc;
+} rekord_dziennika;
+
+/* tresc rekordu czytana przy odtwarzaniu */
+typedef struct
+{
+  const unsigned char *pozycja;
+  const unsigned char *koniec;
+} czytnik_rekordu;
+
+/* dziennik otwarty do dopisywania - rekordy trafiaja do bufora oczekujacych, */
+/* a watek zatwierdzajacy zapisuje wszystkie oczekujace rekordy naraz i wykonuje */
+/* jedno fdatasync dla calej paczki (zatwierdzanie grupowe) */
+typedef struct
+{
+  char nazwa_ksiazki[256];
+  char nazwa_dziennika[272];
+  char nazwa_starego[272];
+  char nazwa_migawki[272]; /* tymczasowa nazwa nowej migawki */
+  int plik; /* -1 - dziennik wylaczony */
+  long rozmiar; /* rozmiar pliku razem z oczekujacymi rekordami */
+  long rozmiar_zatwierdzony; /* bajty zapisane i zsynchronizowane z dyskiem */
+  long liczba_zapisanych, liczba_zatwierdzonych; /* rekordy od otwarcia dziennika */
+  bool czekanie_na_zapis; /* true - zmiana wraca dopiero po zatwierdzeniu rekordu */
+  bool blad_zapisu;
+  bool koniec;
+  bool zapis_trwa;
+  bufor_tekstu oczekujace;
+  pthread_mutex_t blokada;
+  pthread_cond_t sygnal; /* nowe rekordy lub koniec pracy */
+  pthread_cond_t zatwierdzono;
+  pthread_t watek_zatwierdzania;
+  /* watek zatwierdzajacy istnieje i nie zostal jeszcze dolaczony - nie wynika */
+  /* z pola plik, bo nieudana zamiana dziennika wylacza go w trakcie pracy */
+  bool zatwierdzanie_trwa;
+  bool kompaktowanie_trwa; /* watek kompaktowania istnieje i nie zostal jeszcze dolaczony */
+  bool kompaktowanie_zakonczone; /* watek kompaktowania skonczyl prace */
+  pthread_t watek_kompaktowania;
+  int wynik_kompaktowania;
+} dziennik_zmian;
+
+bool pobieranie_znacznika(char *nazwa_pliku, znacznik_pliku *znacznik)
+{
+  struct stat informacje;
+
+  if(stat(nazwa_pliku, &informacje) == -1)
+    return false;
+  memset(znacznik, 0, sizeof(znacznik_pliku));
+  znacznik->rozmiar = informacje.st_size;
+  znacznik->i_wezel = informacje.st_ino;
+  znacznik->czas_sekundy = informacje.st_mtim.tv_sec;
+  znacznik->czas_nanosekundy = informacje.st_mtim.tv_nsec;
+  return true;
+}
+
+bool zgodny_znacznik(char *nazwa_pliku, znacznik_pliku *znacznik)
+{
+  znacznik_pliku biezacy;
+
+  return pobieranie_znacznika(nazwa_pliku, &biezacy) &&
+         memcmp(&biezacy, znacznik, sizeof(znacznik_pliku)) == 0;
+}
+
+/* synchronizacja z dyskiem pliku (lub katalogu) o podanej nazwie */
+int synchronizacja_pliku(char *nazwa_pliku)
+{
+  int plik, wynik;
+
+  if((plik = open(nazwa_pliku, O_RDONLY)) == -1)
+    return -1;
+  wynik = fsync(plik);
+  close(plik);
+  return wynik;
+}
+
+/* synchronizacja katalogu zawierajacego plik - utrwala rename i unlink */
+int synchronizacja_katalogu(char *nazwa_pliku)
+{
+  char katalog[272];
+  char *ukosnik;
+
+  strncpy(katalog, nazwa_pliku, sizeof(katalog)-1);
+  katalog[sizeof(katalog)-1] = '\0';
+  if((ukosnik = strrchr(katalog, '/')) == NULL)
+    return synchronizacja_pliku(".");
+  *(ukosnik == katalog ? ukosnik+1 : ukosnik) = '\0';
+  return synchronizacja_pliku(katalog);
+}
+
+/* zapisanie calego bloku od podanego miejsca w pliku; zwraca -1 gdy sie nie udalo */
+int zapisywanie_bloku(int plik, const char *dane, long dlugosc, long przesuniecie)
+{
+  long n;
+
+  while(dlugosc > 0)
+  {
+    if((n = pwrite(plik, dane, dlugosc, przesuniecie)) <= 0)
+      return -1;
+    dane += n;
+    dlugosc -= n;
+    przesuniecie += n;
+  }
+  return 0;
+}
+
+/* suma kontrolna tresci rekordu (FNV-1a) - rekord zapisany tylko czesciowo */
+/* przed awaria jest rozpoznawany i pomijany przy odtwarzaniu */
+uint32_t suma_kontrolna_rekordu(const unsigned char *dane, int dlugosc)
+{
+  uint32_t suma = 2166136261u;
+  int i;
+
+  for(i = 0; i < dlugosc; i++)
+    suma = (suma ^ dane[i]) * 16777619u;
+  return suma;
+}
+
+void kodowanie_liczby(rekord_dziennika *rekord, int liczba)
+{
+  memcpy(rekord->dane + rekord->dlugosc, &liczba, sizeof(int));
+  rekord->dlugosc += sizeof(int);
+}
+
+/* napisy w wezle maja najwyzej 31 znakow */
+void kodowanie_napisu(rekord_dziennika *rekord, const char *napis)
+{
+  int dlugosc = strlen(napis);
+
+  rekord->dane[rekord->dlugosc++] = (unsigned char) dlugosc;
+  memcpy(rekord->dane + rekord->dlugosc, napis, dlugosc);
+  rekord->dlugosc += dlugosc;
+}
+
+bool dekodowanie_liczby(czytnik_rekordu *c, int *liczba)
+{
+  if(c->koniec - c->pozycja < (long)sizeof(int))
+    return false;
+  memcpy(liczba, c->pozycja, sizeof(int));
+  c->pozycja += sizeof(int);
+  return true;
+}
+
+bool dekodowanie_napisu(czytnik_rekordu *c, char *cel, int rozmiar)
+{
+  int dlugosc;
+
+  if(c->pozycja == c->koniec || (dlugosc = *c->pozycja) >= rozmiar ||
+     c->koniec - c->pozycja - 1 < dlugosc)
+    return false;
+  memcpy(cel, c->pozycja + 1, dlugosc);
+  cel[dlugosc] = '\0';
+  c->pozycja += dlugosc + 1;
+  return true;
+}
+
+/* numer telefonu i adres osoby */
+void kodowanie_adresu(rekord_dziennika *rekord, wezel *wezelwsk)
+{
+  kodowanie_liczby(rekord, wezelwsk->nr_telefonu);
+  kodowanie_napisu(rekord, wezelwsk->adres.ulica);
+  kodowanie_liczby(rekord, wezelwsk->adres.nr_domu);
+  kodowanie_liczby(rekord, wezelwsk->adres.nr_mieszkania);
+  kodowanie_napisu(rekord, wezelwsk->adres.kod_pocztowy);
+  kodowanie_napisu(rekord, wezelwsk->adres.miasto);
+}
+
+bool dekodowanie_adresu(czytnik_rekordu *c, wezel *wezelwsk)
+{
+  return dekodowanie_liczby(c, &wezelwsk->nr_telefonu) &&
+         dekodowanie_napisu(c, wezelwsk->adres.ulica, sizeof(wezelwsk->adres.ulica)) &&
+         dekodowanie_liczby(c, &wezelwsk->adres.nr_domu) &&
+         dekodowanie_liczby(c, &wezelwsk->adres.nr_mieszkania) &&
+         dekodowanie_napisu(c, wezelwsk->adres.kod_pocztowy, sizeof(wezelwsk->adres.kod_pocztowy)) &&
+         dekodowanie_napisu(c, wezelwsk->adres.miasto, sizeof(wezelwsk->adres.miasto));
+}
+
+/* wykonanie na bazie zmiany zapisanej w tresci rekordu - tymi samymi funkcjami */
+/* co w menu, wiec odtworzona baza (razem z kolejnoscia osob i znajomosci) jest */
+/* taka sama jak przed awaria; funkcja zwraca false, gdy tresc jest uszkodzona */
+/* albo zmiany nie da sie wykonac */
+bool wykonywanie_zmiany(baza *b, const unsigned char *tresc, int dlugosc)
+{
+  czytnik_rekordu c = {tresc + 1, tresc + dlugosc};
+  wezel dane, *wezelwsk, *wsk1, *wsk2;
+  int id1, id2, waga1, waga2, biezacy_id;
+
+  if(dlugosc < 1)
+    return false;
+  switch(tresc[0])
+  {
+    case ZMIANA_DODANIE_OSOBY:
+      if(!dekodowanie_liczby(&c, &id1) || !dekodowanie_liczby(&c, &biezacy_id) ||
+         !dekodowanie_napisu(&c, dane.pierwsze_imie, sizeof(dane.pierwsze_imie)) ||
+         !dekodowanie_napisu(&c, dane.drugie_imie, sizeof(dane.drugie_imie)) ||
+         !dekodowanie_napisu(&c, dane.nazwisko, sizeof(dane.nazwisko)) ||
+         !dekodowanie_adresu(&c, &dane) || znajdz_wezel(b, id1) != NULL)
+        return false;
+      b->liczba_elementow++;
+      wezelwsk = dodawanie_wezla(b, id1);
+      b->biezacy_id = biezacy_id;
+      strcpy(wezelwsk->pierwsze_imie, dane.pierwsze_imie);
+      strcpy(wezelwsk->drugie_imie, dane.drugie_imie);
+      strcpy(wezelwsk->nazwisko, dane.nazwisko);
+      wezelwsk->nr_telefonu = dane.nr_telefonu;
+      wezelwsk->adres = dane.adres;
+      dodawanie_do_indeksu_nazwisk(b, wezelwsk);
+      dodawanie_do_widokow(b, wezelwsk);
+      return true;
+    case ZMIANA_DANYCH_OSOBY:
+      if(!dekodowanie_liczby(&c, &id1) || !dekodowanie_adresu(&c, &dane) ||
+         (wezelwsk = znajdz_wezel(b, id1)) == NULL)
+        return false;
+      wezelwsk->nr_telefonu = dane.nr_telefonu;
+      wezelwsk->adres = dane.adres;
+      return true;
+    case ZMIANA_USUNIECIE_OSOBY:
+      if(!dekodowanie_liczby(&c, &id1) || usuwanie_wezla(b, id1) != 0)
+        return false;
+      b->liczba_elementow--;
+      return true;
+    case ZMIANA_DODANIE_ZNAJOMOSCI:
+      return dekodowanie_liczby(&c, &id1) && dekodowanie_liczby(&c, &id2) &&
+             dekodowanie_liczby(&c, &waga1) && dekodowanie_liczby(&c, &waga2) &&
+             (wsk1 = znajdz_wezel(b, id1)) != NULL && (wsk2 = znajdz_wezel(b, id2)) != NULL &&
+             dodawanie_krawedzi(b, wsk1, wsk2, waga1, waga2) == 0;
+    case ZMIANA_USUNIECIE_ZNAJOMOSCI:
+      return dekodowanie_liczby(&c, &id1) && dekodowanie_liczby(&c, &id2) &&
+             usuwanie_krawedzi(b, id1, id2) == 0;
+    case ZMIANA_STOPNIA_ZNAJOMOSCI:
+      return dekodowanie_liczby(&c, &id1) && dekodowanie_liczby(&c, &id2) &&
+             dekodowanie_liczby(&c, &waga1) &&
+             (wsk1 = znajdz_wezel(b, id1)) != NULL && (wsk2 = znajdz_wezel(b, id2)) != NULL &&
+             zmiana_wagi_krawedzi(b, wsk1, wsk2, waga1) == 0;
+    case ZMIANA_SORTOWANIE:
+      if(!dekodowanie_liczby(&c, &waga1) || waga1 < 1 || waga1 > 5)
+        return false;
+      if(waga1 <= 3)
+        ukladanie_wedlug_widoku(b, waga1);
+      else
+        ukladanie_wedlug_klucza(b, waga1);
+      return true;
+  }
+  return false;
+}
+
+/* wczytanie migawki, od ktorej zaczyna sie dziennik; jesli ksiazka ma inny */
+/* znacznik, a nowa migawka o znaczniku z naglowka czeka jeszcze pod nazwa */
+/* tymczasowa (awaria miedzy zamiana dziennika i zamiana migawki) to konczymy */
+/* zamiane; funkcja zwraca false, gdy zadna migawka nie pasuje do dziennika */
+bool wczytywanie_migawki(baza *b, naglowek_dziennika *naglowek)
+{
+  char nazwa_tymczasowa[272];
+
+  sprintf(nazwa_tymczasowa, "%s.tmp", naglowek->nazwa_bazy);
+  if(!zgodny_znacznik(naglowek->nazwa_bazy, &naglowek->znacznik))
+  {
+    if(!zgodny_znacznik(nazwa_tymczasowa, &naglowek->znacznik) ||
+       rename(nazwa_tymczasowa, naglowek->nazwa_bazy) == -1)
+      return false;
+    synchronizacja_katalogu(naglowek->nazwa_bazy);
+  }
+  return wczytywanie_bazy_z_pliku(b, naglowek->nazwa_bazy) != -1;
+}
+
+/* odtwarzanie bazy z pliku dziennika: migawka z naglowka i po kolei wszystkie */
+/* poprawne rekordy; dziennik zaczynajacy sie od poprzedniego dziennika (trwa jego */
+/* kompaktowanie) jest odtwarzany razem z nim; w naglowek i dlugosc funkcja */
+/* wpisuje naglowek dziennika i dlugosc jego poprawnej czesci; zwraca liczbe */
+/* wykonanych zmian, -1 gdy dziennika nie ma, -2 gdy dziennik jest uszkodzony */
+/* i -3 gdy migawka nie pasuje do dziennika (wtedy wczytujemy sama ksiazke) */
+long odtwarzanie_z_dziennika(baza *b, dziennik_zmian *d, char *nazwa_dziennika,
+                             naglowek_dziennika *naglowek, long *dlugosc)
+{
+  czytnik_tekstu c;
+  naglowek_dziennika naglowek_starego;
+  uint32_t dlugosc_tresci, suma;
+  long liczba_zmian = 0, dlugosc_starego;
+
+  if(otwieranie_czytnika(&c, nazwa_dziennika) == -1)
+    return -1;
+  if(c.rozmiar < (long)sizeof(naglowek_dziennika))
+  {
+    zamykanie_czytnika(&c);
+    return -2;
+  }
+  memcpy(naglowek, c.tekst, sizeof(naglowek_dziennika));
+  if(memcmp(naglowek->sygnatura, SYGNATURA_DZIENNIKA, 8) != 0 ||
+     naglowek->wersja != WERSJA_DZIENNIKA || naglowek->nazwa_bazy[255] != '\0')
+  {
+    zamykanie_czytnika(&c);
+    return -2;
+  }
+
+  czyszczenie_bazy(b);
+  if(naglowek->rodzaj_bazy == BAZA_Z_PLIKU && !wczytywanie_migawki(b, naglowek))
+  { /* ksiazke zmieniono poza programem - rekordow nie da sie na niej wykonac */
+    wczytywanie_bazy_z_pliku(b, d->nazwa_ksiazki);
+    zamykanie_czytnika(&c);
+    *dlugosc = sizeof(naglowek_dziennika);
+    return -3;
+  }
+  if(naglowek->rodzaj_bazy == BAZA_ZE_STAREGO_DZIENNIKA &&
+     (strcmp(nazwa_dziennika, d->nazwa_starego) == 0 ||
+      odtwarzanie_z_dziennika(b, d, d->nazwa_starego, &naglowek_starego, &dlugosc_starego) < 0))
+  { /* poprzedni dziennik zostal juz wlaczony do ksiazki */
+    czyszczenie_bazy(b);
+    wczytywanie_bazy_z_pliku(b, d->nazwa_ksiazki);
+  }
+
+  c.pozycja = c.tekst + sizeof(naglowek_dziennika);
+  while(c.koniec - c.pozycja >= 8)
+  {
+    memcpy(&dlugosc_tresci, c.pozycja, 4);
+    memcpy(&suma, c.pozycja + 4, 4);
+    if(dlugosc_tresci > ROZMIAR_REKORDU_DZIENNIKA || c.koniec - c.pozycja - 8 < (long)dlugosc_tresci ||
+       suma_kontrolna_rekordu((const unsigned char*)c.pozycja + 8, dlugosc_tresci) != suma)
+      break; /* rekord zapisany tylko czesciowo - koniec poprawnej czesci dziennika */
+    wykonywanie_zmiany(b, (const unsigned char*)c.pozycja + 8, dlugosc_tresci);
+    c.pozycja += 8 + dlugosc_tresci;
+    liczba_zmian++;
+  }
+  *dlugosc = c.pozycja - c.tekst;
+  zamykanie_czytnika(&c);
+  return liczba_zmian;
+}
+
+/* utworzenie pliku dziennika z samym naglowkiem - najpierw pod nazwa tymczasowa, */
+/* ktora po synchronizacji z dyskiem jest zamieniana na docelowa; funkcja zwraca */
+/* deskryptor pliku otwartego do dopisywania rekordow lub -1 */
+int tworzenie_dziennika(char *nazwa_pliku, naglowek_dziennika *naglowek)
+{
+  char nazwa_tymczasowa[288];
+  int plik;
+
+  sprintf(nazwa_tymczasowa, "%s.tmp", nazwa_pliku);
+  memcpy(naglowek->sygnatura, SYGNATURA_DZIENNIKA, 8);
+  naglowek->wersja = WERSJA_DZIENNIKA;
+  if((plik = open(nazwa_tymczasowa, O_RDWR | O_CREAT | O_TRUNC, 0666)) == -1)
+    return -1;
+  if(zapisywanie_bloku(plik, (char*)naglowek, sizeof(naglowek_dziennika), 0) == -1 ||
+     fsync(plik) == -1 || rename(nazwa_tymczasowa, nazwa_pliku) == -1)
+  {
+    close(plik);
+    remove(nazwa_tymczasowa);
+    return -1;
+  }
+  synchronizacja_katalogu(nazwa_pliku);
+  return plik;
+}
+
+/* watek zatwierdzajacy - zabiera wszystkie oczekujace rekordy, zapisuje je */
+/* i synchronizuje plik z dyskiem; rekordy dopisane w tym czasie trafia do */
+/* nastepnej paczki */
+void* zatwierdzanie_zmian(void *argument)
+{
+  dziennik_zmian *d = (dziennik_zmian*) argument;
+  bufor_tekstu paczka = {NULL, 0, 0}, temp;
+  long liczba_w_paczce;
+  bool blad;
+
+  pthread_mutex_lock(&d->blokada);
+  while(true)
+  {
+    while(!d->koniec && d->oczekujace.dlugosc == 0)
+      pthread_cond_wait(&d->sygnal, &d->blokada);
+    if(d->oczekujace.dlugosc == 0)
+      break;
+    temp = paczka;
+    paczka = d->oczekujace;
+    d->oczekujace = temp;
+    d->oczekujace.dlugosc = 0;
+    liczba_w_paczce = d->liczba_zapisanych;
+    d->zapis_trwa = true;
+    pthread_mutex_unlock(&d->blokada);
+
+    blad = zapisywanie_bloku(d->plik, paczka.dane, paczka.dlugosc, d->rozmiar_zatwierdzony) == -1 ||
+           fdatasync(d->plik) == -1;
+
+    pthread_mutex_lock(&d->blokada);
+    d->zapis_trwa = false;
+    d->blad_zapisu |= blad;
+    d->rozmiar_zatwierdzony += paczka.dlugosc;
+    d->liczba_zatwierdzonych = liczba_w_paczce;
+    paczka.dlugosc = 0;
+    pthread_cond_broadcast(&d->zatwierdzono);
+  }
+  pthread_mutex_unlock(&d->blokada);
+  free(paczka.dane);
+  return NULL;
+}
+
+/* czekanie az wszystkie dopisane rekordy zostana zapisane na dysku; */
+/* zwraca -1, gdy zapis dziennika sie nie powiodl */
+int oczekiwanie_na_zatwierdzenie(dziennik_zmian *d)
+{
+  bool blad;
+
+  if(d->plik == -1)
+    return 0;
+  pthread_mutex_lock(&d->blokada);
+  while(d->liczba_zatwierdzonych < d->liczba_zapisanych || d->zapis_trwa)
+    pthread_cond_wait(&d->zatwierdzono, &d->blokada);
+  blad = d->blad_zapisu;
+  pthread_mutex_unlock(&d->blokada);
+  return blad? -1 : 0;
+}
+
+/* dolaczenie watku kompaktowania, jesli jakis jeszcze pracuje lub skonczyl prace */
+void konczenie_kompaktowania(dziennik_zmian *d)
+{
+  if(!d->kompaktowanie_trwa)
+    return;
+  pthread_join(d->watek_kompaktowania, NULL);
+  d->kompaktowanie_trwa = false;
+  if(d->wynik_kompaktowania == -1)
+    printf("blad, nie udalo sie wlaczyc dziennika zmian do pliku %s\n", d->nazwa_ksiazki);
+}
+
+/* zamiana pliku dziennika na nowy o podanym naglowku, gdy wszystkie rekordy sa */
+/* juz zatwierdzone (kolejne rekordy trafia do nowego pliku); zwraca -1, gdy */
+/* nowego dziennika nie udalo sie utworzyc - wtedy dziennik jest wylaczany, a watek */
+/* zatwierdzajacy czeka bezczynnie na zamkniecie dziennika */
+int zamiana_dziennika(dziennik_zmian *d, naglowek_dziennika *naglowek, bool zachowanie_starego)
+{
+  int plik;
+
+  oczekiwanie_na_zatwierdzenie(d);
+  pthread_mutex_lock(&d->blokada);
+  if(zachowanie_starego && rename(d->nazwa_dziennika, d->nazwa_starego) == -1)
+  {
+    pthread_mutex_unlock(&d->blokada);
+    return -1;
+  }
+  plik = tworzenie_dziennika(d->nazwa_dziennika, naglowek);
+  close(d->plik);
+  d->plik = plik;
+  d->rozmiar = d->rozmiar_zatwierdzony = sizeof(naglowek_dziennika);
+  d->blad_zapisu = false;
+  pthread_mutex_unlock(&d->blokada);
+  if(plik == -1)
+  {
+    printf("blad, nie udalo sie utworzyc dziennika zmian %s - zmiany beda zapisywane "
+           "tylko przy zapisywaniu bazy\n", d->nazwa_dziennika);
+    return -1;
+  }
+  return 0;
+}
+
+/* kompaktowanie w tle: baza odtworzona z poprzedniego dziennika (w osobnej */
+/* pamieci, wiec menu moze dalej zmieniac wlasna baze) jest zapisywana jako nowa */
+/* migawka; kolejnosc krokow jest taka, ze po awarii w dowolnym momencie baza */
+/* odtworzona z plikow jest poprawna: nowa migawka pod nazwa tymczasowa, naglowek */
+/* biezacego dziennika wskazujacy nowa migawke, zamiana migawki z ksiazka i dopiero */
+/* na koncu usuniecie poprzedniego dziennika */
+void* kompaktowanie_dziennika(void *argument)
+{
+  dziennik_zmian *d = (dziennik_zmian*) argument;
+  naglowek_dziennika naglowek;
+  long dlugosc;
+  baza b;
+
+  inicjalizacja_bazy(&b);
+  d->wynik_kompaktowania = -1;
+  if(odtwarzanie_z_dziennika(&b, d, d->nazwa_starego, &naglowek, &dlugosc) >= 0 &&
+     zapisywanie_bazy_do_pliku(&b, d->nazwa_migawki) != -1 &&
+     synchronizacja_pliku(d->nazwa_migawki) != -1)
+  {
+    memset(&naglowek, 0, sizeof(naglowek));
+    memcpy(naglowek.sygnatura, SYGNATURA_DZIENNIKA, 8);
+    naglowek.wersja = WERSJA_DZIENNIKA;
+    naglowek.rodzaj_bazy = BAZA_Z_PLIKU;
+    strcpy(naglowek.nazwa_bazy, d->nazwa_ksiazki);
+    /* naglowek biezacego dziennika zmieniamy w miejscu - rekordy sa dopisywane */
+    /* dalej, wiec ten sam deskryptor moze w tym czasie uzywac watek zatwierdzajacy */
+    if(pobieranie_znacznika(d->nazwa_migawki, &naglowek.znacznik) &&
+       zapisywanie_bloku(d->plik, (char*)&naglowek, sizeof(naglowek), 0) != -1 &&
+       fdatasync(d->plik) != -1 && rename(d->nazwa_migawki, d->nazwa_ksiazki) != -1)
+    {
+      synchronizacja_katalogu(d->nazwa_ksiazki);
+      remove(d->nazwa_starego);
+      synchronizacja_katalogu(d->nazwa_starego);
+      d->wynik_kompaktowania = 0;
+    }
+  }
+  czyszczenie_bazy(&b);
+  pthread_mutex_lock(&d->blokada);
+  d->kompaktowanie_zakonczone = true;
+  pthread_mutex_unlock(&d->blokada);
+  return NULL;
+}
+
+/* rozpoczecie kompaktowania poprzedniego dziennika w tle */
+void uruchamianie_kompaktowania(dziennik_zmian *d)
+{
+  d->kompaktowanie_trwa = true;
+  d->kompaktowanie_zakonczone = false;
+  pthread_create(&d->watek_kompaktowania, NULL, kompaktowanie_dziennika, d);
+}
+
+/* zamiana dziennika na nowy i kompaktowanie poprzedniego w tle, gdy dziennik */
+/* przekroczyl PROG_KOMPAKTOWANIA bajtow (jesli poprzednie kompaktowanie jeszcze */
+/* trwa, to czekamy z tym do kolejnej zmiany) */
+void sprawdzanie_rozmiaru_dziennika(dziennik_zmian *d)
+{
+  naglowek_dziennika naglowek;
+  bool zakonczone;
+
+  if(d->rozmiar < PROG_KOMPAKTOWANIA)
+    return;
+  if(d->kompaktowanie_trwa)
+  {
+    pthread_mutex_lock(&d->blokada);
+    zakonczone = d->kompaktowanie_zakonczone;
+    pthread_mutex_unlock(&d->blokada);
+    if(!zakonczone)
+      return;
+    konczenie_kompaktowania(d);
+  }
+  /* nieudane kompaktowanie - poprzedni dziennik zostaje do nastepnego uruchomienia */
+  if(access(d->nazwa_starego, F_OK) == 0)
+    return;
+  memset(&naglowek, 0, sizeof(naglowek));
+  naglowek.rodzaj_bazy = BAZA_ZE_STAREGO_DZIENNIKA;
+  if(zamiana_dziennika(d, &naglowek, true) == -1)
+    return;
+  uruchamianie_kompaktowania(d);
+}
+
+/* dopisanie rekordu do dziennika (jesli jest wlaczony) */
+void dopisywanie_rekordu(dziennik_zmian *d, rekord_dziennika *rekord)
+{
+  uint32_t dlugosc = rekord->dlugosc, suma = suma_kontrolna_rekordu(rekord->dane, rekord->dlugosc);
+
+  if(d->plik == -1)
+    return;
+  pthread_mutex_lock(&d->blokada);
+  rezerwowanie_bufora(&d->oczekujace, 8 + dlugosc);
+  memcpy(d->oczekujace.dane + d->oczekujace.dlugosc, &dlugosc, 4);
+  memcpy(d->oczekujace.dane + d->oczekujace.dlugosc + 4, &suma, 4);
+  memcpy(d->oczekujace.dane + d->oczekujace.dlugosc + 8, rekord->dane, dlugosc);
+  d->oczekujace.dlugosc += 8 + dlugosc;
+  d->rozmiar += 8 + dlugosc;
+  d->liczba_zapisanych++;
+  pthread_cond_signal(&d->sygnal);
+  pthread_mutex_unlock(&d->blokada);
+
+  if(d->czekanie_na_zapis && oczekiwanie_na_zatwierdzenie(d) == -1)
+    printf("blad, nie udalo sie zapisac zmiany w dzienniku %s\n", d->nazwa_dziennika);
+  sprawdzanie_rozmiaru_dziennika(d);
+}
+
+void rejestrowanie_dodania_osoby(dziennik_zmian *d, baza *b, wezel *nowy)
+{
+  rekord_dziennika rekord = {{ZMIANA_DODANIE_OSOBY}, 1};
+
+  kodowanie_liczby(&rekord, nowy->id);
+  kodowanie_liczby(&rekord, b->biezacy_id);
+  kodowanie_napisu(&rekord, nowy->pierwsze_imie);
+  kodowanie_napisu(&rekord, nowy->drugie_imie);
+  kodowanie_napisu(&rekord, nowy->nazwisko);
+  kodowanie_adresu(&rekord, nowy);
+  dopisywanie_rekordu(d, &rekord);
+}
+
+void rejestrowanie_zmiany_danych_osoby(dziennik_zmian *d, wezel *wezelwsk)
+{
+  rekord_dziennika rekord = {{ZMIANA_DANYCH_OSOBY}, 1};
+
+  kodowanie_liczby(&rekord, wezelwsk->id);
+  kodowanie_adresu(&rekord, wezelwsk);
+  dopisywanie_rekordu(d, &rekord);
+}
+
+/* zmiana o argumentach liczbowych (usuniecie osoby, zmiany znajomosci, sortowanie) */
+void rejestrowanie_zmiany(dziennik_zmian *d, int rodzaj, int liczba_argumentow, int *argumenty)
+{
+  rekord_dziennika rekord = {{0}, 1};
+  int i;
+
+  rekord.dane[0] = (unsigned char) rodzaj;
+  for(i = 0; i < liczba_argumentow; i++)
+    kodowanie_liczby(&rekord, argumenty[i]);
+  dopisywanie_rekordu(d, &rekord);
+}
+
+/* zapisanie calej bazy jako nowej migawki i rozpoczecie pustego dziennika: */
+/* migawka pod nazwa tymczasowa, nowy dziennik wskazujacy te migawke i dopiero */
+/* wtedy zamiana migawki z ksiazka (po awarii miedzy zamianami odtwarzanie konczy */
+/* zamiane); zwraca liczbe zapisanych bajtow lub -1 */
+long zapisywanie_migawki(dziennik_zmian *d, baza *b)
+{
+  naglowek_dziennika naglowek;
+  long rozmiar;
+
+  if(d->plik == -1)
+    return zapisywanie_bazy_do_pliku(b, d->nazwa_ksiazki);
+  konczenie_kompaktowania(d);
+  if((rozmiar = zapisywanie_bazy_do_pliku(b, d->nazwa_migawki)) == -1 ||
+     synchronizacja_pliku(d->nazwa_migawki) == -1)
+    return -1;
+  memset(&naglowek, 0, sizeof(naglowek));
+  naglowek.rodzaj_bazy = BAZA_Z_PLIKU;
+  strcpy(naglowek.nazwa_bazy, d->nazwa_ksiazki);
+  pobieranie_znacznika(d->nazwa_migawki, &naglowek.znacznik);
+  zamiana_dziennika(d, &naglowek, false);
+  if(rename(d->nazwa_migawki, d->nazwa_ksiazki) == -1)
+    return -1;
+  remove(d->nazwa_starego);
+  synchronizacja_katalogu(d->nazwa_ksiazki);
+  return rozmiar;
+}
+
+/* po wczytaniu bazy z pliku dziennik zaczyna sie od nowa od tego pliku */
+void zmiana_bazy_dziennika(dziennik_zmian *d, char *nazwa_pliku)
+{
+  naglowek_dziennika naglowek;
+
+  if(d->plik == -1)
+    return;
+  konczenie_kompaktowania(d);
+  memset(&naglowek, 0, sizeof(naglowek));
+  naglowek.rodzaj_bazy = BAZA_Z_PLIKU;
+  strncpy(naglowek.nazwa_bazy, nazwa_pliku, sizeof(naglowek.nazwa_bazy)-1);
+  pobieranie_znacznika(nazwa_pliku, &naglowek.znacznik);
+  zamiana_dziennika(d, &naglowek, false);
+  remove(d->nazwa_starego);
+}
+
+/* otwarcie dziennika ksiazki o podanej nazwie przy starcie programu - jesli */
+/* dziennik istnieje to baza jest z niego odtwarzana, w przeciwnym przypadku */
+/* wczytujemy istniejaca ksiazke i zaczynamy nowy dziennik od niej jako migawki */
+/* (baza jest pusta tylko wtedy, gdy ksiazki nie ma); przerwane kompaktowanie */
+/* jest wznawiane w tle; funkcja zwraca liczbe odtworzonych zmian lub -1, gdy */
+/* dziennika nie bylo (albo nie udalo sie go utworzyc) */
+long otwieranie_dziennika(dziennik_zmian *d, baza *b, char *nazwa_ksiazki)
+{
+  naglowek_dziennika naglowek;
+  long liczba_zmian, dlugosc;
+  bool ksiazka_wczytana;
+
+  memset(d, 0, sizeof(dziennik_zmian));
+  strncpy(d->nazwa_ksiazki, nazwa_ksiazki, sizeof(d->nazwa_ksiazki)-1);
+  sprintf(d->nazwa_dziennika, "%s.dziennik", d->nazwa_ksiazki);
+  sprintf(d->nazwa_starego, "%s.dziennik.stary", d->nazwa_ksiazki);
+  sprintf(d->nazwa_migawki, "%s.tmp", d->nazwa_ksiazki);
+  d->plik = -1;
+  d->czekanie_na_zapis = true;
+  pthread_mutex_init(&d->blokada, NULL);
+  pthread_cond_init(&d->sygnal, NULL);
+  pthread_cond_init(&d->zatwierdzono, NULL);
+
+  /* awaria w czasie zamiany dziennika na nowy przy kompaktowaniu */
+  if(access(d->nazwa_dziennika, F_OK) == -1 && access(d->nazwa_starego, F_OK) == 0)
+    rename(d->nazwa_starego, d->nazwa_dziennika);
+  liczba_zmian = odtwarzanie_z_dziennika(b, d, d->nazwa_dziennika, &naglowek, &dlugosc);
+  if(liczba_zmian == -3)
+    printf("blad, plik %s zmieniono poza programem - pominieto dziennik zmian\n",
+           naglowek.nazwa_bazy);
+  if(liczba_zmian >= 0 && (d->plik = open(d->nazwa_dziennika, O_RDWR)) != -1)
+  { /* odcinamy rekord zapisany tylko czesciowo */
+    if(ftruncate(d->plik, dlugosc) == -1)
+      printf("blad, nie udalo sie naprawic dziennika zmian %s\n", d->nazwa_dziennika);
+    d->rozmiar = d->rozmiar_zatwierdzony = dlugosc;
+  }
+  else
+  {
+    if(liczba_zmian == -2)
+      printf("blad, dziennik zmian %s jest uszkodzony - zaczynamy nowy\n", d->nazwa_dziennika);
+    /* nowy dziennik zaczyna sie od istniejacej ksiazki (przy -3 juz wczytanej) - */
+    /* gdyby zaczynal sie od pustej bazy, to zapisanie bazy albo kompaktowanie */
+    /* nadpisaloby ksiazke, ktorej uzytkownik nie wczytal */
+    ksiazka_wczytana = (liczba_zmian == -3);
+    if(!ksiazka_wczytana)
+    {
+      czyszczenie_bazy(b);
+      ksiazka_wczytana = (wczytywanie_bazy_z_pliku(b, d->nazwa_ksiazki) != -1);
+    }
+    memset(&naglowek, 0, sizeof(naglowek));
+    if(ksiazka_wczytana && pobieranie_znacznika(d->nazwa_ksiazki, &naglowek.znacznik))
+    {
+      naglowek.rodzaj_bazy = BAZA_Z_PLIKU;
+      strcpy(naglowek.nazwa_bazy, d->nazwa_ksiazki);
+    }
+    else
+    {
+      czyszczenie_bazy(b);
+      naglowek.rodzaj_bazy = BAZA_PUSTA;
+    }
+    /* pusta migawka przy ksiazce, ktorej nie udalo sie wczytac, skonczylaby sie */
+    /* nadpisaniem jej przy kompaktowaniu - wtedy nie tworzymy dziennika */
+    if(naglowek.rodzaj_bazy == BAZA_PUSTA && access(d->nazwa_ksiazki, F_OK) == 0)
+    {
+      printf("blad, nie udalo sie wczytac ksiazki %s - dziennik zmian nie zostanie "
+             "utworzony\n", d->nazwa_ksiazki);
+      d->plik = -1;
+    }
+    else if((d->plik = tworzenie_dziennika(d->nazwa_dziennika, &naglowek)) == -1)
+      printf("blad, nie udalo sie utworzyc dziennika zmian - zmiany beda zapisywane "
+             "tylko przy zapisywaniu bazy\n");
+    d->rozmiar = d->rozmiar_zatwierdzony = sizeof(naglowek_dziennika);
+    liczba_zmian = -1;
+  }
+  remove(d->nazwa_migawki); /* migawka niedokonczona przed awaria */
+  if(d->plik == -1)
+    return -1;
+  if(pthread_create(&d->watek_zatwierdzania, NULL, zatwierdzanie_zmian, d) != 0)
+  {
+    printf("blad, nie udalo sie uruchomic zapisu dziennika zmian - zmiany beda zapisywane "
+           "tylko przy zapisywaniu bazy\n");
+    close(d->plik);
+    d->plik = -1;
+    return -1;
+  }
+  d->zatwierdzanie_trwa = true;
+  if(naglowek.rodzaj_bazy == BAZA_ZE_STAREGO_DZIENNIKA && access(d->nazwa_starego, F_OK) == 0)
+    uruchamianie_kompaktowania(d);
+  else
+    remove(d->nazwa_starego);
+  return liczba_zmian;
+}
+
+/* zatwierdzenie wszystkich rekordow, zakonczenie watkow i zamkniecie dziennika */
+void zamykanie_dziennika(dziennik_zmian *d)
+{
+  oczekiwanie_na_zatwierdzenie(d);
+  if(d->zatwierdzanie_trwa)
+  {
+    pthread_mutex_lock(&d->blokada);
+    d->koniec = true;
+    pthread_cond_signal(&d->sygnal);
+    pthread_mutex_unlock(&d->blokada);
+    pthread_join(d->watek_zatwierdzania, NULL);
+    d->zatwierdzanie_trwa = false;
+  }
+  konczenie_kompaktowania(d);
+  if(d->plik != -1)
+  {
+    close(d->plik);
+    d->plik = -1;
+  }
+  free(d->oczekujace.dane);
+  pthread_mutex_destroy(&d->blokada);
+  pthread_cond_destroy(&d->sygnal);
+  pthread_cond_destroy(&d->zatwierdzono);
+}
+
+/********************* operacje na ksiazce adresowej ***********************/
+
+void wczytywanie_bazy(baza *b, dziennik_zmian *d)
+{
+  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  int wybor;
+  long rozmiar;
+  double czas;
+  char *nazwa_pliku;
+  char *tekst =
+  "Nacisnij klawisz 1 lub 2\n"
+  "1 - wczytywanie przykladowej bazy z pliku\n"
+  "2 - wczytywanie bazy zapisanej wczesniej przez uzytkownika (z pliku)\n";
+
+  wczytywanie(tekst, kryterium3, 'i', &wybor);
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+
+  printf("Wczytywanie bazy...\n");
+  czas = czas_zegarowy();
+  nazwa_pliku = (wybor == 1)? "przykladowa_baza.txt" : "ksiazka_adresowa.txt";
+  rozmiar = wczytywanie_bazy_z_pliku(b, nazwa_pliku);
+  if(rozmiar == -1)
+  {
+    printf("blad, nie znaleziono pliku zawierajacego ksiazke adresowa\n");
+    return ;
+  }
+  czas = czas_zegarowy() - czas;
+  zmiana_bazy_dziennika(d, nazwa_pliku);
+  printf("Wczytano %.2f MB (%.1f MB/s)\n", rozmiar/1e6, (czas > 0)? rozmiar/1e6/czas : 0);
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+}
+
+void zapisywanie_bazy(baza *b, dziennik_zmian *d)
+{
+  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  long rozmiar;
+  double czas;
+
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Zapisywanie bazy do pliku ksiazka_adresowa.txt\n");
+  czas = czas_zegarowy();
+  if((rozmiar = zapisywanie_migawki(d, b)) == -1)
+  {
+    printf("blad, nie udalo sie utworzyc pliku ksiazka_adresowa.txt\n");
+    return ;
+  }
+  czas = czas_zegarowy() - czas;
+  printf("Zapisano %.2f MB (%.1f MB/s)\n", rozmiar/1e6, (czas > 0)? rozmiar/1e6/czas : 0);
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+}
+
+/* dodanie osoby o danych zapisanych w wezle dane (imiona, nazwisko, numer */
+/* telefonu i adres) - jesli osoba o tym imieniu i nazwisku istnieje juz */
+/* w ksiazce, to aktualizujemy tylko jej adres i numer telefonu; funkcja */
+/* zwraca wezel osoby, a w *nowa - czy osoba zostala dodana */
+wezel* dopisywanie_osoby(baza *b, dziennik_zmian *d, wezel *dane, bool *nowa)
+{
+  wezel *wezelwsk;
+
+  /* sprawdzanie czy osoba o danym imieniu i nazwisku
+  nie istnieje juz w bazie */
+  if((wezelwsk = znajdz_osobe(b, dane->pierwsze_imie, dane->nazwisko)) != NULL)
+  {
+    /* przepisywanie danych*/
+    wezelwsk->nr_telefonu = dane->nr_telefonu;
+    wezelwsk->adres = dane->adres;
+    rejestrowanie_zmiany_danych_osoby(d, wezelwsk);
+    *nowa = false;
+    return wezelwsk;
+  }
+  /* osoba nie istnieje w bazie  */
+  b->liczba_elementow++;
+  wezelwsk = dodawanie_wezla(b, b->biezacy_id);
+  b->biezacy_id = (b->biezacy_id+1) % INT_MAX;
+  /* przepisywanie danych*/
+  strcpy(wezelwsk->pierwsze_imie, dane->pierwsze_imie);
+  strcpy(wezelwsk->drugie_imie, dane->drugie_imie);
+  strcpy(wezelwsk->nazwisko, dane->nazwisko);
+  wezelwsk->nr_telefonu = dane->nr_telefonu;
+  wezelwsk->adres = dane->adres;
+  dodawanie_do_indeksu_nazwisk(b, wezelwsk);
+  dodawanie_do_widokow(b, wezelwsk);
+  rejestrowanie_dodania_osoby(d, b, wezelwsk);
+  *nowa = true;
+  return wezelwsk;
+}
+
+/* wszystkie wczytane dane trzymamy na poczatku w zmiennych lokalnych funkcji
+   potem przepisujemy je do ksiazki adresowej */
+void dodawanie_osoby(baza *b, dziennik_zmian *d)
+{
+  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  int wybor;
+  char pierwsze_imie[32], drugie_imie[32],
+  nazwisko[32], ulica[32], miasto[32];
+  char kod_pocztowy[7];
+  int nr_telefonu, nr_domu, nr_mieszkania;
+  char* napis1 = "Podaj pierwsze imie\n";
+  char* napis2 = "Nacisnij klawisz\n1 - tak\n2 - nie\n";
+  char* napis3 = "Podaj drugie imie\n";
+  char* napis4 = "Podaj nazwisko\n";
+  char* napis5 = "Podaj numer telefonu\n";
+  char* napis6 = "Podaj nazwe ulicy\n";
+  char* napis7 = "Podaj numer domu\n";
+  char* napis8 = "Podaj numer mieszkania\n";
+  char* napis9 = "Podaj kod pocztowy w formacie \"01-234\"\n";
+  char* napis10 = "Podaj miasto\n";
+  wezel dane;
+  bool nowa;
+
+  printf("dodawanie nowej pozycji\n");
+
+  wczytywanie(napis1, kryterium_napisowe, 's', pierwsze_imie);
+
+  printf("Czy dana osoba ma drugie imie?\n");
+  wczytywanie(napis2, kryterium3, 'i', &wybor);
+  if(wybor == 1)
+    wczytywanie(napis3, kryterium_napisowe, 's', drugie_imie);
+  else
+    strcpy(drugie_imie, "_");
+
+  wczytywanie(napis4, kryterium_napisowe, 's', nazwisko);
+  wczytywanie(napis5, kryterium_liczbowe, 'i', &nr_telefonu);
+  // ---------- wczytywanie adresu  ---------- //
+  wczytywanie(napis6, kryterium_napisowe, 's', ulica);
+  wczytywanie(napis7, kryterium_liczbowe, 'i', &nr_domu);
+  wczytywanie(napis8, kryterium_liczbowe, 'i', &nr_mieszkania);
+  wczytywanie(napis9, kryterium_kod_pocztowy, 's', kod_pocztowy);
+  wczytywanie(napis10, kryterium_napisowe, 's', miasto);
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+
+  strcpy(dane.pierwsze_imie, pierwsze_imie);
+  strcpy(dane.drugie_imie, drugie_imie);
+  strcpy(dane.nazwisko, nazwisko);
+  dane.nr_telefonu = nr_telefonu;
+  strcpy(dane.adres.ulica, ulica);
+  dane.adres.nr_domu = nr_domu;
+  dane.adres.nr_mieszkania = nr_mieszkania;
+  strcpy(dane.adres.kod_pocztowy, kod_pocztowy);
+  strcpy(dane.adres.miasto, miasto);
+  dopisywanie_osoby(b, d, &dane, &nowa);
+  if(!nowa)
+  {
+    printf("Osoba o danym imieniu i nazwisku istnieje juz w ksiazce adresowej\n");
+    printf("Aktualizacja adresu i numeru telefonu\n");
+    return ;
+  }
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+}
+
+void usuwanie_osoby(baza *b, dziennik_zmian *d)
+{
+  int id = -1;
+  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  char* napis = "Podaj identyfikator osoby ktora chcesz usunac z bazy\n";
+  wezel *usuwany;
+
+  wczytywanie(napis, kryterium_liczbowe, 'i', &id);
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+
+  /* sprawdzanie czy osoba o podanym id istnieje w bazie */
+  if((usuwany = znajdz_wezel(b, id)) == NULL)
+    printf("Osoba o danym identyfikatorze nie wsytepuje w bazie\n");
+  else
+  {/* osoba o podanym przez uzytkownika id istnieje w bazie */
+    usuwanie_wezla(b, id);
+    b->liczba_elementow--;
+    rejestrowanie_zmiany(d, ZMIANA_USUNIECIE_OSOBY, 1, &id);
+    printf("Osoba usunieta\n");
+  }
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+}
+
+void sortowanie(baza *b, dziennik_zmian *d)
+{
+  int wybor;
+  clock_t poczatek, koniec;/* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  char *napis =
+  "Nacisnij klawisz 1, 2, 3, 4 lub 5\n"
+  "1 - sortowanie po identyfikatorach\n"
+  "2 - sortowanie po pierwszych imionach\n"
+  "3 - sortowanie po nazwiskach\n"
+  "4 - sortowanie po numerach telefonu\n"
+  "5 - sortowanie po kodach pocztowych\n";
+
+  if(b->liczba_elementow == 0)
+  {
+    printf("Baza jest pusta, brak poztcji do sortowania\n");
+    return ;
+  }
+  wczytywanie(napis, kryterium2, 'i', &wybor);
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Sortowanie...\n");
+  /* kolejnosc osob wedlug id, imion i nazwisk jest juz w widoku wybranego */
+  /* trybu - tylko ukladamy liste; numery telefonu i kody sortujemy pozycyjnie */
+  if(wybor <= 3)
+    ukladanie_wedlug_widoku(b, wybor);
+  else
+    ukladanie_wedlug_klucza(b, wybor);
+  rejestrowanie_zmiany(d, ZMIANA_SORTOWANIE, 1, &wybor);
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+}
+
+/* wypisywanie bazy w kolejnosci nazwisk - osoby sa czytane z widoku wedlug */
+/* nazwisk, wiec nie trzeba ich sortowac, a kolejnosc osob w bazie sie nie zmienia */
+void wypisywanie_bazy(baza *b)
+{
+  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+  int tryb = 3;
+
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+
+  printf("Wypisywanie bazy posortowanej wzgledem nazwisk osob:\n");
+  wezelwsk = pierwszy_w_widoku(b, tryb);
+  while(wezelwsk != NULL)
+  {
+    printf("Id = %d\nImiona: %s %s, Nazwisko: %s\n", wezelwsk->id,
+      wezelwsk->pierwsze_imie, wezelwsk->drugie_imie, wezelwsk->nazwisko);
+    printf("Adres:\n");
+    printf("ulica %s %d/%d, kod pocztowy: %s, miasto: %s\n",
+      wezelwsk->adres.ulica, wezelwsk->adres.nr_domu, wezelwsk->adres.nr_mieszkania,
+      wezelwsk->adres.kod_pocztowy, wezelwsk->adres.miasto);
+    printf("nr telefonu: %d\n\n", wezelwsk->nr_telefonu);
+    printf("Znajomi osoby:\n");
+    krawedzwsk = wezelwsk->pierwszy;
+    while(krawedzwsk != NULL)
+    {
+      printf("id %d, %s %s, stopien znajomosci: %d\n", krawedzwsk->cel->id,
+        krawedzwsk->cel->pierwsze_imie, krawedzwsk->cel->nazwisko, krawedzwsk->waga);
+      krawedzwsk = krawedzwsk->nastepny;
+    }
+    printf("\n");
+    wezelwsk = nastepny_w_widoku(wezelwsk, tryb);
+  }
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+}
+
+void dodawanie_znajomosci(baza *b, dziennik_zmian *d)
+{
+  int id1, id2, wynik, stopien_znajomosci1, stopien_znajomosci2;
+  int argumenty[4];
+  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  char* napis1 = "Podaj identyfikator pierwszej osoby\n";
+  char* napis2 = "Podaj identyfikator drugiej osoby\n";
+  char* napis3 = "Podaj stopien w jakim pierwsza osoba zna osobe druga\n";
+  char* napis4 = "Podaj stopien w jakim druga osoba zna osobe pierwsza\n";
+  wezel *wsk1, *wsk2;
+
+  printf("Dodawanie znajomosci miedzy dwiema osobami\n");
+
+  wczytywanie(napis1, kryterium_liczbowe, 'i', &id1);
+  if((wsk1 = znajdz_wezel(b, id1)) == NULL)
+  {
+    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
+    return ;
+  }
+  wczytywanie(napis2, kryterium_liczbowe, 'i', &id2);
+  if((wsk2 = znajdz_wezel(b, id2)) == NULL)
+  {
+    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
+    return ;
+  }
+  if(id1 == id2)
+  {
+    printf("Identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej\n");
+    printf("Funkcja dodaje znajomosc miedzy dwoma roznymi osobami\n");
+    return ;
+  }
+
+  wczytywanie(napis3, kryterium_wagowe, 'i', &stopien_znajomosci1);
+  wczytywanie(napis4, kryterium_wagowe, 'i', &stopien_znajomosci2);
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+
+  wynik = dodawanie_krawedzi(b, wsk1, wsk2,
+            stopien_znajomosci1, stopien_znajomosci2);
+
+  if(wynik == -2)
+    printf("Znajomosc miedzy danymi osobami zostala dodana juz wczesniej\n");
+  else
+    printf("Znajomosc zostala dodana\n");
+  if(wynik == 0)
+  {
+    argumenty[0] = id1;
+    argumenty[1] = id2;
+    argumenty[2] = stopien_znajomosci1;
+    argumenty[3] = stopien_znajomosci2;
+    rejestrowanie_zmiany(d, ZMIANA_DODANIE_ZNAJOMOSCI, 4, argumenty);
+  }
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+}
+
+void usuwanie_znajomosci(baza *b, dziennik_zmian *d)
+{
+  int id1, id2, wynik;
+  int argumenty[2];
+  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  char* napis1 = "Podaj identyfikator pierwszej osoby\n";
+  char* napis2 = "Podaj identyfikator drugiej osoby\n";
+  wezel *wsk1, *wsk2;
+
+  printf("Usuwanie znajomosci miedzy dwiema osobami\n");
+
+  wczytywanie(napis1, kryterium_liczbowe, 'i', &id1);
+  if((wsk1 = znajdz_wezel(b, id1)) == NULL)
+  {
+    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
+    return ;
+  }
+  wczytywanie(napis2, kryterium_liczbowe, 'i', &id2);
+  if((wsk2 = znajdz_wezel(b, id2)) == NULL)
+  {
+    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
+    return ;
+  }
+  if(id1 == id2)
+  {
+    printf("Identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej\n");
+    printf("Funkcja usuwa znajomosc miedzy dwoma roznymi osobami\n");
+    return ;
+  }
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+
+  wynik = usuwanie_krawedzi(b, id1, id2);
+
+  if(wynik == -2)
+    printf("Miedzy danymi osobami nie istniala znajomosc\n");
+  else
+    printf("Znajomosc zostala usunieta\n");
+  if(wynik == 0)
+  {
+    argumenty[0] = id1;
+    argumenty[1] = id2;
+    rejestrowanie_zmiany(d, ZMIANA_USUNIECIE_ZNAJOMOSCI, 2, argumenty);
+  }
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+}
+
+void zmiana_stopnia_znajomosci(baza *b, dziennik_zmian *d)
+{
+  int id1, id2, stopien_znajomosci;
+  int argumenty[3];
+  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  char* napis1 = "Podaj identyfikator pierwszej osoby\n";
+  char* napis2 = "Podaj identyfikator drugiej osoby\n";
+  char* napis3 = "Podaj stopien w jakim pierwsza osoba zna osobe druga\n";
+  wezel *wsk1, *wsk2;
+
+  printf("Zmiana stopnia znajomosci w jakim osoba pierwsza zna druga\n");
 
   wczytywanie(napis1, kryterium_liczbowe, 'i', &id1);
   if((wsk1 = znajdz_wezel(b, id1)) == NULL)
@@ -1159,199 +5116,1119 @@ void dodawanie_znajomosci(baza *b)
     return ;
   }
   wczytywanie(napis2, kryterium_liczbowe, 'i', &id2);
+
+  if((wsk2 = znajdz_wezel(b, id2)) == NULL)
+  {
+    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
+    return ;
+  }
+
+  if(id1 == id2)
+  {
+    printf("Identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej\n");
+    printf("Funkcja zmienia stopien znajomosci miedzy dwoma roznymi osobami\n");
+    return ;
+  }
+
+  wczytywanie(napis3, kryterium_wagowe, 'i', &stopien_znajomosci);
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+
+  if(zmiana_wagi_krawedzi(b, wsk1, wsk2, stopien_znajomosci) == -1)
+    printf("Osoby o podanych identyfikatorach nie znaja sie\n");
+  else
+  {
+    argumenty[0] = id1;
+    argumenty[1] = id2;
+    argumenty[2] = stopien_znajomosci;
+    rejestrowanie_zmiany(d, ZMIANA_STOPNIA_ZNAJOMOSCI, 3, argumenty);
+    printf("stopien znajomosci zmieniony\n");
+  }
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+}
+
+/* rekurencyjna funkcja wypisujaca sciezke od wezla zrodlowego do wezla */
+/* docelowego za pomoca pola "poprzednik" stanow wezlow w kontekscie wyszukiwania */
+void wypisywanie_najkrotszej_sciezki(graf *g, kontekst_wyszukiwania *kontekst, wezel *wezelwsk)
+{
+  int poprzednik = kontekst->stany[wezelwsk->slot].poprzednik;
+
+  if(poprzednik < 0)
+    printf("id %d %s %s\n", wezelwsk->id,
+      wezelwsk->pierwsze_imie, wezelwsk->nazwisko);
+  else
+  {
+    wypisywanie_najkrotszej_sciezki(g, kontekst, g->sloty[poprzednik]);
+    printf("id %d %s %s\n", wezelwsk->id,
+      wezelwsk->pierwsze_imie, wezelwsk->nazwisko);
+  }
+}
+
+/* funkcja szukajaca najszybszej sciezki (za pomoca dwukierunkowego przeszukiwania */
+/* wszerz) lub najskuteczniejszej sciezki (za pomoca algorytmu Dijkstry) */
+/* dane wyszukiwania sa przechowywane w kontekscie, ktory moze byc uzyty wielokrotnie */
+void najkrotsza_sciezka(baza *b, kontekst_wyszukiwania *kontekst)
+{
+  int id1, id2, tryb;
+  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
+  char* napis1 = "Nacisnij klawisz 1 lub 2\n"
+  "1 - Wyszukiwanie najszybszego sposobu na nawiazanie znajomosci\n"
+  "miedzy dwoma osobami (najmniejsza liczba posrednikow)\n"
+  "2 - Wyszukiwanie najskuteczniejszego sposobu na nawiazanie znajomosci\n"
+  "miedzy dwoma osobami (poprzez osoby, ktore sie najbardziej znaja)\n";
+  char* napis2 = "Podaj identyfikator pierwszej osoby\n";
+  char* napis3 = "Podaj identyfikator drugiej osoby\n";
+  wezel *wsk1, *wsk2, *wezelwsk;
+
+  wczytywanie(napis1, kryterium3, 'i', &tryb);
+
+  wczytywanie(napis2, kryterium_liczbowe, 'i', &id1);
+  if((wsk1 = znajdz_wezel(b, id1)) == NULL)
+  {
+    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
+    return ;
+  }
+  wczytywanie(napis3, kryterium_liczbowe, 'i', &id2);
+  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+
   if((wsk2 = znajdz_wezel(b, id2)) == NULL)
   {
-    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
+    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
+    return ;
+  }
+  if(id1 == id2)
+  {
+    printf("Identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej\n");
+    printf("Funkcja szuka drogi miedzy dwoma roznymi osobami\n");
+    return ;
+  }
+
+  if(tryb == 1)
+    wezelwsk = przeszukiwanie_dwukierunkowe(b, kontekst, wsk1, wsk2);
+  else
+    wezelwsk = algorytm_dijkstry(b, kontekst, wsk1, wsk2, tryb);
+  if(wezelwsk == NULL)
+    printf("miedzy podanymi osobami nie istnieje "
+           "sposob na nawiazanie znajomosci\n");
+  else
+    wypisywanie_najkrotszej_sciezki(b, kontekst, wezelwsk);
+  printf("Liczba odwiedzonych osob: %d\n", kontekst->liczba_odwiedzonych);
+
+  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
+  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
+    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+
+}
+
+void zwalnianie_pamieci(baza *b)
+{
+  czyszczenie_bazy(b);
+  free(b);
+}
+
+/***************************** import hurtowy *********************************/
+
+/* osoba dodawana hurtowo (import_osob) - dane jak w wezle grafu */
+typedef struct
+{
+  char pierwsze_imie[32];
+  char drugie_imie[32];
+  char nazwisko[32];
+  int nr_telefonu;
+  adres adres;
+} osoba_importowana;
+
+/* o ile pozycji naprzod pobieramy z wyprzedzeniem dane importowanych znajomosci */
+#define WYPRZEDZENIE_IMPORTU 16
+
+/* znajomosc dodawana hurtowo (import_znajomosci) */
+typedef struct
+{
+  int id1, id2;
+  int waga1, waga2; /* w jakim stopniu osoba id1 zna osobe id2 i odwrotnie */
+} znajomosc_importowana;
+
+/* hurtowe dodanie n osob z tablicy osoby - skutek jest taki sam, jak przy */
+/* dodawaniu ich po kolei przez dopisywanie_osoby (osoba o imieniu i nazwisku */
+/* juz obecnym w ksiazce albo wczesniej w tablicy dostaje tylko nowy numer */
+/* telefonu i adres), ale powtorzen nie szukamy dla kazdej osoby osobno: pary */
+/* (skrot imienia i nazwiska, numer pozycji) sortujemy pozycyjnie, wiec ta sama */
+/* osoba lezy w jednej serii, a indeks nazwisk przeszukujemy raz dla kazdej */
+/* roznej osoby; nowe osoby dostaja identyfikatory w kolejnosci pierwszego */
+/* wystapienia w tablicy; przy duzym imporcie widoki osob sa budowane od nowa */
+/* dopiero wtedy, gdy beda potrzebne; identyfikatory[i] (jesli nie NULL) - id */
+/* osoby z pozycji i; d == NULL - bez dziennika; funkcja zwraca liczbe nowych osob */
+int import_osob(baza *b, dziennik_zmian *d, osoba_importowana *osoby, int n, int *identyfikatory)
+{
+  klucz_pozycji *pary;
+  int *pierwsza, *ostatnia; /* pierwsze i ostatnie wystapienie osoby z danej pozycji */
+  wezel **istniejace, *wezelwsk;
+  int i, j, k, p, koniec, liczba_nowych = 0;
+  bool przebudowa_widokow;
+
+  if(n <= 0)
+    return 0;
+  pary = (klucz_pozycji*) malloc(n*sizeof(klucz_pozycji));
+  pierwsza = (int*) malloc(n*sizeof(int));
+  ostatnia = (int*) malloc(n*sizeof(int));
+  istniejace = (wezel**) malloc(n*sizeof(wezel*));
+  for(i = 0; i < n; i++)
+  {
+    pary[i].klucz = mieszanie_nazwiska(osoby[i].pierwsze_imie, osoby[i].nazwisko);
+    pary[i].numer = i;
+    pierwsza[i] = -1;
+  }
+  sortowanie_pozycyjne_par(pary, n);
+
+  /* w serii o tym samym skrocie (prawie zawsze jedna osoba) laczymy pozycje */
+  /* o tym samym imieniu i nazwisku - w serii sa one w kolejnosci pozycji */
+  for(i = 0; i < n; i = koniec)
+  {
+    for(koniec = i+1; koniec < n && pary[koniec].klucz == pary[i].klucz; koniec++)
+      ;
+    for(j = i; j < koniec; j++)
+    {
+      if(pierwsza[p = pary[j].numer] != -1)
+        continue;
+      pierwsza[p] = ostatnia[p] = p;
+      for(k = j+1; k < koniec; k++)
+        if(pierwsza[pary[k].numer] == -1 &&
+           strcmp(osoby[pary[k].numer].pierwsze_imie, osoby[p].pierwsze_imie) == 0 &&
+           strcmp(osoby[pary[k].numer].nazwisko, osoby[p].nazwisko) == 0)
+        {
+          pierwsza[pary[k].numer] = p;
+          ostatnia[p] = pary[k].numer;
+        }
+      if((istniejace[p] = znajdz_osobe(b, osoby[p].pierwsze_imie, osoby[p].nazwisko)) == NULL)
+        liczba_nowych++;
+    }
+  }
+  free(pary);
+
+  /* pojedyncze osoby wstawiamy do aktualnych widokow, wiele osob naraz - przebudowa */
+  przebudowa_widokow = liczba_nowych > b->liczba_elementow / 4;
+  rezerwowanie_miejsca_na_wezly(b, b->liczba_slotow + liczba_nowych);
+  for(i = 0; i < n; i++)
+  {
+    if(pierwsza[i] != i)
+    { /* powtorzenie osoby z wczesniejszej pozycji */
+      if(identyfikatory != NULL)
+        identyfikatory[i] = identyfikatory[pierwsza[i]];
+      continue;
+    }
+    j = ostatnia[i]; /* numer telefonu i adres z ostatniego wystapienia osoby */
+    if((wezelwsk = istniejace[i]) != NULL)
+    {
+      wezelwsk->nr_telefonu = osoby[j].nr_telefonu;
+      wezelwsk->adres = osoby[j].adres;
+      if(d != NULL)
+        rejestrowanie_zmiany_danych_osoby(d, wezelwsk);
+    }
+    else
+    {
+      b->liczba_elementow++;
+      wezelwsk = dodawanie_wezla(b, b->biezacy_id);
+      b->biezacy_id = (b->biezacy_id+1) % INT_MAX;
+      strcpy(wezelwsk->pierwsze_imie, osoby[i].pierwsze_imie);
+      strcpy(wezelwsk->drugie_imie, osoby[i].drugie_imie);
+      strcpy(wezelwsk->nazwisko, osoby[i].nazwisko);
+      wezelwsk->nr_telefonu = osoby[j].nr_telefonu;
+      wezelwsk->adres = osoby[j].adres;
+      dodawanie_do_indeksu_nazwisk(b, wezelwsk);
+      if(przebudowa_widokow)
+        b->widoki.nieaktualne = true;
+      else
+        dodawanie_do_widokow(b, wezelwsk);
+      if(d != NULL)
+        rejestrowanie_dodania_osoby(d, b, wezelwsk);
+    }
+    if(identyfikatory != NULL)
+      identyfikatory[i] = wezelwsk->id;
+  }
+  free(istniejace);
+  free(ostatnia);
+  free(pierwsza);
+  return liczba_nowych;
+}
+
+/* hurtowe dodanie m znajomosci z tablicy znajomosci - najpierw sprawdzamy */
+/* wszystkie pozycje naraz, a potem dopisujemy poprawne krawedzie bez zadnych */
+/* sprawdzen; pary (mniejsze id, wieksze id) sortujemy pozycyjnie, wiec */
+/* powtorzenia tej samej znajomosci leza obok siebie i wygrywa pierwsze z nich, */
+/* a znajomosci juz obecnej w grafie szukamy tylko wtedy, gdy obie osoby */
+/* mialy wczesniej jakichs znajomych; wyniki[i] (jesli nie NULL) - jak */
+/* w dodawanie_krawedzi: 0 - znajomosc dodana, -1 - stopien spoza [1, 10] lub */
+/* ta sama osoba, -2 - znajomosc istniala juz wczesniej, -3 - brak osoby */
+/* o podanym id; d == NULL - bez dziennika; funkcja zwraca liczbe dodanych znajomosci */
+int import_znajomosci(baza *b, dziennik_zmian *d, znajomosc_importowana *znajomosci, int m,
+                      int *wyniki)
+{
+  klucz_pozycji *pary;
+  wezel **konce; /* konce[2*i], konce[2*i+1] - osoby z pozycji i */
+  wezel *wsk1, *wsk2;
+  krawedz *nowa1, *nowa2;
+  znajomosc_importowana *z;
+  int *stan = wyniki;
+  int argumenty[4];
+  int i, koniec, liczba_par = 0, liczba_dodanych = 0;
+
+  if(m <= 0)
+    return 0;
+  if(stan == NULL)
+    stan = (int*) malloc(m*sizeof(int));
+  pary = (klucz_pozycji*) malloc(m*sizeof(klucz_pozycji));
+  konce = (wezel**) malloc(2*(size_t)m*sizeof(wezel*));
+  for(i = 0; i < m; i++)
+  { /* miejsca w indeksie id i wezly kolejnych pozycji pobieramy z wyprzedzeniem */
+    if(i + WYPRZEDZENIE_IMPORTU < m && b->indeks.pojemnosc > 0)
+    {
+      z = &znajomosci[i + WYPRZEDZENIE_IMPORTU];
+      POBIERANIE_Z_WYPRZEDZENIEM(&b->indeks.tablica[mieszanie_id(z->id1, b->indeks.pojemnosc)]);
+      POBIERANIE_Z_WYPRZEDZENIEM(&b->indeks.tablica[mieszanie_id(z->id2, b->indeks.pojemnosc)]);
+      z = &znajomosci[i + WYPRZEDZENIE_IMPORTU/2];
+      POBIERANIE_Z_WYPRZEDZENIEM(b->indeks.tablica[mieszanie_id(z->id1, b->indeks.pojemnosc)]);
+      POBIERANIE_Z_WYPRZEDZENIEM(b->indeks.tablica[mieszanie_id(z->id2, b->indeks.pojemnosc)]);
+    }
+    z = &znajomosci[i];
+    konce[2*i] = wsk1 = znajdz_wezel(b, z->id1);
+    konce[2*i+1] = wsk2 = znajdz_wezel(b, z->id2);
+    if(wsk1 == NULL || wsk2 == NULL)
+      stan[i] = -3;
+    else if(z->waga1 < 1 || 10 < z->waga1 || z->waga2 < 1 || 10 < z->waga2 || wsk1 == wsk2)
+      stan[i] = -1;
+    else
+    {
+      stan[i] = 0;
+      pary[liczba_par].klucz = (z->id1 < z->id2)?
+        ((uint64_t)(uint32_t)z->id1 << 32) | (uint32_t)z->id2 :
+        ((uint64_t)(uint32_t)z->id2 << 32) | (uint32_t)z->id1;
+      pary[liczba_par].numer = i;
+      liczba_par++;
+    }
+  }
+  sortowanie_pozycyjne_par(pary, liczba_par);
+  for(i = 0; i < liczba_par; i = koniec)
+  {
+    for(koniec = i+1; koniec < liczba_par && pary[koniec].klucz == pary[i].klucz; koniec++)
+      stan[pary[koniec].numer] = -2;
+    wsk1 = konce[2*pary[i].numer];
+    wsk2 = konce[2*pary[i].numer+1];
+    /* krawedzie sa dodawane parami, wiec wystarczy przejrzec krotsza liste */
+    if(wsk1->stopien > 0 && wsk2->stopien > 0 &&
+       ((wsk1->stopien <= wsk2->stopien)? znajdz_krawedz(wsk1, wsk2) : znajdz_krawedz(wsk2, wsk1)) != NULL)
+      stan[pary[i].numer] = -2;
+  }
+  free(pary);
+
+  for(i = 0; i < m; i++)
+  { /* wezly, a potem ostatnie krawedzie ich list, pobieramy z wyprzedzeniem */
+    if(i + WYPRZEDZENIE_IMPORTU < m && stan[i + WYPRZEDZENIE_IMPORTU] == 0)
+    {
+      POBIERANIE_Z_WYPRZEDZENIEM(&konce[2*(i + WYPRZEDZENIE_IMPORTU)]->ostatni);
+      POBIERANIE_Z_WYPRZEDZENIEM(&konce[2*(i + WYPRZEDZENIE_IMPORTU)+1]->ostatni);
+    }
+    if(i + WYPRZEDZENIE_IMPORTU/2 < m && stan[i + WYPRZEDZENIE_IMPORTU/2] == 0)
+    {
+      POBIERANIE_Z_WYPRZEDZENIEM(konce[2*(i + WYPRZEDZENIE_IMPORTU/2)]->ostatni);
+      POBIERANIE_Z_WYPRZEDZENIEM(konce[2*(i + WYPRZEDZENIE_IMPORTU/2)+1]->ostatni);
+    }
+    if(stan[i] != 0)
+      continue;
+    nowa1 = (krawedz*) przydzielanie_z_puli(&b->pula_krawedzi);
+    nowa2 = (krawedz*) przydzielanie_z_puli(&b->pula_krawedzi);
+    nowa1->cel = konce[2*i+1];
+    nowa2->cel = konce[2*i];
+    nowa1->waga = znajomosci[i].waga1;
+    nowa2->waga = znajomosci[i].waga2;
+    nowa1->blizniacza = nowa2;
+    nowa2->blizniacza = nowa1;
+    dopisywanie_krawedzi(b, konce[2*i], nowa1);
+    dopisywanie_krawedzi(b, konce[2*i+1], nowa2);
+    liczba_dodanych++;
+    if(d != NULL && d->plik != -1)
+    {
+      argumenty[0] = znajomosci[i].id1;
+      argumenty[1] = znajomosci[i].id2;
+      argumenty[2] = znajomosci[i].waga1;
+      argumenty[3] = znajomosci[i].waga2;
+      rejestrowanie_zmiany(d, ZMIANA_DODANIE_ZNAJOMOSCI, 4, argumenty);
+    }
+  }
+  if(liczba_dodanych > 0)
+    b->migawka.nieaktualna = true;
+  free(konce);
+  if(stan != wyniki)
+    free(stan);
+  return liczba_dodanych;
+}
+
+/****************************** tryb wsadowy **********************************/
+
+/* zapytanie o sciezke wczytane z pliku wraz z jego wynikiem */
+typedef struct
+{
+  int id1, id2, tryb;
+  char *wynik;  /* wiersz pliku wynikowego (bez znaku konca linii) */
+  double czas;  /* czas obslugi zapytania w sekundach */
+} zapytanie;
+
+/* kolejka zadan watku - przedzial [poczatek, koniec) tablicy zapytan, */
+/* wlasciciel pobiera zapytania od poczatku, pozostale watki kradna */
+/* gorna polowe przedzialu, gdy ich wlasne kolejki sa juz puste */
+typedef struct
+{
+  pthread_mutex_t blokada;
+  int poczatek, koniec;
+} kolejka_zadan;
+
+/* dane wspolne wszystkich watkow - graf jest tylko odczytywany, wiec */
+/* watki nie musza go blokowac, kazdy ma natomiast wlasny kontekst wyszukiwania */
+typedef struct
+{
+  graf *g;
+  ksiazka_binarna *ksiazka; /* ksiazka odwzorowana z pliku binarnego lub NULL */
+  zapytanie *zapytania;
+  kolejka_zadan *kolejki;
+  int liczba_watkow;
+  int rodzaj_kolejki;
+} dane_wsadowe;
+
+typedef struct
+{
+  dane_wsadowe *dane;
+  int numer;
+} watek_roboczy;
+
+/* slot osoby o danym id (w ksiazce binarnej numer jej rekordu) lub -1 gdy */
+/* osoby nie ma; ksiazka == NULL oznacza graf wczytany z pliku tekstowego */
+int slot_osoby(graf *g, ksiazka_binarna *ksiazka, int id)
+{
+  wezel *wezelwsk;
+
+  if(ksiazka != NULL)
+    return numer_osoby_binarnej(ksiazka, id);
+  wezelwsk = znajdz_wezel(g, id);
+  return (wezelwsk == NULL)? -1 : wezelwsk->slot;
+}
+
+int id_osoby(graf *g, ksiazka_binarna *ksiazka, int slot)
+{
+  if(ksiazka != NULL)
+    return ksiazka->osoby[slot].id;
+  return g->sloty[slot]->id;
+}
+
+/* wyszukiwanie sciezki dla pojedynczego zapytania i zapisanie wyniku w postaci */
+/* "id1 id2 tryb: id id ... id" (kolejne osoby na sciezce od pierwszej do drugiej) */
+void wykonywanie_zapytania(graf *g, ksiazka_binarna *ksiazka, kontekst_wyszukiwania *kontekst,
+                           zapytanie *z)
+{
+  double poczatek = czas_zegarowy();
+  int slot1, slot2, slot, dlugosc = 0, i, n;
+  bool znaleziona;
+  int *sciezka;
+
+  slot1 = slot_osoby(g, ksiazka, z->id1);
+  slot2 = slot_osoby(g, ksiazka, z->id2);
+  if(slot1 == -1 || slot2 == -1 || slot1 == slot2 || (z->tryb != 1 && z->tryb != 2))
+  {
+    z->wynik = (char*) malloc(64 + 3*12);
+    sprintf(z->wynik, "%d %d %d: nieprawidlowe zapytanie", z->id1, z->id2, z->tryb);
+    z->czas = czas_zegarowy() - poczatek;
     return ;
   }
-  if(id1 == id2)
+
+  if(z->tryb == 1)
+    znaleziona = przeszukiwanie_dwukierunkowe_slotow(g, kontekst, slot1, slot2);
+  else
+    znaleziona = (algorytm_dijkstry_slotow(g, kontekst, slot1, &slot2, 1, z->tryb) > 0);
+  if(!znaleziona)
   {
-    printf("Identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej\n");
-    printf("Funkcja dodaje znajomosc miedzy dwoma roznymi osobami\n");
+    z->wynik = (char*) malloc(64 + 3*12);
+    sprintf(z->wynik, "%d %d %d: brak sciezki", z->id1, z->id2, z->tryb);
+    z->czas = czas_zegarowy() - poczatek;
     return ;
   }
 
-  wczytywanie(napis3, kryterium_wagowe, 'i', &stopien_znajomosci1);
-  wczytywanie(napis4, kryterium_wagowe, 'i', &stopien_znajomosci2);
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+  /* poprzednicy prowadza od celu do zrodla, wiec sciezke zapisujemy od konca */
+  for(slot = slot2; slot >= 0; slot = kontekst->stany[slot].poprzednik)
+    dlugosc++;
+  sciezka = (int*) malloc(dlugosc*sizeof(int));
+  for(slot = slot2, i = dlugosc-1; slot >= 0; slot = kontekst->stany[slot].poprzednik, i--)
+    sciezka[i] = id_osoby(g, ksiazka, slot);
+
+  z->wynik = (char*) malloc(3*12 + 4 + dlugosc*12);
+  n = sprintf(z->wynik, "%d %d %d:", z->id1, z->id2, z->tryb);
+  for(i = 0; i < dlugosc; i++)
+    n += sprintf(z->wynik + n, " %d", sciezka[i]);
+  free(sciezka);
+  z->czas = czas_zegarowy() - poczatek;
+}
 
-  wynik = dodawanie_krawedzi(b, wsk1, wsk2,
-            stopien_znajomosci1, stopien_znajomosci2);
+/* pobieranie porcji zapytan z wlasnej kolejki, zwraca liczbe pobranych zapytan */
+int pobieranie_zadan(kolejka_zadan *kolejka, int *poczatek, int *koniec)
+{
+  int n;
+
+  pthread_mutex_lock(&kolejka->blokada);
+  n = kolejka->koniec - kolejka->poczatek;
+  if(n > PORCJA_ZAPYTAN)
+    n = PORCJA_ZAPYTAN;
+  *poczatek = kolejka->poczatek;
+  *koniec = kolejka->poczatek += n;
+  pthread_mutex_unlock(&kolejka->blokada);
+  return n;
+}
 
-  if(wynik == -2)
-    printf("Znajomosc miedzy danymi osobami zostala dodana juz wczesniej\n");
-  else
-    printf("Znajomosc zostala dodana\n");
+/* kradziez gornej polowy zapytan z kolejki innego watku - skradziony przedzial */
+/* trafia do (pustej) kolejki zlodzieja, zwraca false gdy wszystkie kolejki sa puste */
+bool kradziez_zadan(dane_wsadowe *dane, int numer)
+{
+  kolejka_zadan *ofiara, *wlasna = &dane->kolejki[numer];
+  int i, n, poczatek = 0, koniec = 0;
 
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+  for(i = 1; i < dane->liczba_watkow && koniec == 0; i++)
+  {
+    ofiara = &dane->kolejki[(numer + i) % dane->liczba_watkow];
+    pthread_mutex_lock(&ofiara->blokada);
+    n = ofiara->koniec - ofiara->poczatek;
+    if(n > 0)
+    {
+      koniec = ofiara->koniec;
+      ofiara->koniec -= (n+1)/2;
+      poczatek = ofiara->koniec;
+    }
+    pthread_mutex_unlock(&ofiara->blokada);
+  }
+  if(koniec == 0)
+    return false;
+
+  pthread_mutex_lock(&wlasna->blokada);
+  wlasna->poczatek = poczatek;
+  wlasna->koniec = koniec;
+  pthread_mutex_unlock(&wlasna->blokada);
+  return true;
 }
 
-void usuwanie_znajomosci(baza *b)
+/* praca watku - obsluga zapytan z wlasnej kolejki, a gdy ta jest pusta */
+/* kradziez zapytan od innych watkow; nowe zapytania nie powstaja w trakcie */
+/* pracy, wiec watek konczy sie, gdy nie ma juz czego ukrasc */
+void* praca_watku(void *argument)
 {
-  int id1, id2, wynik;
-  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  char* napis1 = "Podaj identyfikator pierwszej osoby\n";
-  char* napis2 = "Podaj identyfikator drugiej osoby\n";
-  wezel *wsk1, *wsk2;
+  watek_roboczy *watek = (watek_roboczy*) argument;
+  dane_wsadowe *dane = watek->dane;
+  kontekst_wyszukiwania kontekst;
+  int i, poczatek, koniec;
+
+  inicjalizacja_kontekstu(&kontekst);
+  kontekst.rodzaj_kolejki = dane->rodzaj_kolejki;
+  do
+  {
+    while(pobieranie_zadan(&dane->kolejki[watek->numer], &poczatek, &koniec) > 0)
+      for(i = poczatek; i < koniec; i++)
+        wykonywanie_zapytania(dane->g, dane->ksiazka, &kontekst, &dane->zapytania[i]);
+  } while(kradziez_zadan(dane, watek->numer));
+  zwalnianie_kontekstu(&kontekst);
+  return NULL;
+}
 
-  printf("Usuwanie znajomosci miedzy dwiema osobami\n");
+/* wczytywanie zapytan "id1 id2 tryb" (po jednym w linii), zwraca liczbe */
+/* zapytan lub -1 gdy pliku nie udalo sie otworzyc albo zawiera bledne dane */
+int wczytywanie_zapytan(char *nazwa_pliku, zapytanie **zapytania)
+{
+  FILE *plik;
+  int n = 0, pojemnosc = 0, id1, id2, tryb, wynik;
 
-  wczytywanie(napis1, kryterium_liczbowe, 'i', &id1);
-  if((wsk1 = znajdz_wezel(b, id1)) == NULL)
-  {
-    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
-    return ;
-  }
-  wczytywanie(napis2, kryterium_liczbowe, 'i', &id2);
-  if((wsk2 = znajdz_wezel(b, id2)) == NULL)
+  if((plik = fopen(nazwa_pliku, "r")) == NULL)
+    return -1;
+  *zapytania = NULL;
+  while((wynik = fscanf(plik, "%d %d %d", &id1, &id2, &tryb)) == 3)
   {
-    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
-    return ;
+    if(n == pojemnosc)
+    {
+      pojemnosc = (pojemnosc == 0)? 1024 : 2*pojemnosc;
+      *zapytania = (zapytanie*) realloc(*zapytania, pojemnosc*sizeof(zapytanie));
+    }
+    (*zapytania)[n].id1 = id1;
+    (*zapytania)[n].id2 = id2;
+    (*zapytania)[n].tryb = tryb;
+    (*zapytania)[n].wynik = NULL;
+    n++;
   }
-  if(id1 == id2)
+  fclose(plik);
+  if(wynik != EOF)
   {
-    printf("Identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej\n");
-    printf("Funkcja usuwa znajomosc miedzy dwoma roznymi osobami\n");
-    return ;
+    printf("blad w pliku zapytan (zapytanie nr %d)\n", n+1);
+    free(*zapytania);
+    return -1;
   }
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
-
-  wynik = usuwanie_krawedzi(b, id1, id2);
-
-  if(wynik == -2)
-    printf("Miedzy danymi osobami nie istniala znajomosc\n");
-  else
-    printf("Znajomosc zostala usunieta\n");
+  return n;
+}
 
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+int porownywanie_czasow(const void *a, const void *b)
+{
+  double x = *(const double*)a, y = *(const double*)b;
+  return (x > y) - (x < y);
 }
 
-void zmiana_stopnia_znajomosci(baza *b)
+/* percentyl metoda najblizszej rangi z posortowanej tablicy czasow */
+double percentyl(double *czasy, int n, double p)
 {
-  int id1, id2, stopien_znajomosci;
-  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  char* napis1 = "Podaj identyfikator pierwszej osoby\n";
-  char* napis2 = "Podaj identyfikator drugiej osoby\n";
-  char* napis3 = "Podaj stopien w jakim pierwsza osoba zna osobe druga\n";
-  wezel *wsk1, *wsk2;
+  int i = (int)ceil(p*n) - 1;
+  return czasy[(i < 0)? 0 : i];
+}
 
-  printf("Zmiana stopnia znajomosci w jakim osoba pierwsza zna druga\n");
+/* tryb wsadowy - wczytuje baze i plik zapytan, rozdziela zapytania miedzy */
+/* watki (rowne przedzialy, potem kradziez pracy) i zapisuje sciezki do pliku */
+/* wynikowego w kolejnosci zapytan; zwraca kod zakonczenia programu */
+/* baza moze byc plikiem tekstowym albo binarnym - binarny jest tylko odwzorowywany */
+/* w pamieci, a zapytania sa wykonywane bezposrednio na jego migawce CSR */
+int tryb_wsadowy(char *plik_bazy, char *plik_zapytan, char *plik_wynikow,
+                 int liczba_watkow, int rodzaj_kolejki)
+{
+  baza b;
+  ksiazka_binarna ksiazka;
+  graf *g = &b;
+  zapytanie *zapytania;
+  dane_wsadowe dane;
+  watek_roboczy *watki;
+  pthread_t *identyfikatory;
+  double poczatek, czas, *czasy;
+  FILE *plik;
+  long rozmiar;
+  int i, n;
 
-  wczytywanie(napis1, kryterium_liczbowe, 'i', &id1);
-  if((wsk1 = znajdz_wezel(b, id1)) == NULL)
+  inicjalizacja_bazy(&b);
+  dane.ksiazka = NULL;
+  poczatek = czas_zegarowy();
+  if((i = otwieranie_ksiazki_binarnej(&ksiazka, plik_bazy)) == 0)
   {
-    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
-    return ;
+    dane.ksiazka = &ksiazka;
+    g = &ksiazka.graf;
+    rozmiar = ksiazka.rozmiar;
+    czas = czas_zegarowy() - poczatek;
+    printf("Odwzorowano baze binarna: %.2f MB w %.6f sekund\n", rozmiar/1e6, czas);
+  }
+  else if(i == -3)
+  {
+    printf("blad, plik %s jest ksiazka binarna w innej wersji lub jest uszkodzony\n", plik_bazy);
+    return 1;
+  }
+  else if(i == -1 || (rozmiar = wczytywanie_bazy_z_pliku_watkami(&b, plik_bazy, liczba_watkow)) == -1)
+  {
+    printf("blad, nie znaleziono pliku zawierajacego ksiazke adresowa\n");
+    return 1;
+  }
+  else
+  {
+    czas = czas_zegarowy() - poczatek;
+    printf("Wczytano baze: %.2f MB w %.6f sekund (%.1f MB/s)\n", rozmiar/1e6, czas,
+           (czas > 0)? rozmiar/1e6/czas : 0);
+  }
+  if((n = wczytywanie_zapytan(plik_zapytan, &zapytania)) == -1)
+  {
+    printf("blad, nie udalo sie wczytac pliku zapytan\n");
+    czyszczenie_bazy(&b);
+    if(dane.ksiazka != NULL)
+      zamykanie_ksiazki_binarnej(&ksiazka);
+    return 1;
+  }
+  if((plik = fopen(plik_wynikow, "w")) == NULL)
+  {
+    printf("blad, nie udalo sie utworzyc pliku wynikowego\n");
+    free(zapytania);
+    czyszczenie_bazy(&b);
+    if(dane.ksiazka != NULL)
+      zamykanie_ksiazki_binarnej(&ksiazka);
+    return 1;
+  }
+  if(liczba_watkow > n)
+    liczba_watkow = (n > 0)? n : 1;
+  aktualizacja_migawki(g);
+
+  dane.g = g;
+  dane.zapytania = zapytania;
+  dane.liczba_watkow = liczba_watkow;
+  dane.rodzaj_kolejki = rodzaj_kolejki;
+  dane.kolejki = (kolejka_zadan*) malloc(liczba_watkow*sizeof(kolejka_zadan));
+  watki = (watek_roboczy*) malloc(liczba_watkow*sizeof(watek_roboczy));
+  identyfikatory = (pthread_t*) malloc(liczba_watkow*sizeof(pthread_t));
+  for(i = 0; i < liczba_watkow; i++)
+  {
+    pthread_mutex_init(&dane.kolejki[i].blokada, NULL);
+    dane.kolejki[i].poczatek = (int)((long long)n*i/liczba_watkow);
+    dane.kolejki[i].koniec = (int)((long long)n*(i+1)/liczba_watkow);
+    watki[i].dane = &dane;
+    watki[i].numer = i;
   }
-  wczytywanie(napis2, kryterium_liczbowe, 'i', &id2);
 
-  if((wsk2 = znajdz_wezel(b, id2)) == NULL)
+  poczatek = czas_zegarowy();
+  /* watek glowny pracuje jako watek numer 0 */
+  for(i = 1; i < liczba_watkow; i++)
+    pthread_create(&identyfikatory[i], NULL, praca_watku, &watki[i]);
+  praca_watku(&watki[0]);
+  for(i = 1; i < liczba_watkow; i++)
+    pthread_join(identyfikatory[i], NULL);
+  czas = czas_zegarowy() - poczatek;
+
+  czasy = (double*) malloc((n > 0 ? n : 1)*sizeof(double));
+  for(i = 0; i < n; i++)
   {
-    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
-    return ;
+    fprintf(plik, "%s\n", zapytania[i].wynik);
+    czasy[i] = zapytania[i].czas;
+    free(zapytania[i].wynik);
   }
+  fclose(plik);
+  qsort(czasy, n, sizeof(double), porownywanie_czasow);
 
-  if(id1 == id2)
+  printf("Liczba zapytan: %d, liczba watkow: %d\n", n, liczba_watkow);
+  printf("Calkowity czas obslugi zapytan: %.6f sekund\n", czas);
+  if(n > 0)
   {
-    printf("Identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej\n");
-    printf("Funkcja zmienia stopien znajomosci miedzy dwoma roznymi osobami\n");
-    return ;
+    printf("Przepustowosc: %.1f zapytan/s\n", (czas > 0)? n/czas : 0.0);
+    printf("Opoznienie zapytania p50: %.6f ms, p99: %.6f ms\n",
+      1e3*percentyl(czasy, n, 0.5), 1e3*percentyl(czasy, n, 0.99));
   }
 
-  wczytywanie(napis3, kryterium_wagowe, 'i', &stopien_znajomosci);
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+  for(i = 0; i < liczba_watkow; i++)
+    pthread_mutex_destroy(&dane.kolejki[i].blokada);
+  free(czasy);
+  free(identyfikatory);
+  free(watki);
+  free(dane.kolejki);
+  free(zapytania);
+  czyszczenie_bazy(&b);
+  if(dane.ksiazka != NULL)
+    zamykanie_ksiazki_binarnej(&ksiazka);
+  return 0;
+}
 
-  if(zmiana_wagi_krawedzi(b, wsk1, wsk2, stopien_znajomosci) == -1)
-    printf("Osoby o podanych identyfikatorach nie znaja sie\n");
-  else
-    printf("stopien znajomosci zmieniony\n");
+/****************************** tryb polecen **********************************/
+
+/* polecenia trybu polecen (po jednym w linii, pola oddzielone odstepami): */
+/* dodaj_osobe imie drugie_imie nazwisko telefon ulica nr_domu nr_mieszkania kod miasto */
+/*   (drugie_imie "_" - brak drugiego imienia) */
+/* dodaj_znajomosc id1 id2 stopien1 stopien2 */
+/* usun_osobe id */
+/* usun_znajomosc id1 id2 */
+/* zmien_stopien id1 id2 stopien */
+/* zapisz */
+/* sciezka id1 id2 tryb (1 - najmniej posrednikow, 2 - najskuteczniejsza) */
+/* puste linie i linie zaczynajace sie od '#' sa pomijane */
+#define LICZBA_POLECEN 7
+#define POLECENIE_DODAJ_OSOBE 0
+#define POLECENIE_DODAJ_ZNAJOMOSC 1
+#define POLECENIE_USUN_OSOBE 2
+#define POLECENIE_USUN_ZNAJOMOSC 3
+#define POLECENIE_ZMIEN_STOPIEN 4
+#define POLECENIE_ZAPISZ 5
+#define POLECENIE_SCIEZKA 6
+
+char *nazwy_polecen[LICZBA_POLECEN] =
+  {"dodaj_osobe", "dodaj_znajomosc", "usun_osobe", "usun_znajomosc", "zmien_stopien",
+   "zapisz", "sciezka"};
+
+/* liczniki polecen do podsumowania trybu polecen */
+typedef struct
+{
+  long wykonane[LICZBA_POLECEN];
+  long odrzucone; /* poprawne polecenia, ktorych nie dalo sie wykonac (np. brak osoby) */
+  long bledne; /* nieznane polecenia i polecenia z blednymi polami */
+} statystyka_polecen;
 
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+/* kolejne polecenia dodaj_osobe (albo dodaj_znajomosc) nie sa wykonywane od */
+/* razu, tylko zbierane w pakiet, ktory wykonujemy naraz importem hurtowym - */
+/* przed innym poleceniem, po zapelnieniu pakietu i na koncu pliku polecen */
+#define ROZMIAR_PAKIETU_POLECEN 65536
+
+typedef struct
+{
+  int rodzaj; /* POLECENIE_DODAJ_OSOBE lub POLECENIE_DODAJ_ZNAJOMOSC */
+  int liczba; /* liczba zebranych polecen */
+  osoba_importowana *osoby;
+  znajomosc_importowana *znajomosci;
+  long *numery_linii; /* numery linii polecen - do opisu odrzuconych polecen */
+  int *wyniki;
+} pakiet_polecen;
+
+/* drugie imie - same litery albo "_" (brak drugiego imienia) */
+bool kryterium_drugiego_imienia(char *napis)
+{
+  return strcmp(napis, "_") == 0 || kryterium_napisowe(napis);
 }
 
-/* rekurencyjna funkcja wypisujaca sciezke od wezla zrodlowego */
-/* do wezla docelowego za pomoca zmiennej skladowej wezla "poprzednik" */
-void wypisywanie_najkrotszej_sciezki(wezel *wezelwsk)
+/* kolejne pole polecenia - slowo krotsze niz 32 znaki, spelniajace kryterium */
+/* (tak jak dane wpisywane z klawiatury); cel ma miejsce na 32 znaki */
+bool czytanie_pola(czytnik_tekstu *linia, char *cel, bool (*kryterium)(char*))
 {
-  if(wezelwsk->poprzednik == NULL)
-    printf("id %d %s %s\n", wezelwsk->id,
-      wezelwsk->pierwsze_imie, wezelwsk->nazwisko);
+  char slowo[33];
+
+  if(!czytanie_slowa(linia, slowo, sizeof(slowo)) || strlen(slowo) > 31 || !kryterium(slowo))
+    return false;
+  strcpy(cel, slowo);
+  return true;
+}
+
+bool czytanie_pola_liczbowego(czytnik_tekstu *linia, int *liczba, bool (*kryterium)(char*))
+{
+  char slowo[32];
+
+  if(!czytanie_pola(linia, slowo, kryterium))
+    return false;
+  *liczba = atoi(slowo);
+  return true;
+}
+
+/* numer polecenia (pierwsze slowo linii) lub -1, gdy polecenie jest nieznane */
+int rodzaj_polecenia(czytnik_tekstu *linia)
+{
+  char nazwa[32];
+  int i;
+
+  if(!czytanie_slowa(linia, nazwa, sizeof(nazwa)))
+    return -1;
+  for(i = 0; i < LICZBA_POLECEN; i++)
+    if(strcmp(nazwa, nazwy_polecen[i]) == 0)
+      return i;
+  return -1;
+}
+
+/* opis polecenia, ktorego nie udalo sie wykonac, razem z numerem jego linii */
+void dopisywanie_bledu(bufor_tekstu *wyjscie, long numer_linii, const char *komunikat)
+{
+  rezerwowanie_bufora(wyjscie, 256);
+  dopisywanie_napisu(wyjscie, "linia ");
+  dopisywanie_liczby(wyjscie, (int)numer_linii);
+  dopisywanie_napisu(wyjscie, ": ");
+  dopisywanie_napisu(wyjscie, komunikat);
+  dopisywanie_napisu(wyjscie, "\n");
+}
+
+/* wykonanie zebranego pakietu polecen dodaj_osobe lub dodaj_znajomosc */
+/* importem hurtowym - skutek i opisy odrzuconych polecen sa takie same, */
+/* jak przy wykonywaniu polecen po kolei */
+void wykonywanie_pakietu(baza *b, dziennik_zmian *d, pakiet_polecen *pakiet,
+                         bufor_tekstu *wyjscie, statystyka_polecen *statystyka)
+{
+  int i;
+
+  if(pakiet->liczba == 0)
+    return;
+  if(pakiet->rodzaj == POLECENIE_DODAJ_OSOBE)
+  { /* osoba o istniejacym imieniu i nazwisku jest aktualizowana, wiec */
+    /* dodanie osoby zawsze sie udaje */
+    import_osob(b, d, pakiet->osoby, pakiet->liczba, NULL);
+    statystyka->wykonane[POLECENIE_DODAJ_OSOBE] += pakiet->liczba;
+  }
   else
   {
-    wypisywanie_najkrotszej_sciezki(wezelwsk->poprzednik);
-    printf("id %d %s %s\n", wezelwsk->id,
-      wezelwsk->pierwsze_imie, wezelwsk->nazwisko);
+    import_znajomosci(b, d, pakiet->znajomosci, pakiet->liczba, pakiet->wyniki);
+    for(i = 0; i < pakiet->liczba; i++)
+    {
+      if(pakiet->wyniki[i] == 0)
+      {
+        statystyka->wykonane[POLECENIE_DODAJ_ZNAJOMOSC]++;
+        continue;
+      }
+      statystyka->odrzucone++;
+      /* stopnie znajomosci sprawdzilo juz czytanie polecenia */
+      dopisywanie_bledu(wyjscie, pakiet->numery_linii[i],
+        (pakiet->wyniki[i] == -3)? "osoba o podanym identyfikatorze nie istnieje w bazie" :
+        (pakiet->wyniki[i] == -1)? "identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej" :
+                                   "znajomosc miedzy danymi osobami zostala dodana juz wczesniej");
+    }
   }
+  pakiet->liczba = 0;
 }
 
-/* funkcja szukajaca najszybszej lub najskuteczniejszej sciezki */
-/* za pomoca algorytmu Dijkstry */
-void najkrotsza_sciezka(baza *b)
+/* wykonanie jednego polecenia (linia bez znaku konca linii, za nazwa polecenia */
+/* rodzaj); wynik zapytania o sciezke jest dopisywany do bufora wyjscie */
+/* w postaci takiej jak w trybie wsadowym; polecenia dodaj_osobe */
+/* i dodaj_znajomosc trafiaja do pakietu (pakiet jest pusty albo zawiera */
+/* polecenia tego samego rodzaju); funkcja zwraca 0 gdy polecenie wykonano, */
+/* 1 gdy dopisano je do pakietu, -1 gdy polecenie jest nieznane lub ma bledne */
+/* pola i -2 gdy nie dalo sie go wykonac (wtedy *komunikat opisuje powod) */
+int wykonywanie_polecenia(baza *b, dziennik_zmian *d, kontekst_wyszukiwania *kontekst,
+                          czytnik_tekstu *linia, int rodzaj, pakiet_polecen *pakiet,
+                          long numer_linii, bufor_tekstu *wyjscie, const char **komunikat)
 {
-  int id1, id2, tryb;
-  clock_t poczatek, koniec; /* zmienne lokalne sluzace do mierzenia czasu wykonywania danej funkcjonalnosci */
-  char* napis1 = "Nacisnij klawisz 1 lub 2\n"
-  "1 - Wyszukiwanie najszybszego sposobu na nawiazanie znajomosci\n"
-  "miedzy dwoma osobami (najmniejsza liczba posrednikow)\n"
-  "2 - Wyszukiwanie najskuteczniejszego sposobu na nawiazanie znajomosci\n"
-  "miedzy dwoma osobami (poprzez osoby, ktore sie najbardziej znaja)\n";
-  char* napis2 = "Podaj identyfikator pierwszej osoby\n";
-  char* napis3 = "Podaj identyfikator drugiej osoby\n";
-  wezel *wsk1, *wsk2, *wezelwsk;
-
-  wczytywanie(napis1, kryterium3, 'i', &tryb);
-
-  wczytywanie(napis2, kryterium_liczbowe, 'i', &id1);
-  if((wsk1 = znajdz_wezel(b, id1)) == NULL)
+  bool (*kryteria[4])(char*) =
+    {kryterium_liczbowe, kryterium_liczbowe, kryterium_wagowe, kryterium_wagowe};
+  char kod_pocztowy[32];
+  int argumenty[4], liczba_argumentow = 0, i;
+  bool poprawne = true;
+  osoba_importowana *osoba = &pakiet->osoby[pakiet->liczba];
+  znajomosc_importowana *znajomosc;
+  wezel *wsk1 = NULL, *wsk2 = NULL;
+  zapytanie z;
+
+  switch(rodzaj)
   {
-    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
-    return ;
+    case POLECENIE_DODAJ_OSOBE:
+      poprawne = czytanie_pola(linia, osoba->pierwsze_imie, kryterium_napisowe) &&
+                 czytanie_pola(linia, osoba->drugie_imie, kryterium_drugiego_imienia) &&
+                 czytanie_pola(linia, osoba->nazwisko, kryterium_napisowe) &&
+                 czytanie_pola_liczbowego(linia, &osoba->nr_telefonu, kryterium_liczbowe) &&
+                 czytanie_pola(linia, osoba->adres.ulica, kryterium_napisowe) &&
+                 czytanie_pola_liczbowego(linia, &osoba->adres.nr_domu, kryterium_liczbowe) &&
+                 czytanie_pola_liczbowego(linia, &osoba->adres.nr_mieszkania, kryterium_liczbowe) &&
+                 czytanie_pola(linia, kod_pocztowy, kryterium_kod_pocztowy) &&
+                 czytanie_pola(linia, osoba->adres.miasto, kryterium_napisowe);
+      break;
+    case POLECENIE_DODAJ_ZNAJOMOSC:
+      liczba_argumentow = 4;
+      break;
+    case POLECENIE_USUN_OSOBE:
+      liczba_argumentow = 1;
+      break;
+    case POLECENIE_USUN_ZNAJOMOSC:
+      liczba_argumentow = 2;
+      break;
+    case POLECENIE_ZMIEN_STOPIEN:
+      liczba_argumentow = 3;
+      break;
+    case POLECENIE_SCIEZKA:
+      liczba_argumentow = 3;
+      kryteria[2] = kryterium3; /* tryb 1 lub 2 */
+      break;
+    case POLECENIE_ZAPISZ:
+      break;
+    default:
+      return -1;
   }
-  wczytywanie(napis3, kryterium_liczbowe, 'i', &id2);
-  poczatek = clock(); /* poczatek pomiaru czasu wykonywania danej funkcjonalnosci */
+  /* identyfikatory osob, potem stopnie znajomosci lub tryb sciezki */
+  for(i = 0; i < liczba_argumentow && poprawne; i++)
+    poprawne = czytanie_pola_liczbowego(linia, &argumenty[i], kryteria[i]);
+  pomijanie_odstepow(linia);
+  if(!poprawne || linia->pozycja != linia->koniec)
+    return -1;
 
-  if((wsk2 = znajdz_wezel(b, id2)) == NULL)
+  if(rodzaj == POLECENIE_DODAJ_OSOBE || rodzaj == POLECENIE_DODAJ_ZNAJOMOSC)
+  { /* osoby i znajomosci sprawdzimy przy wykonywaniu pakietu */
+    if(rodzaj == POLECENIE_DODAJ_OSOBE)
+      strcpy(osoba->adres.kod_pocztowy, kod_pocztowy);
+    else
+    {
+      znajomosc = &pakiet->znajomosci[pakiet->liczba];
+      znajomosc->id1 = argumenty[0];
+      znajomosc->id2 = argumenty[1];
+      znajomosc->waga1 = argumenty[2];
+      znajomosc->waga2 = argumenty[3];
+    }
+    pakiet->rodzaj = rodzaj;
+    pakiet->numery_linii[pakiet->liczba] = numer_linii;
+    pakiet->liczba++;
+    return 1;
+  }
+  if(rodzaj == POLECENIE_SCIEZKA)
+  { /* bledne identyfikatory opisuje wynik zapytania, tak jak w trybie wsadowym */
+    z.id1 = argumenty[0];
+    z.id2 = argumenty[1];
+    z.tryb = argumenty[2];
+    wykonywanie_zapytania(b, NULL, kontekst, &z);
+    rezerwowanie_bufora(wyjscie, strlen(z.wynik) + 1);
+    dopisywanie_napisu(wyjscie, z.wynik);
+    dopisywanie_napisu(wyjscie, "\n");
+    free(z.wynik);
+    return 0;
+  }
+  if(liczba_argumentow > 0)
   {
-    printf("Osoba o podanym identyfikatorze nie istnieje w bazie\n");
-    return ;
+    wsk1 = znajdz_wezel(b, argumenty[0]);
+    wsk2 = (liczba_argumentow > 1)? znajdz_wezel(b, argumenty[1]) : wsk1;
+    if(wsk1 == NULL || wsk2 == NULL)
+    {
+      *komunikat = "osoba o podanym identyfikatorze nie istnieje w bazie";
+      return -2;
+    }
+    if(liczba_argumentow > 1 && wsk1 == wsk2)
+    {
+      *komunikat = "identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej";
+      return -2;
+    }
   }
-  if(id1 == id2)
+  switch(rodzaj)
   {
-    printf("Identyfikator pierwszej osoby jest rowny identyfikatorowi drugiej\n");
-    printf("Funkcja szuka drogi miedzy dwoma roznymi osobami\n");
-    return ;
+    case POLECENIE_USUN_OSOBE:
+      usuwanie_wezla(b, argumenty[0]);
+      b->liczba_elementow--;
+      rejestrowanie_zmiany(d, ZMIANA_USUNIECIE_OSOBY, 1, argumenty);
+      break;
+    case POLECENIE_USUN_ZNAJOMOSC:
+      if(usuwanie_krawedzi(b, argumenty[0], argumenty[1]) == -2)
+      {
+        *komunikat = "miedzy danymi osobami nie istniala znajomosc";
+        return -2;
+      }
+      rejestrowanie_zmiany(d, ZMIANA_USUNIECIE_ZNAJOMOSCI, 2, argumenty);
+      break;
+    case POLECENIE_ZMIEN_STOPIEN:
+      if(zmiana_wagi_krawedzi(b, wsk1, wsk2, argumenty[2]) == -1)
+      {
+        *komunikat = "osoby o podanych identyfikatorach nie znaja sie";
+        return -2;
+      }
+      rejestrowanie_zmiany(d, ZMIANA_STOPNIA_ZNAJOMOSCI, 3, argumenty);
+      break;
+    case POLECENIE_ZAPISZ:
+      if(zapisywanie_migawki(d, b) == -1)
+      {
+        *komunikat = "nie udalo sie utworzyc pliku ksiazka_adresowa.txt";
+        return -2;
+      }
+      break;
   }
+  return 0;
+}
 
-  if((wezelwsk = algorytm_dijkstry(b, wsk1, wsk2, tryb)) == NULL)
-    printf("miedzy podanymi osobami nie istnieje "
-           "sposob na nawiazanie znajomosci\n");
-  else
-    wypisywanie_najkrotszej_sciezki(wezelwsk);
+/* tryb polecen - polecenia z pliku (nazwa "-" oznacza standardowe wejscie) sa */
+/* wykonywane po kolei na ksiazce ksiazka_adresowa.txt, tak jak zmiany z menu */
+/* (z dziennikiem zmian), ale bez menu i pytan; kolejne polecenia dodaj_osobe */
+/* i dodaj_znajomosc sa wykonywane pakietami (patrz pakiet_polecen); */
+/* rekordy dziennika sa zatwierdzane */
+/* grupowo w tle, a na koncu czekamy na zatwierdzenie wszystkich; wyniki zapytan */
+/* i bledy (z numerem linii) sa skladane w buforze i wypisywane duzymi blokami, */
+/* a na koniec wypisywane jest podsumowanie z liczba polecen na sekunde; bez */
+/* dziennika zaczynamy od istniejacej ksiazki, a gdy nie udalo sie jej wczytac, */
+/* polecenia nie sa wykonywane (zapisz nadpisaloby ja pusta baza) */
+int tryb_polecen(char *plik_polecen, int rodzaj_kolejki)
+{
+  baza *b;
+  kontekst_wyszukiwania kontekst;
+  dziennik_zmian dziennik;
+  czytnik_tekstu c, linia;
+  bufor_tekstu wyjscie = {NULL, 0, 0};
+  statystyka_polecen statystyka;
+  pakiet_polecen pakiet;
+  const char *koniec_linii, *komunikat;
+  long numer_linii = 0, liczba_polecen = 0, liczba_zmian;
+  znacznik_pliku znacznik;
+  double czas;
+  int i, rodzaj, wynik, kod_wyjscia = 0;
+
+  if(((strcmp(plik_polecen, "-") == 0)? otwieranie_czytnika_wejscia(&c) :
+                                        otwieranie_czytnika(&c, plik_polecen)) == -1)
+  {
+    printf("blad, nie udalo sie wczytac pliku polecen %s\n", plik_polecen);
+    return 1;
+  }
+  b = (baza *) malloc(sizeof(baza));
+  inicjalizacja_bazy(b);
+  inicjalizacja_kontekstu(&kontekst);
+  kontekst.rodzaj_kolejki = rodzaj_kolejki;
+  memset(&statystyka, 0, sizeof(statystyka));
+  pakiet.rodzaj = -1;
+  pakiet.liczba = 0;
+  pakiet.osoby = (osoba_importowana*) malloc(ROZMIAR_PAKIETU_POLECEN*sizeof(osoba_importowana));
+  pakiet.znajomosci = (znajomosc_importowana*) malloc(ROZMIAR_PAKIETU_POLECEN*sizeof(znajomosc_importowana));
+  pakiet.numery_linii = (long*) malloc(ROZMIAR_PAKIETU_POLECEN*sizeof(long));
+  pakiet.wyniki = (int*) malloc(ROZMIAR_PAKIETU_POLECEN*sizeof(int));
+  if((liczba_zmian = otwieranie_dziennika(&dziennik, b, "ksiazka_adresowa.txt")) >= 0)
+    printf("Odtworzono baze z dziennika zmian (%d osob, %ld zmian od ostatniej migawki)\n",
+           b->liczba_elementow, liczba_zmian);
+  else if(b->liczba_elementow > 0)
+    printf("Wczytano ksiazke ksiazka_adresowa.txt (%d osob)\n", b->liczba_elementow);
+  else if(pobieranie_znacznika("ksiazka_adresowa.txt", &znacznik) && znacznik.rozmiar > 0)
+  { /* polecenie zapisz nadpisaloby ksiazke, ktorej nie wczytano */
+    printf("blad, nie udalo sie wczytac ksiazki ksiazka_adresowa.txt - polecenia nie "
+           "zostaly wykonane\n");
+    c.pozycja = c.koniec;
+    kod_wyjscia = 1;
+  }
+  dziennik.czekanie_na_zapis = false;
 
-  koniec = clock(); /* koniec pomiaru czasu wykonywania danej funkcjonalnosci */
-  printf("Calkowity czas wykonywania funkcjonalnosci: %.10f sekund\n",
-    (double)(koniec-poczatek)/CLOCKS_PER_SEC);
+  czas = czas_zegarowy();
+  while(c.pozycja < c.koniec)
+  {
+    if((koniec_linii = (const char*) memchr(c.pozycja, '\n', c.koniec - c.pozycja)) == NULL)
+      koniec_linii = c.koniec;
+    linia.pozycja = c.pozycja;
+    linia.koniec = koniec_linii;
+    c.pozycja = (koniec_linii < c.koniec)? koniec_linii + 1 : koniec_linii;
+    numer_linii++;
+    pomijanie_odstepow(&linia);
+    if(linia.pozycja == linia.koniec || *linia.pozycja == '#')
+      continue;
 
+    liczba_polecen++;
+    rodzaj = rodzaj_polecenia(&linia);
+    /* zebrany pakiet wykonujemy przed poleceniem innego rodzaju */
+    if(rodzaj != pakiet.rodzaj)
+      wykonywanie_pakietu(b, &dziennik, &pakiet, &wyjscie, &statystyka);
+    wynik = (rodzaj == -1)? -1 : wykonywanie_polecenia(b, &dziennik, &kontekst, &linia, rodzaj,
+                                                        &pakiet, numer_linii, &wyjscie, &komunikat);
+    if(wynik == 1 && pakiet.liczba == ROZMIAR_PAKIETU_POLECEN)
+      wykonywanie_pakietu(b, &dziennik, &pakiet, &wyjscie, &statystyka);
+    else if(wynik == 0)
+      statystyka.wykonane[rodzaj]++;
+    else if(wynik < 0)
+    { /* bledy opisujemy w wyjsciu razem z numerem linii, po bledach */
+      /* wczesniejszych polecen z pakietu */
+      wykonywanie_pakietu(b, &dziennik, &pakiet, &wyjscie, &statystyka);
+      if(wynik == -1)
+      {
+        statystyka.bledne++;
+        komunikat = "nieprawidlowe polecenie";
+      }
+      else
+        statystyka.odrzucone++;
+      dopisywanie_bledu(&wyjscie, numer_linii, komunikat);
+    }
+    if(wyjscie.dlugosc >= (1 << 20))
+    {
+      fflush(stdout);
+      oproznianie_bufora(&wyjscie, 1);
+    }
+  }
+  wykonywanie_pakietu(b, &dziennik, &pakiet, &wyjscie, &statystyka);
+  oczekiwanie_na_zatwierdzenie(&dziennik);
+  czas = czas_zegarowy() - czas;
+  fflush(stdout);
+  oproznianie_bufora(&wyjscie, 1);
+
+  printf("Liczba polecen: %ld (wykonane: %ld, odrzucone: %ld, bledne: %ld)\n", liczba_polecen,
+         liczba_polecen - statystyka.odrzucone - statystyka.bledne, statystyka.odrzucone,
+         statystyka.bledne);
+  for(i = 0; i < LICZBA_POLECEN; i++)
+    if(statystyka.wykonane[i] > 0)
+      printf("  %s: %ld\n", nazwy_polecen[i], statystyka.wykonane[i]);
+  printf("Calkowity czas wykonywania polecen: %.6f sekund\n", czas);
+  printf("Przepustowosc: %.1f polecen/s\n", (czas > 0)? liczba_polecen/czas : 0.0);
+
+  free(pakiet.osoby);
+  free(pakiet.znajomosci);
+  free(pakiet.numery_linii);
+  free(pakiet.wyniki);
+  free(wyjscie.dane);
+  zamykanie_czytnika(&c);
+  zamykanie_dziennika(&dziennik);
+  zwalnianie_kontekstu(&kontekst);
+  zwalnianie_pamieci(b);
+  return kod_wyjscia;
 }
 
-void zwalnianie_pamieci(baza *b)
-{
-  usuwanie_wszystkich_wezlow(b->zrodlo);
-  free(b);
-}
+/************************* testy wydajnosciowe ********************************/
+
+/* testy kompilujemy tylko na zyczenie: gcc -DTESTY_WYDAJNOSCI ...  */
+/* uruchamiamy je poleceniem: ./ksiazka_adresowa --test-wydajnosci, a zestaw */
+/* testow z wynikami w pliku JSON: ./ksiazka_adresowa --zestaw-testow plik */
+#ifdef TESTY_WYDAJNOSCI
+#include "testy_wydajnosci.c"
+#endif /* TESTY_WYDAJNOSCI */
 
 /***************************** main **********************************/
 
-int main()
+int main(int argc, char *argv[])
 {
-  baza *b = (baza *) malloc(sizeof(baza));
-  int wybor = 0;
+  baza *b;
+  kontekst_wyszukiwania kontekst;
+  dziennik_zmian dziennik;
+  long liczba_zmian;
+  int i, wybor = 0, rodzaj_kolejki = KOLEJKA_KOPIEC;
+  int liczba_watkow = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  char *plik_bazy = NULL, *plik_zapytan = NULL, *plik_wynikow = NULL, *plik_polecen = NULL;
   char *napis1 =
   "\nWybierz operacje\n"
   "(poprzez nacisniecie klawisza 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 lub 11)\n"
@@ -1367,10 +6244,77 @@ int main()
   "10 - Sortowanie ksiazki adresowej\n"
   "11 - Koniec\n";
 
+#ifdef TESTY_WYDAJNOSCI
+  if(argc > 1 && strcmp(argv[1], "--test-wydajnosci") == 0)
+    return testy_wydajnosci(argc-2, argv+2);
+  /* --zestaw-testow wyniki.json [maks_osob [ziarno]] - zestaw testow */
+  /* na ksiazkach z generatora, wyniki w formacie JSON */
+  if(argc >= 3 && argc <= 5 && strcmp(argv[1], "--zestaw-testow") == 0)
+    return zestaw_testow(argv[2], (argc > 3)? atoi(argv[3]) : 1000000,
+                         (argc > 4)? (unsigned int)strtoul(argv[4], NULL, 10) : 2024);
+#endif
+
+  /* argumenty programu: */
+  /* --kolejka kopiec|kubelkowa - wybor kolejki priorytetowej uzywanej przy */
+  /* wyszukiwaniu najskuteczniejszej sciezki (domyslnie kopiec) */
+  /* --wsadowo baza zapytania wyniki - tryb wsadowy (bez menu) */
+  /* --watki n - liczba watkow trybu wsadowego (domyslnie liczba procesorow) */
+  /* --polecenia plik - tryb polecen (bez menu), "-" - polecenia ze standardowego wejscia */
+  /* --do-binarnego tekstowy binarny, --do-tekstowego binarny tekstowy - konwersja */
+  /* ksiazki miedzy formatem tekstowym i binarnym */
+  if(argc == 4 && strcmp(argv[1], "--do-binarnego") == 0)
+    return konwersja_ksiazki(argv[2], argv[3], true);
+  if(argc == 4 && strcmp(argv[1], "--do-tekstowego") == 0)
+    return konwersja_ksiazki(argv[2], argv[3], false);
+  for(i = 1; i < argc; i++)
+  {
+    if(strcmp(argv[i], "--kolejka") == 0 && i+1 < argc && strcmp(argv[i+1], "kopiec") == 0)
+      rodzaj_kolejki = KOLEJKA_KOPIEC;
+    else if(strcmp(argv[i], "--kolejka") == 0 && i+1 < argc && strcmp(argv[i+1], "kubelkowa") == 0)
+      rodzaj_kolejki = KOLEJKA_KUBELKOWA;
+    else if(strcmp(argv[i], "--watki") == 0 && i+1 < argc && kryterium_liczbowe(argv[i+1]) && atoi(argv[i+1]) > 0)
+      liczba_watkow = atoi(argv[i+1]);
+    else if(strcmp(argv[i], "--wsadowo") == 0 && i+3 < argc)
+    {
+      plik_bazy = argv[i+1];
+      plik_zapytan = argv[i+2];
+      plik_wynikow = argv[i+3];
+      i += 2;
+    }
+    else if(strcmp(argv[i], "--polecenia") == 0 && i+1 < argc)
+      plik_polecen = argv[i+1];
+    else
+    {
+      printf("nieprawidlowe argumenty programu\n");
+      printf("uzycie: %s [--kolejka kopiec|kubelkowa] "
+             "[--wsadowo baza zapytania wyniki [--watki n] | --polecenia plik|-]\n", argv[0]);
+      printf("       %s --do-binarnego tekstowy binarny | "
+             "--do-tekstowego binarny tekstowy\n", argv[0]);
+      return 1;
+    }
+    i++; /* pomijamy wartosc argumentu */
+  }
+  if(liczba_watkow < 1)
+    liczba_watkow = 1;
+  if(plik_bazy != NULL)
+    return tryb_wsadowy(plik_bazy, plik_zapytan, plik_wynikow, liczba_watkow, rodzaj_kolejki);
+  if(plik_polecen != NULL)
+    return tryb_polecen(plik_polecen, rodzaj_kolejki);
+
+  b = (baza *) malloc(sizeof(baza));
   printf("Program - ksiazka adresowo - spolecznosciowa\n");
   printf("autor: Pawel Ostaszewski\n");
 
   inicjalizacja_bazy(b);
+  inicjalizacja_kontekstu(&kontekst);
+  kontekst.rodzaj_kolejki = rodzaj_kolejki;
+  /* zmiany z poprzedniego uruchomienia (takze te niezapisane przed awaria) */
+  /* sa odtwarzane z dziennika ksiazki ksiazka_adresowa.txt */
+  if((liczba_zmian = otwieranie_dziennika(&dziennik, b, "ksiazka_adresowa.txt")) >= 0)
+    printf("Odtworzono baze z dziennika zmian (%d osob, %ld zmian od ostatniej migawki)\n",
+           b->liczba_elementow, liczba_zmian);
+  else if(b->liczba_elementow > 0)
+    printf("Wczytano ksiazke ksiazka_adresowa.txt (%d osob)\n", b->liczba_elementow);
 
   while(wybor != 11)
   {
@@ -1378,39 +6322,41 @@ int main()
     switch(wybor)
     {
       case 1:
-        dodawanie_osoby(b);
+        dodawanie_osoby(b, &dziennik);
         break;
       case 2:
-        usuwanie_osoby(b);
+        usuwanie_osoby(b, &dziennik);
         break;
       case 3:
-        dodawanie_znajomosci(b);
+        dodawanie_znajomosci(b, &dziennik);
         break;
       case 4:
-        usuwanie_znajomosci(b);
+        usuwanie_znajomosci(b, &dziennik);
         break;
       case 5:
-        zmiana_stopnia_znajomosci(b);
+        zmiana_stopnia_znajomosci(b, &dziennik);
         break;
       case 6:
-        wczytywanie_bazy(b);
+        wczytywanie_bazy(b, &dziennik);
         break;
       case 7:
-        zapisywanie_bazy(b);
+        zapisywanie_bazy(b, &dziennik);
         break;
       case 8:
         wypisywanie_bazy(b);
         break;
       case 9:
-        najkrotsza_sciezka(b);
+        najkrotsza_sciezka(b, &kontekst);
         break;
       case 10:
-        sortowanie(b);
+        sortowanie(b, &dziennik);
         break;
       case 11:
         break;
     }
   }
+  zamykanie_dziennika(&dziennik);
+  zwalnianie_kontekstu(&kontekst);
   zwalnianie_pamieci(b);
   return 0;
 }
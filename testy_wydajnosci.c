@@ -0,0 +1,2569 @@
+/* testy wydajnosciowe ksiazki adresowej - ten plik nie jest kompilowany */
+/* osobno, tylko dolaczany do ksiazka_adresowa.c przy -DTESTY_WYDAJNOSCI, */
+/* wiec korzysta bezposrednio z jej struktur i funkcji */
+
+#include <stdarg.h>
+
+#define LICZBA_ZAPYTAN_TESTOWYCH 5
+/* poprzednia wersja kopca wyszukuje wezel liniowo, wiec dla wiekszych */
+/* grafow pojedyncze zapytanie trwaloby zbyt dlugo */
+#define MAKS_WEZLOW_KOPCA_LINIOWEGO 100000
+
+/* liczba bledow wykrytych przez testy - gdy jest rozna od zera, */
+/* program konczy sie kodem 1 */
+long liczba_bledow_testow = 0;
+
+/* wypisanie komunikatu o bledzie wykrytym przez test (np. wynik rozny */
+/* od wyniku poprzedniej wersji) i doliczenie go do liczby bledow */
+void zglaszanie_bledu_testu(const char *format, ...)
+{
+  va_list argumenty;
+
+  liczba_bledow_testow++;
+  printf("BLAD: ");
+  va_start(argumenty, format);
+  vprintf(format, argumenty);
+  va_end(argumenty);
+}
+
+/* prosty generator liczb pseudolosowych (xorshift) - dla tego samego */
+/* ziarna zawsze otrzymujemy ten sam graf, wiec pomiary sa powtarzalne */
+unsigned int losowa_liczba(unsigned int *stan)
+{
+  unsigned int x = *stan;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *stan = x;
+  return x;
+}
+
+/* tworzenie losowego grafu o n wezlach, w ktorym kazda osoba zawiera */
+/* znajomosc z liczba_znajomych losowymi osobami (stopien znajomosci tez losowy) */
+/* zakladamy ze graf g jest pusty */
+void generowanie_grafu(graf *g, int n, int liczba_znajomych, unsigned int ziarno)
+{
+  char *imiona[] = {"Jan", "Michal", "Jakub", "Anna", "Maria", "Pawel", "Tomasz", "Ewa"};
+  char *nazwiska[] = {"Nowicki", "Glowacki", "Kmicic", "Nowacki", "Kowalski", "Wozniak",
+                      "Matejko", "Pokorski"};
+  wezel *nowy;
+  int i, j;
+
+  for(i = 0; i < n; i++)
+  {
+    nowy = dodawanie_wezla(g, i+1);
+    strcpy(nowy->pierwsze_imie, imiona[losowa_liczba(&ziarno) % 8]);
+    strcpy(nowy->drugie_imie, "_");
+    strcpy(nowy->nazwisko, nazwiska[losowa_liczba(&ziarno) % 8]);
+    nowy->nr_telefonu = 100000000 + losowa_liczba(&ziarno) % 900000000;
+    strcpy(nowy->adres.ulica, "Polna");
+    nowy->adres.nr_domu = 1 + losowa_liczba(&ziarno) % 100;
+    nowy->adres.nr_mieszkania = 1 + losowa_liczba(&ziarno) % 100;
+    strcpy(nowy->adres.kod_pocztowy, "01-234");
+    strcpy(nowy->adres.miasto, "Warszawa");
+    dodawanie_do_indeksu_nazwisk(g, nowy);
+  }
+  g->widoki.nieaktualne = true;
+  g->liczba_elementow = n;
+  g->biezacy_id = n+1;
+
+  for(i = 0; i < n; i++)
+    for(j = 0; j < liczba_znajomych; j++)
+      dodawanie_krawedzi(g, g->sloty[i], g->sloty[losowa_liczba(&ziarno) % n],
+        1 + losowa_liczba(&ziarno) % 10, 1 + losowa_liczba(&ziarno) % 10);
+  /* wyniki -2 (znajomosc juz istnieje) i -1 (wylosowana petla wezel-ten sam */
+  /* wezel) pomijamy, wiec wezly maja srednio niecale 2*liczba_znajomych znajomych */
+}
+
+/* wartosc liczba_znajomych w tabela_testu dla testow, ktore nie korzystaja */
+/* z grafu z generatora */
+#define BEZ_GRAFU -1
+
+/* jeden rozmiar testu wykonywanego przez tabela_testu */
+typedef struct
+{
+  graf g;                         /* graf z generatora */
+  kontekst_wyszukiwania kontekst; /* pusty kontekst wyszukiwania */
+  int n;                          /* rozmiar - liczba osob */
+  int numer;                      /* pozycja rozmiaru w tablicy rozmiarow testu */
+  void *dane;                     /* dane wlasne testu */
+} przebieg_testu;
+
+/* wspolna petla testow wykonywanych dla kilku rozmiarow danych: dla kazdego */
+/* rozmiaru tworzy graf z generatora (kazda osoba zawiera liczba_znajomych */
+/* znajomosci, przy BEZ_GRAFU graf zostaje pusty) i pusty kontekst wyszukiwania, */
+/* wywoluje funkcje pomiar, ktora mierzy obie wersje kodu, wypisuje wiersze */
+/* tabeli i zglasza niezgodne wyniki, a potem zwalnia graf i kontekst */
+void tabela_testu(int *rozmiary, int liczba_rozmiarow, int liczba_znajomych,
+                  void (*pomiar)(przebieg_testu *przebieg), void *dane)
+{
+  przebieg_testu przebieg;
+
+  przebieg.dane = dane;
+  for(przebieg.numer = 0; przebieg.numer < liczba_rozmiarow; przebieg.numer++)
+  {
+    przebieg.n = rozmiary[przebieg.numer];
+    inicjalizacja_bazy(&przebieg.g);
+    inicjalizacja_kontekstu(&przebieg.kontekst);
+    if(liczba_znajomych != BEZ_GRAFU)
+      generowanie_grafu(&przebieg.g, przebieg.n, liczba_znajomych, 12345);
+    pomiar(&przebieg);
+    zwalnianie_kontekstu(&przebieg.kontekst);
+    czyszczenie_bazy(&przebieg.g);
+  }
+}
+
+/* poprzednia wersja kopca - wszystkie wezly grafu trafialy do kopca przed */
+/* rozpoczeciem przeszukiwania, a odleglosci byly ustawiane w calym grafie */
+void budowanie_kopca(graf *g, kontekst_wyszukiwania *kontekst, wezel *zrodlo)
+{
+  kopiec_min *kopiec = &kontekst->kopiec;
+  stan_wezla *stan;
+  wezel *wezelwsk;
+  int i;
+
+  nowe_zapytanie(kontekst, g);
+  if(kopiec->pojemnosc < g->liczba_elementow)
+  {
+    kopiec->pojemnosc = g->liczba_elementow;
+    kopiec->tablica = (element_kopca*) realloc(kopiec->tablica, kopiec->pojemnosc*sizeof(element_kopca));
+  }
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+  {
+    stan = odswiezanie_wezla(kontekst, wezelwsk->slot);
+    if(wezelwsk == zrodlo)
+      stan->odleglosc = 0;
+    stan->pozycja_w_kopcu = kopiec->rozmiar;
+    kopiec->tablica[kopiec->rozmiar].odleglosc = stan->odleglosc;
+    kopiec->tablica[kopiec->rozmiar].slot = wezelwsk->slot;
+    kopiec->rozmiar++;
+  }
+
+  for(i = (int)floor(kopiec->rozmiar/2); i >= 0; i--)
+    przywracanie_kopca(kontekst, i);
+}
+
+/* poprzednia wersja funkcji zmniejsz_odleglosc - wezel jest wyszukiwany */
+/* w tablicy kopca liniowo (zlozonosc O(n)); zostawiona tylko do porownan */
+int zmniejsz_odleglosc_liniowo(kontekst_wyszukiwania *kontekst, int slot, int nowa_odleglosc)
+{
+  kopiec_min *kopiec = &kontekst->kopiec;
+  int i;
+
+  for(i = 0; i < kopiec->rozmiar; i++)
+    if(kopiec->tablica[i].slot == slot)
+      break;
+  if(i == kopiec->rozmiar || nowa_odleglosc > kopiec->tablica[i].odleglosc)
+    return -1;
+  kontekst->stany[slot].odleglosc = nowa_odleglosc;
+  kopiec->tablica[i].odleglosc = nowa_odleglosc;
+  while(i > 0 && kopiec->tablica[PRZODEK(i)].odleglosc > kopiec->tablica[i].odleglosc)
+  {
+    zamiana_elementow_kopca(kontekst, i, PRZODEK(i));
+    i = PRZODEK(i);
+  }
+  return 0;
+}
+
+/* algorytm Dijkstry w wersji z kopcem zawierajacym wszystkie wezly grafu */
+/* jesli liniowo == true to uzywana jest takze poprzednia wersja zmniejsz_odleglosc */
+wezel* algorytm_dijkstry_pelny_kopiec(graf *g, kontekst_wyszukiwania *kontekst,
+                                      wezel *zrodlo, wezel *cel, int tryb, bool liniowo)
+{
+  stan_wezla *min, *stan_sasiada;
+  krawedz *sasiad;
+  int slot_min, nowa_odleglosc;
+
+  budowanie_kopca(g, kontekst, zrodlo);
+  while(kontekst->kopiec.rozmiar > 0)
+  {
+    slot_min = pobierz_minimalny(kontekst);
+    min = &kontekst->stany[slot_min];
+    if(min->odleglosc == INT_MAX)
+      break;
+    for(sasiad = g->sloty[slot_min]->pierwszy; sasiad != NULL; sasiad = sasiad->nastepny)
+    {
+      stan_sasiada = &kontekst->stany[sasiad->cel->slot];
+      if(tryb == 1)
+        nowa_odleglosc = min->odleglosc+1;
+      else
+        nowa_odleglosc = min->odleglosc + (min->liczba_krawedzi+1)*(11-sasiad->waga);
+      if(nowa_odleglosc < stan_sasiada->odleglosc)
+      {
+        if(liniowo)
+          zmniejsz_odleglosc_liniowo(kontekst, sasiad->cel->slot, nowa_odleglosc);
+        else
+          zmniejsz_odleglosc(kontekst, sasiad->cel->slot, nowa_odleglosc);
+        stan_sasiada->poprzednik = slot_min;
+        stan_sasiada->liczba_krawedzi = min->liczba_krawedzi+1;
+      }
+      if(tryb == 1 && sasiad->cel == cel)
+        return cel;
+    }
+  }
+  return (kontekst->stany[cel->slot].odleglosc < INT_MAX)? cel : NULL;
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_kopca */
+void pomiar_kopca(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  kontekst_wyszukiwania *kontekst = &przebieg->kontekst;
+  int q, tryb, n = przebieg->n;
+  unsigned int stan = 2024;
+  wezel *zrodla[LICZBA_ZAPYTAN_TESTOWYCH], *cele[LICZBA_ZAPYTAN_TESTOWYCH];
+  clock_t poczatek;
+  double czas_nowy, czas_stary;
+
+  for(q = 0; q < LICZBA_ZAPYTAN_TESTOWYCH; q++)
+  {
+    zrodla[q] = znajdz_wezel(g, 1 + losowa_liczba(&stan) % n);
+    cele[q] = znajdz_wezel(g, 1 + losowa_liczba(&stan) % n);
+  }
+  for(tryb = 1; tryb <= 2; tryb++)
+  {
+    poczatek = clock();
+    for(q = 0; q < LICZBA_ZAPYTAN_TESTOWYCH; q++)
+      algorytm_dijkstry_pelny_kopiec(g, kontekst, zrodla[q], cele[q], tryb, false);
+    czas_nowy = (double)(clock()-poczatek)/CLOCKS_PER_SEC/LICZBA_ZAPYTAN_TESTOWYCH;
+
+    if(n > MAKS_WEZLOW_KOPCA_LINIOWEGO)
+    {
+      printf("%10d %5d %22.6f %22s\n", n, tryb, czas_nowy, "pominiety");
+      continue;
+    }
+    poczatek = clock();
+    for(q = 0; q < LICZBA_ZAPYTAN_TESTOWYCH; q++)
+      algorytm_dijkstry_pelny_kopiec(g, kontekst, zrodla[q], cele[q], tryb, true);
+    czas_stary = (double)(clock()-poczatek)/CLOCKS_PER_SEC/LICZBA_ZAPYTAN_TESTOWYCH;
+    printf("%10d %5d %22.6f %22.6f\n", n, tryb, czas_nowy, czas_stary);
+  }
+}
+
+/* porownanie kopca z indeksem pozycji i poprzedniej wersji kopca */
+/* na losowych grafach od 10^3 do 10^6 wezlow (kazda osoba ma srednio 6 znajomych) */
+void test_wydajnosci_kopca(void)
+{
+  int rozmiary[] = {1000, 10000, 100000, 1000000};
+
+  printf("Porownanie kopcow w algorytmie Dijkstry (sredni czas zapytania)\n");
+  printf("%10s %5s %22s %22s\n", "wezly", "tryb", "kopiec z indeksem [s]", "kopiec liniowy [s]");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_kopca, NULL);
+}
+
+/* wybor wezla odleglego o co najwyzej liczba_krokow krawedzi od wezla poczatek */
+/* (losowy spacer po grafie, zatrzymywany w wezlach bez znajomych) */
+wezel* losowy_bliski_wezel(wezel *poczatek, int liczba_krokow, unsigned int *stan)
+{
+  krawedz *krawedzwsk;
+  int i, stopien;
+
+  while(liczba_krokow-- > 0)
+  {
+    stopien = 0;
+    for(krawedzwsk = poczatek->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+      stopien++;
+    if(stopien == 0)
+      break;
+    krawedzwsk = poczatek->pierwszy;
+    for(i = losowa_liczba(stan) % stopien; i > 0; i--)
+      krawedzwsk = krawedzwsk->nastepny;
+    poczatek = krawedzwsk->cel;
+  }
+  return poczatek;
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_frontu */
+void pomiar_frontu(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  kontekst_wyszukiwania *kontekst = &przebieg->kontekst;
+  int q, tryb, n = przebieg->n;
+  int liczba_zapytan = 1000;
+  unsigned int stan = 2024;
+  wezel **zrodla, **cele;
+  clock_t poczatek;
+  double czas_front, czas_pelny;
+
+  zrodla = (wezel**) malloc(liczba_zapytan*sizeof(wezel*));
+  cele = (wezel**) malloc(liczba_zapytan*sizeof(wezel*));
+  for(q = 0; q < liczba_zapytan; q++)
+  {
+    zrodla[q] = znajdz_wezel(g, 1 + losowa_liczba(&stan) % n);
+    cele[q] = losowy_bliski_wezel(zrodla[q], 3, &stan);
+  }
+  for(tryb = 1; tryb <= 2; tryb++)
+  {
+    poczatek = clock();
+    for(q = 0; q < liczba_zapytan; q++)
+      algorytm_dijkstry(g, kontekst, zrodla[q], cele[q], tryb);
+    czas_front = (double)(clock()-poczatek)/CLOCKS_PER_SEC/liczba_zapytan;
+
+    poczatek = clock();
+    for(q = 0; q < LICZBA_ZAPYTAN_TESTOWYCH; q++)
+      algorytm_dijkstry_pelny_kopiec(g, kontekst, zrodla[q], cele[q], tryb, false);
+    czas_pelny = (double)(clock()-poczatek)/CLOCKS_PER_SEC/LICZBA_ZAPYTAN_TESTOWYCH;
+    printf("%10d %5d %22.8f %22.8f\n", n, tryb, czas_front, czas_pelny);
+  }
+  free(zrodla);
+  free(cele);
+}
+
+/* porownanie kopca zawierajacego tylko front przeszukiwania z kopcem */
+/* zawierajacym caly graf dla zapytan o osoby odlegle o 3 krawedzie */
+void test_wydajnosci_frontu(void)
+{
+  int rozmiary[] = {10000, 100000, 1000000};
+
+  printf("Zapytania o osoby odlegle o 3 krawedzie (sredni czas zapytania)\n");
+  printf("%10s %5s %22s %22s\n", "wezly", "tryb", "kopiec - front [s]", "kopiec - caly graf [s]");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_frontu, NULL);
+}
+
+/* liczba krawedzi na sciezce zakonczonej w wezle cel (odtwarzanej przez "poprzednik") */
+int dlugosc_sciezki(kontekst_wyszukiwania *kontekst, wezel *cel)
+{
+  int dlugosc = 0, slot;
+  if(cel == NULL)
+    return -1;
+  for(slot = kontekst->stany[cel->slot].poprzednik; slot >= 0; slot = kontekst->stany[slot].poprzednik)
+    dlugosc++;
+  return dlugosc;
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_przeszukiwania_wszerz */
+void pomiar_przeszukiwania_wszerz(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  kontekst_wyszukiwania *kontekst = &przebieg->kontekst;
+  int q, n = przebieg->n, dlugosc, liczba_bledow = 0;
+  int liczba_zapytan = 100;
+  unsigned int stan = 2024;
+  long long odwiedzone_dijkstra = 0, odwiedzone_wszerz = 0;
+  clock_t czas_dijkstra = 0, czas_wszerz = 0, poczatek;
+  wezel *zrodlo, *cel;
+
+  for(q = 0; q < liczba_zapytan; q++)
+  {
+    zrodlo = znajdz_wezel(g, 1 + losowa_liczba(&stan) % n);
+    cel = znajdz_wezel(g, 1 + losowa_liczba(&stan) % n);
+    if(zrodlo == cel)
+      continue;
+    poczatek = clock();
+    dlugosc = dlugosc_sciezki(kontekst, algorytm_dijkstry(g, kontekst, zrodlo, cel, 1));
+    czas_dijkstra += clock()-poczatek;
+    odwiedzone_dijkstra += kontekst->liczba_odwiedzonych;
+
+    poczatek = clock();
+    if(dlugosc_sciezki(kontekst, przeszukiwanie_dwukierunkowe(g, kontekst, zrodlo, cel)) != dlugosc)
+      liczba_bledow++;
+    czas_wszerz += clock()-poczatek;
+    odwiedzone_wszerz += kontekst->liczba_odwiedzonych;
+  }
+  printf("%10d %16.8f %16.8f %18lld %18lld\n", n,
+    (double)czas_dijkstra/CLOCKS_PER_SEC/liczba_zapytan,
+    (double)czas_wszerz/CLOCKS_PER_SEC/liczba_zapytan,
+    odwiedzone_dijkstra/liczba_zapytan, odwiedzone_wszerz/liczba_zapytan);
+  if(liczba_bledow > 0)
+    zglaszanie_bledu_testu("rozne dlugosci sciezek w %d zapytaniach\n", liczba_bledow);
+}
+
+/* porownanie dwukierunkowego przeszukiwania wszerz z algorytmem Dijkstry (tryb == 1) */
+/* dla losowych par osob - sredni czas zapytania i srednia liczba odwiedzonych osob */
+void test_wydajnosci_przeszukiwania_wszerz(void)
+{
+  int rozmiary[] = {10000, 100000, 1000000};
+
+  printf("Najszybsza sciezka: algorytm Dijkstry i dwukierunkowe przeszukiwanie wszerz\n");
+  printf("%10s %16s %16s %18s %18s\n", "wezly", "Dijkstra [s]", "wszerz [s]",
+         "Dijkstra - wezly", "wszerz - wezly");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_przeszukiwania_wszerz,
+               NULL);
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_kolejki_kubelkowej */
+void pomiar_kolejki_kubelkowej(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  kontekst_wyszukiwania *kontekst = &przebieg->kontekst;
+  int q, n = przebieg->n, rodzaj, liczba_bledow = 0;
+  int liczba_zapytan = 20;
+  int *odleglosci;
+  unsigned int stan = 2024;
+  long long odwiedzone[2];
+  double czas[2];
+  clock_t poczatek;
+  wezel **zrodla, **cele, *wynik;
+
+  zrodla = (wezel**) malloc(liczba_zapytan*sizeof(wezel*));
+  cele = (wezel**) malloc(liczba_zapytan*sizeof(wezel*));
+  odleglosci = (int*) malloc(liczba_zapytan*sizeof(int));
+  for(q = 0; q < liczba_zapytan; q++)
+  {
+    zrodla[q] = znajdz_wezel(g, 1 + losowa_liczba(&stan) % n);
+    cele[q] = znajdz_wezel(g, 1 + losowa_liczba(&stan) % n);
+  }
+  for(rodzaj = 0; rodzaj < 2; rodzaj++)
+  {
+    kontekst->rodzaj_kolejki = (rodzaj == 0)? KOLEJKA_KOPIEC : KOLEJKA_KUBELKOWA;
+    odwiedzone[rodzaj] = 0;
+    poczatek = clock();
+    for(q = 0; q < liczba_zapytan; q++)
+    {
+      wynik = algorytm_dijkstry(g, kontekst, zrodla[q], cele[q], 2);
+      odwiedzone[rodzaj] += kontekst->liczba_odwiedzonych;
+      if(rodzaj == 0)
+        odleglosci[q] = (wynik == NULL)? -1 : kontekst->stany[wynik->slot].odleglosc;
+      else if(odleglosci[q] != ((wynik == NULL)? -1 : kontekst->stany[wynik->slot].odleglosc))
+        liczba_bledow++;
+    }
+    czas[rodzaj] = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+  }
+  printf("%10d %16.2f %16.2f %20.0f %20.0f\n", n,
+    liczba_zapytan/czas[0], liczba_zapytan/czas[1],
+    odwiedzone[0]/czas[0], odwiedzone[1]/czas[1]);
+  if(liczba_bledow > 0)
+    zglaszanie_bledu_testu("rozne koszty sciezek w %d zapytaniach\n", liczba_bledow);
+  free(zrodla);
+  free(cele);
+  free(odleglosci);
+}
+
+/* porownanie kopca i kolejki kubelkowej przy wyszukiwaniu najskuteczniejszej */
+/* sciezki (tryb == 2) miedzy losowymi osobami w duzych grafach */
+void test_wydajnosci_kolejki_kubelkowej(void)
+{
+  int rozmiary[] = {100000, 1000000, 2000000};
+
+  printf("Najskuteczniejsza sciezka: kopiec i kolejka kubelkowa\n");
+  printf("%10s %16s %16s %20s %20s\n", "wezly", "kopiec [zap/s]", "kubelki [zap/s]",
+         "kopiec [wezly/s]", "kubelki [wezly/s]");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_kolejki_kubelkowej,
+               NULL);
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_wielu_celow */
+void pomiar_wielu_celow(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  kontekst_wyszukiwania *kontekst = &przebieg->kontekst;
+  int liczby_celow[] = {10, 100, 1000};
+  int j, t, tryb, n = przebieg->n, m, liczba_bledow;
+  int *odleglosci;
+  unsigned int stan;
+  double czas[2];
+  clock_t poczatek;
+  wezel **cele, *zrodlo, *wynik;
+
+  for(j = 0; j < 3; j++)
+  {
+    m = liczby_celow[j];
+    cele = (wezel**) malloc(m*sizeof(wezel*));
+    odleglosci = (int*) malloc(m*sizeof(int));
+    stan = 77;
+    zrodlo = g->sloty[losowa_liczba(&stan) % n];
+    for(t = 0; t < m; t++)
+      cele[t] = losowy_bliski_wezel(zrodlo, 1 + losowa_liczba(&stan) % 4, &stan);
+    for(tryb = 1; tryb <= 2; tryb++)
+    {
+      liczba_bledow = 0;
+      poczatek = clock();
+      for(t = 0; t < m; t++)
+      {
+        wynik = (cele[t] == zrodlo)? zrodlo : algorytm_dijkstry(g, kontekst, zrodlo, cele[t], tryb);
+        odleglosci[t] = (wynik == NULL)? -1 : kontekst->stany[wynik->slot].odleglosc;
+        if(cele[t] == zrodlo)
+          odleglosci[t] = 0;
+      }
+      czas[0] = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+
+      poczatek = clock();
+      algorytm_dijkstry_wiele_celow(g, kontekst, zrodlo, cele, m, tryb);
+      czas[1] = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+      for(t = 0; t < m; t++)
+        if(odleglosci[t] != (wezel_osiagniety(kontekst, cele[t])?
+                             kontekst->stany[cele[t]->slot].odleglosc : -1))
+          liczba_bledow++;
+
+      printf("%10d %6d %6d %18.6f %18.6f %9.1fx\n", n, tryb, m, czas[0], czas[1],
+        (czas[1] > 0)? czas[0]/czas[1] : 0.0);
+      if(liczba_bledow > 0)
+        zglaszanie_bledu_testu("rozne odleglosci dla %d celow\n", liczba_bledow);
+    }
+    free(cele);
+    free(odleglosci);
+  }
+}
+
+/* porownanie osobnych wyszukiwan dla kazdego celu z jednym wyszukiwaniem */
+/* do wielu celow (osoby odlegle o co najwyzej 4 krawedzie od zrodla) */
+void test_wydajnosci_wielu_celow(void)
+{
+  int rozmiary[] = {100000, 1000000};
+
+  printf("Wyszukiwanie z jednego zrodla do wielu celow\n");
+  printf("%10s %6s %6s %18s %18s %10s\n", "wezly", "tryb", "cele",
+         "osobno [s]", "razem [s]", "zysk");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_wielu_celow, NULL);
+}
+
+/* poprzednia wersja algorytmu Dijkstry - sasiedzi sa czytani z list krawedzi */
+/* zamiast z migawki CSR; zostawiona tylko do porownan */
+wezel* algorytm_dijkstry_na_listach(graf *g, kontekst_wyszukiwania *kontekst,
+                                    wezel *zrodlo, wezel *cel, int tryb)
+{
+  stan_wezla *min, *stan_sasiada;
+  krawedz *sasiad;
+  int slot_min, koszt;
+
+  nowe_zapytanie(kontekst, g);
+  odswiezanie_wezla(kontekst, zrodlo->slot)->odleglosc = 0;
+  wstawianie_do_kopca(kontekst, zrodlo->slot);
+  while(kontekst->kopiec.rozmiar > 0)
+  {
+    slot_min = pobierz_minimalny(kontekst);
+    min = &kontekst->stany[slot_min];
+    if(slot_min == cel->slot)
+      return cel;
+    for(sasiad = g->sloty[slot_min]->pierwszy; sasiad != NULL; sasiad = sasiad->nastepny)
+    {
+      stan_sasiada = odswiezanie_wezla(kontekst, sasiad->cel->slot);
+      koszt = (tryb == 1)? min->odleglosc+1 :
+              min->odleglosc + (min->liczba_krawedzi+1)*(11-sasiad->waga);
+      if(koszt < stan_sasiada->odleglosc)
+      {
+        aktualizacja_odleglosci(kontekst, sasiad->cel->slot, koszt);
+        stan_sasiada->poprzednik = slot_min;
+        stan_sasiada->liczba_krawedzi = min->liczba_krawedzi+1;
+      }
+      if(tryb == 1 && sasiad->cel == cel)
+        return cel;
+    }
+  }
+  return NULL;
+}
+
+/* losowa osoba sposrod tych, ktore zostaly jeszcze w grafie o ids 1..n */
+wezel* losowy_istniejacy_wezel(graf *g, int n, unsigned int *stan)
+{
+  wezel *wezelwsk;
+
+  while((wezelwsk = znajdz_wezel(g, 1 + losowa_liczba(stan) % n)) == NULL)
+    ;
+  return wezelwsk;
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_migawki; w dane - tablica czasow zmian */
+/* [rozmiar][wariant] do tabeli wypisywanej po wszystkich rozmiarach */
+void pomiar_migawki(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  kontekst_wyszukiwania *kontekst = &przebieg->kontekst;
+  double (*czas_zmian)[2] = przebieg->dane;
+  int q, n = przebieg->n, tryb, liczba_bledow, wariant;
+  int liczba_zapytan = 20, liczba_zmian = 200;
+  int *odleglosci;
+  unsigned int stan = 99;
+  double czas[2], czas_budowy;
+  clock_t poczatek;
+  wezel **zrodla, **cele, *wynik, *wezel1, *wezel2;
+
+  zrodla = (wezel**) malloc(liczba_zapytan*sizeof(wezel*));
+  cele = (wezel**) malloc(liczba_zapytan*sizeof(wezel*));
+  odleglosci = (int*) malloc(liczba_zapytan*sizeof(int));
+  poczatek = clock();
+  aktualizacja_migawki(g);
+  czas_budowy = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+  for(q = 0; q < liczba_zapytan; q++)
+  {
+    zrodla[q] = g->sloty[losowa_liczba(&stan) % n];
+    cele[q] = g->sloty[losowa_liczba(&stan) % n];
+  }
+  /* pierwsze zapytanie alokuje tablice kontekstu - nie wliczamy go do pomiaru */
+  algorytm_dijkstry(g, kontekst, zrodla[0], cele[0], 2);
+  for(tryb = 1; tryb <= 2; tryb++)
+  {
+    liczba_bledow = 0;
+    poczatek = clock();
+    for(q = 0; q < liczba_zapytan; q++)
+    {
+      wynik = algorytm_dijkstry_na_listach(g, kontekst, zrodla[q], cele[q], tryb);
+      odleglosci[q] = (wynik == NULL)? -1 : kontekst->stany[wynik->slot].odleglosc;
+    }
+    czas[0] = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+    poczatek = clock();
+    for(q = 0; q < liczba_zapytan; q++)
+    {
+      wynik = algorytm_dijkstry(g, kontekst, zrodla[q], cele[q], tryb);
+      if(odleglosci[q] != ((wynik == NULL)? -1 : kontekst->stany[wynik->slot].odleglosc))
+        liczba_bledow++;
+    }
+    czas[1] = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+    printf("%10d %6d %14.3f %14.3f %14.3f\n", n, tryb, 1e3*czas[0]/liczba_zapytan,
+      1e3*czas[1]/liczba_zapytan, 1e3*czas_budowy);
+    if(liczba_bledow > 0)
+      zglaszanie_bledu_testu("rozne koszty sciezek w %d zapytaniach\n", liczba_bledow);
+  }
+
+  /* kazda zmiana to usuniecie osoby i nowa znajomosc, po niej jedno zapytanie */
+  for(wariant = 0; wariant < 2; wariant++)
+  {
+    poczatek = clock();
+    for(q = 0; q < liczba_zmian; q++)
+    {
+      usuwanie_wezla(g, losowy_istniejacy_wezel(g, n, &stan)->id);
+      wezel1 = losowy_istniejacy_wezel(g, n, &stan);
+      wezel2 = losowy_istniejacy_wezel(g, n, &stan);
+      dodawanie_krawedzi(g, wezel1, wezel2, 5, 5);
+      if(wariant == 0)
+        g->migawka.nieaktualna = true;
+      algorytm_dijkstry(g, kontekst, losowy_istniejacy_wezel(g, n, &stan),
+                        losowy_istniejacy_wezel(g, n, &stan), 1);
+    }
+    czas_zmian[przebieg->numer][wariant] = (double)(clock()-poczatek)/CLOCKS_PER_SEC / liczba_zmian;
+  }
+  /* migawka po naniesionych zmianach musi dawac te same wyniki co zbudowana od nowa */
+  liczba_bledow = 0;
+  for(q = 0; q < liczba_zapytan; q++)
+  {
+    zrodla[q] = losowy_istniejacy_wezel(g, n, &stan);
+    cele[q] = losowy_istniejacy_wezel(g, n, &stan);
+    for(tryb = 1; tryb <= 2; tryb++)
+    {
+      wynik = algorytm_dijkstry(g, kontekst, zrodla[q], cele[q], tryb);
+      odleglosci[q] = (wynik == NULL)? -1 : kontekst->stany[wynik->slot].odleglosc;
+      g->migawka.nieaktualna = true;
+      wynik = algorytm_dijkstry(g, kontekst, zrodla[q], cele[q], tryb);
+      if(odleglosci[q] != ((wynik == NULL)? -1 : kontekst->stany[wynik->slot].odleglosc))
+        liczba_bledow++;
+    }
+  }
+  if(liczba_bledow > 0)
+    zglaszanie_bledu_testu("migawka po zmianach daje inne koszty w %d zapytaniach\n",
+                           liczba_bledow);
+  free(zrodla);
+  free(cele);
+  free(odleglosci);
+}
+
+/* porownanie wyszukiwania na listach krawedzi i na migawce CSR oraz */
+/* pamieci zajmowanej przez jedna krawedz w obu reprezentacjach; na koniec */
+/* zmiany przeplatane z zapytaniami - migawka budowana od nowa po kazdej */
+/* zmianie (jak wczesniej) i zmiany nanoszone na migawke */
+void test_wydajnosci_migawki(void)
+{
+  int rozmiary[] = {100000, 1000000};
+  int i, liczba_rozmiarow = sizeof(rozmiary)/sizeof(rozmiary[0]);
+  double czas_zmian[2][2];
+
+  printf("Wyszukiwanie na listach krawedzi i na migawce CSR (czas na zapytanie)\n");
+  printf("pamiec na krawedz: lista %d B (+ naglowek malloc), CSR %d B "
+         "(+ %d B na wezel)\n", (int)sizeof(krawedz),
+         (int)(sizeof(int) + sizeof(unsigned char)), (int)sizeof(int));
+  printf("%10s %6s %14s %14s %14s\n", "wezly", "tryb", "listy [ms]", "CSR [ms]", "budowa [ms]");
+  tabela_testu(rozmiary, liczba_rozmiarow, 3, pomiar_migawki, czas_zmian);
+  printf("Zmiana i zapytanie na przemian (czas na pare)\n");
+  printf("%10s %20s %20s %10s\n", "wezly", "budowa od nowa [ms]", "nanoszenie [ms]", "zysk");
+  for(i = 0; i < liczba_rozmiarow; i++)
+    printf("%10d %20.3f %20.3f %9.1fx\n", rozmiary[i], 1e3*czas_zmian[i][0],
+      1e3*czas_zmian[i][1], (czas_zmian[i][1] > 0)? czas_zmian[i][0]/czas_zmian[i][1] : 0.0);
+}
+
+/* poprzedni sposob wyszukiwania krawedzi - przegladanie calej listy krawedzi */
+/* wezla; zostawiony tylko do porownan */
+krawedz* znajdz_krawedz_liniowo(wezel *wezel1, wezel *wezel2)
+{
+  krawedz *krawedzwsk;
+
+  for(krawedzwsk = wezel1->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+    if(krawedzwsk->cel == wezel2)
+      return krawedzwsk;
+  return NULL;
+}
+
+/* operacje na znajomosciach osoby o bardzo duzej liczbie znajomych: wyszukiwanie */
+/* krawedzi przez przegladanie listy i w zbiorze sasiadow, zmiana stopnia */
+/* znajomosci oraz usuwanie i ponowne dodawanie znajomosci */
+void test_wydajnosci_stopnia(void)
+{
+  int stopnie[] = {1000, 10000, 100000};
+  int i, j, q, d, liczba_bledow;
+  int liczba_operacji = 100000;
+  unsigned int stan;
+  double czas[4];
+  clock_t poczatek;
+  wezel *osoba, *znajomy;
+  graf g;
+
+  printf("Operacje na znajomosciach osoby o duzym stopniu [operacje/s]\n");
+  printf("%10s %16s %16s %16s %16s\n", "stopien", "lista", "zbior",
+         "zmiana wagi", "usun+dodaj");
+  for(i = 0; i < 3; i++)
+  {
+    d = stopnie[i];
+    inicjalizacja_bazy(&g);
+    generowanie_grafu(&g, d+1, 0, 12345);
+    osoba = g.sloty[0];
+    for(j = 1; j <= d; j++)
+      dodawanie_krawedzi(&g, osoba, g.sloty[j], 1 + j % 10, 1 + j % 10);
+
+    liczba_bledow = 0;
+    stan = 3;
+    /* przegladanie listy jest O(d), wiec wykonujemy mniej operacji */
+    poczatek = clock();
+    for(q = 0; q < liczba_operacji/100; q++)
+      if(znajdz_krawedz_liniowo(osoba, g.sloty[1 + losowa_liczba(&stan) % d]) == NULL)
+        liczba_bledow++;
+    czas[0] = (double)(clock()-poczatek)/CLOCKS_PER_SEC / (liczba_operacji/100);
+    poczatek = clock();
+    for(q = 0; q < liczba_operacji; q++)
+      if(znajdz_krawedz(osoba, g.sloty[1 + losowa_liczba(&stan) % d]) == NULL)
+        liczba_bledow++;
+    czas[1] = (double)(clock()-poczatek)/CLOCKS_PER_SEC / liczba_operacji;
+    aktualizacja_migawki(&g);
+    poczatek = clock();
+    for(q = 0; q < liczba_operacji; q++)
+      if(zmiana_wagi_krawedzi(&g, osoba, g.sloty[1 + losowa_liczba(&stan) % d], 1 + q % 10) != 0)
+        liczba_bledow++;
+    czas[2] = (double)(clock()-poczatek)/CLOCKS_PER_SEC / liczba_operacji;
+    poczatek = clock();
+    for(q = 0; q < liczba_operacji; q++)
+    {
+      znajomy = g.sloty[1 + losowa_liczba(&stan) % d];
+      if(usuwanie_krawedzi(&g, osoba->id, znajomy->id) != 0 ||
+         dodawanie_krawedzi(&g, osoba, znajomy, 5, 5) != 0)
+        liczba_bledow++;
+    }
+    czas[3] = (double)(clock()-poczatek)/CLOCKS_PER_SEC / liczba_operacji;
+
+    printf("%10d %16.0f %16.0f %16.0f %16.0f\n", d, 1/czas[0], 1/czas[1], 1/czas[2], 1/czas[3]);
+    if(liczba_bledow > 0 || osoba->stopien != d)
+      zglaszanie_bledu_testu("nieudane operacje na znajomosciach (%d)\n", liczba_bledow);
+    czyszczenie_bazy(&g);
+  }
+}
+
+/* poprzedni sposob usuwania wezla - krawedzie wchodzace byly szukane u kazdego */
+/* wezla grafu; zostawiony tylko do porownan */
+int usuwanie_wezla_przegladaniem_grafu(graf *g, int id)
+{
+  wezel *usuwany, *wezelwsk;
+  krawedz *krawedzwsk;
+
+  if((usuwany = znajdz_wezel(g, id)) == NULL)
+    return -1;
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+    if(wezelwsk != usuwany && (krawedzwsk = znajdz_krawedz(wezelwsk, usuwany)) != NULL)
+    {
+      krawedzwsk->blizniacza->blizniacza = NULL;
+      odlaczanie_krawedzi(wezelwsk, krawedzwsk);
+      zwracanie_do_puli(&g->pula_krawedzi, krawedzwsk);
+    }
+  /* krawedzie wychodzace nie maja juz blizniaczych, wiec usuwanie_wezla */
+  /* zwolni tylko je i sam wezel */
+  return usuwanie_wezla(g, id);
+}
+
+/* liczba krawedzi bez krawedzi blizniaczej albo takich, ktorych krawedz blizniacza */
+/* nie jest krawedzia powrotna z para w te krawedz (np. zle polaczonych przy */
+/* wczytywaniu rownoleglym) lub prowadzi do osoby spoza grafu */
+long bledne_krawedzie_blizniacze(graf *g)
+{
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+  long liczba_bledow = 0;
+
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+    for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+      if(krawedzwsk->blizniacza == NULL || krawedzwsk->blizniacza->blizniacza != krawedzwsk ||
+         krawedzwsk->blizniacza->cel != wezelwsk ||
+         znajdz_wezel(g, krawedzwsk->cel->id) != krawedzwsk->cel)
+        liczba_bledow++;
+  return liczba_bledow;
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_usuwania */
+void pomiar_usuwania(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  char *nazwa_pliku = "test_wydajnosci_usuwania.txt";
+  int q, n = przebieg->n, id, liczba_bledow = 0;
+  int liczba_watkow = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  int liczba_usuniec[2];
+  unsigned int stan = 5;
+  double czas[2];
+  clock_t poczatek;
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+
+  if(liczba_watkow < 2)
+    liczba_watkow = 2;
+  /* u co setnej osoby pierwsza znajomosc zostaje tylko po jej stronie */
+  for(q = 0; q < n/100; q++)
+  {
+    wezelwsk = g->sloty[losowa_liczba(&stan) % n];
+    if((krawedzwsk = wezelwsk->pierwszy) != NULL && krawedzwsk->blizniacza != NULL)
+    {
+      odlaczanie_krawedzi(krawedzwsk->cel, krawedzwsk->blizniacza);
+      zwracanie_do_puli(&g->pula_krawedzi, krawedzwsk->blizniacza);
+      krawedzwsk->blizniacza = NULL;
+    }
+  }
+  if(zapisywanie_bazy_do_pliku(g, nazwa_pliku) == -1 ||
+     wczytywanie_bazy_z_pliku_watkami(g, nazwa_pliku,
+                                      (przebieg->numer == 0)? 1 : liczba_watkow) == -1)
+  {
+    zglaszanie_bledu_testu("nie udalo sie zapisac lub wczytac pliku %s\n", nazwa_pliku);
+    remove(nazwa_pliku);
+    return;
+  }
+  remove(nazwa_pliku);
+  if(bledne_krawedzie_blizniacze(g) != 0)
+    zglaszanie_bledu_testu("znajomosci zapisane u jednej osoby nie maja krawedzi powrotnych\n");
+  /* przegladanie grafu jest O(V), wiec usuwamy mniej osob */
+  liczba_usuniec[0] = 10000000 / n;
+  liczba_usuniec[1] = n / 10;
+  poczatek = clock();
+  for(q = 0; q < liczba_usuniec[0]; q++)
+  {
+    do /* losujemy osobe, ktora nie zostala jeszcze usunieta */
+      id = 1 + losowa_liczba(&stan) % n;
+    while(znajdz_wezel(g, id) == NULL);
+    if(usuwanie_wezla_przegladaniem_grafu(g, id) != 0)
+      liczba_bledow++;
+  }
+  czas[0] = (double)(clock()-poczatek)/CLOCKS_PER_SEC / liczba_usuniec[0];
+  poczatek = clock();
+  for(q = 0; q < liczba_usuniec[1]; q++)
+  {
+    do
+      id = 1 + losowa_liczba(&stan) % n;
+    while(znajdz_wezel(g, id) == NULL);
+    if(usuwanie_wezla(g, id) != 0)
+      liczba_bledow++;
+  }
+  czas[1] = (double)(clock()-poczatek)/CLOCKS_PER_SEC / liczba_usuniec[1];
+
+  printf("%10d %16.0f %16.0f\n", n, 1/czas[0], 1/czas[1]);
+  if(liczba_bledow > 0)
+    zglaszanie_bledu_testu("nieudane usuwanie osob (%d)\n", liczba_bledow);
+  if(bledne_krawedzie_blizniacze(g) != 0)
+    zglaszanie_bledu_testu("po usunieciu osob zostaly krawedzie bez pary\n");
+}
+
+/* usuwanie losowych osob z grafow o 10^4 - 10^6 osobach: przegladanie calego */
+/* grafu vs. przejscie po krawedziach blizniaczych; czesc znajomosci w grafie */
+/* jest zapisana w pliku tylko u jednej osoby - po wczytaniu (jednym watkiem */
+/* dla najmniejszego grafu, a wieloma dla pozostalych) i po usunieciach kazda */
+/* krawedz musi miec krawedz blizniacza */
+void test_wydajnosci_usuwania(void)
+{
+  int rozmiary[] = {10000, 100000, 1000000};
+
+  printf("Usuwanie osoby (srednio ok. 6 znajomych) [usuniecia/s]\n");
+  printf("%10s %16s %16s\n", "osoby", "caly graf", "blizniacze");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_usuwania, NULL);
+}
+
+/* poprzedni sposob sprawdzania, czy osoba o danym imieniu i nazwisku jest juz */
+/* w bazie - przegladanie listy wszystkich osob; zostawiony tylko do porownan */
+wezel* znajdz_osobe_przegladaniem_listy(graf *g, const char *pierwsze_imie, const char *nazwisko)
+{
+  wezel *wezelwsk;
+
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+    if(strcmp(wezelwsk->pierwsze_imie, pierwsze_imie) == 0 &&
+       strcmp(wezelwsk->nazwisko, nazwisko) == 0)
+      return wezelwsk;
+  return NULL;
+}
+
+/* nazwisko utworzone z liczby k (cyfry zapisane literami), rozne dla roznych k */
+void nazwisko_testowe(int k, char *nazwisko)
+{
+  int i = 0;
+
+  nazwisko[i++] = 'N';
+  do
+  {
+    nazwisko[i++] = 'a' + k % 26;
+    k /= 26;
+  }
+  while(k > 0);
+  nazwisko[i] = '\0';
+}
+
+/* dodanie osoby tak jak w dodawanie_osoby: jesli osoba o tym imieniu i nazwisku */
+/* jest juz w bazie, to tylko zmieniamy jej telefon; funkcja zwraca true, gdy */
+/* dodano nowa osobe */
+bool dodawanie_osoby_testowej(graf *g, char *pierwsze_imie, char *nazwisko, bool przez_indeks)
+{
+  wezel *wezelwsk;
+
+  wezelwsk = przez_indeks? znajdz_osobe(g, pierwsze_imie, nazwisko) :
+                           znajdz_osobe_przegladaniem_listy(g, pierwsze_imie, nazwisko);
+  if(wezelwsk != NULL)
+  {
+    wezelwsk->nr_telefonu++;
+    return false;
+  }
+  g->liczba_elementow++;
+  wezelwsk = dodawanie_wezla(g, g->biezacy_id++);
+  strcpy(wezelwsk->pierwsze_imie, pierwsze_imie);
+  strcpy(wezelwsk->drugie_imie, "_");
+  strcpy(wezelwsk->nazwisko, nazwisko);
+  wezelwsk->nr_telefonu = 100000000;
+  wezelwsk->adres = g->zrodlo->adres;
+  dodawanie_do_indeksu_nazwisk(g, wezelwsk);
+  dodawanie_do_widokow(g, wezelwsk);
+  return true;
+}
+
+/* sprawdzenie indeksu nazwisk: osoby na kazdej liscie imiennikow maja to samo */
+/* imie i nazwisko co pierwsza osoba listy (ktora znajduje znajdz_osobe), a kazda */
+/* osoba grafu jest na dokladnie jednej liscie; zwraca liczbe bledow */
+int sprawdzanie_indeksu_nazwisk(graf *g)
+{
+  wezel *pierwszy, *imiennik;
+  char *odwiedzone = (char*) calloc(g->liczba_slotow + 1, 1);
+  int liczba_bledow = 0, liczba_osob = 0, i;
+
+  for(i = 0; i < g->nazwiska.pojemnosc; i++)
+  {
+    if((pierwszy = g->nazwiska.tablica[i]) == NULL)
+      continue;
+    if(znajdz_osobe(g, pierwszy->pierwsze_imie, pierwszy->nazwisko) != pierwszy)
+      liczba_bledow++;
+    for(imiennik = pierwszy; imiennik != NULL; imiennik = imiennik->nastepny_imiennik)
+    {
+      if(strcmp(imiennik->pierwsze_imie, pierwszy->pierwsze_imie) != 0 ||
+         strcmp(imiennik->nazwisko, pierwszy->nazwisko) != 0 ||
+         imiennik->slot >= g->liczba_slotow || g->sloty[imiennik->slot] != imiennik ||
+         odwiedzone[imiennik->slot]++ > 0)
+        liczba_bledow++;
+      liczba_osob++;
+    }
+  }
+  free(odwiedzone);
+  return liczba_bledow + abs(liczba_osob - g->liczba_elementow);
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_nazwisk */
+void pomiar_nazwisk(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  char *imiona[] = {"Jan", "Anna"};
+  char nazwisko[16];
+  int q, n = przebieg->n, id, liczba_bledow, liczba_znalezionych = 0;
+  int liczba_prob[2];
+  unsigned int stan = 7;
+  double czas[3];
+  clock_t poczatek;
+
+  aktualizacja_widokow(g);
+  /* przegladanie listy jest O(V), wiec dodajemy mniej osob */
+  liczba_prob[0] = 20000000 / n;
+  liczba_prob[1] = n / 2;
+  for(q = 0; q < 2; q++)
+  {
+    poczatek = clock();
+    for(id = 0; id < liczba_prob[q]; id++)
+    {
+      nazwisko_testowe(id/2 + q*n, nazwisko);
+      dodawanie_osoby_testowej(g, imiona[id % 2 == 0 ? 0 : losowa_liczba(&stan) % 2],
+                               nazwisko, q == 1);
+    }
+    czas[q] = (double)(clock()-poczatek)/CLOCKS_PER_SEC / liczba_prob[q];
+  }
+  poczatek = clock();
+  for(q = 0; q < 1000000; q++)
+  {
+    nazwisko_testowe(n + losowa_liczba(&stan) % n, nazwisko);
+    liczba_znalezionych += (znajdz_osobe(g, imiona[q % 2], nazwisko) != NULL);
+  }
+  czas[2] = (double)(clock()-poczatek)/CLOCKS_PER_SEC / 1000000;
+
+  for(q = 0; q < n/10; q++)
+  {
+    do
+      id = 1 + losowa_liczba(&stan) % g->biezacy_id;
+    while(znajdz_wezel(g, id) == NULL);
+    usuwanie_wezla(g, id);
+    g->liczba_elementow--;
+  }
+  liczba_bledow = sprawdzanie_indeksu_nazwisk(g) + (liczba_znalezionych == 0);
+
+  printf("%10d %16.0f %16.0f %16.0f\n", n, 1/czas[0], 1/czas[1], 1/czas[2]);
+  if(liczba_bledow > 0)
+    zglaszanie_bledu_testu("indeks nazwisk nie zgadza sie z grafem (%d)\n", liczba_bledow);
+}
+
+/* dodawanie nowych osob do grafow 10^4 - 10^6 osob (generowanych z 64 par imie - */
+/* nazwisko, wiec imiennikow jest duzo) ze sprawdzaniem, czy osoba juz istnieje, */
+/* przez przegladanie listy osob i przez indeks nazwisk (czesc prob dotyczy osob, */
+/* ktore juz sa w bazie), potem szukanie osob po imieniu i nazwisku; na koniec */
+/* usuwamy czesc osob i sprawdzamy indeks */
+void test_wydajnosci_nazwisk(void)
+{
+  int rozmiary[] = {10000, 100000, 1000000};
+
+  printf("Dodawanie osoby ze sprawdzeniem imienia i nazwiska [dodania/s]\n");
+  printf("%10s %16s %16s %16s\n", "osoby", "lista osob", "indeks", "szukanie [1/s]");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_nazwisk, NULL);
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_widokow */
+void pomiar_widokow(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  char *nazwiska[] = {"Glowacki", "kowalski", "Matejko", "Nowak", "Nowicki", "Zielinski"};
+  int q, n = przebieg->n, id, liczba_bledow = 0, liczba_zmian;
+  unsigned int stan;
+  double czas[5];
+  wezel *wezelwsk, *w_widoku, wzor;
+
+  strcpy(wzor.pierwsze_imie, "");
+  czas[0] = czas_zegarowy();
+  g->zrodlo = sortowanie_listy_osob(g->zrodlo, g->liczba_elementow, 3);
+  odtwarzanie_poprzednikow(g);
+  czas[0] = czas_zegarowy() - czas[0];
+  czas[1] = czas_zegarowy();
+  aktualizacja_widokow(g);
+  czas[1] = czas_zegarowy() - czas[1];
+  czas[2] = czas_zegarowy();
+  w_widoku = pierwszy_w_widoku(g, 3);
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+  {
+    if(w_widoku == NULL || porownywanie(w_widoku, wezelwsk, 3) != 0)
+      liczba_bledow++;
+    if(w_widoku != NULL)
+      w_widoku = nastepny_w_widoku(w_widoku, 3);
+  }
+  czas[2] = czas_zegarowy() - czas[2];
+
+  stan = 3;
+  wzor.id = 0;
+  czas[3] = czas_zegarowy();
+  for(q = 0; q < 10000; q++)
+  {
+    strcpy(wzor.nazwisko, nazwiska[losowa_liczba(&stan) % 6]);
+    wzor.nazwisko[1 + losowa_liczba(&stan) % 4] = '\0';
+    ustawianie_kluczy_sortowania(&wzor);
+    w_widoku = szukanie_w_widoku(g, &wzor, 3);
+    for(id = 0; id < 20 && w_widoku != NULL; id++)
+    {
+      if(porownywanie_w_widoku(w_widoku, &wzor, 3) < 0)
+        liczba_bledow++;
+      w_widoku = nastepny_w_widoku(w_widoku, 3);
+    }
+  }
+  czas[3] = (czas_zegarowy() - czas[3]) / 10000;
+
+  liczba_zmian = 100000;
+  czas[4] = czas_zegarowy();
+  for(q = 0; q < liczba_zmian; q++)
+  {
+    wezelwsk = g->sloty[losowa_liczba(&stan) % n];
+    usuwanie_z_widokow(g, wezelwsk);
+    dodawanie_do_widokow(g, wezelwsk);
+  }
+  czas[4] = (czas_zegarowy() - czas[4]) / liczba_zmian;
+  for(q = 1, w_widoku = pierwszy_w_widoku(g, 3); w_widoku != NULL; q++)
+  {
+    wezelwsk = nastepny_w_widoku(w_widoku, 3);
+    if(wezelwsk != NULL && porownywanie_w_widoku(w_widoku, wezelwsk, 3) >= 0)
+      liczba_bledow++;
+    w_widoku = wezelwsk;
+  }
+
+  printf("%10d %14.2f %14.2f %14.2f %14.4f %14.0f\n", n, 1e3*czas[0], 1e3*czas[1],
+         1e3*czas[2], 1e3*czas[3], 1/czas[4]);
+  if(liczba_bledow > 0 || q-1 != n)
+    zglaszanie_bledu_testu("niepoprawna kolejnosc osob w widoku (%d)\n", liczba_bledow);
+}
+
+/* kolejnosc osob wedlug nazwisk w grafach 10^4 - 10^6 osob: sortowanie calej */
+/* listy przed kazdym wypisaniem (poprzednia wersja wypisywanie_bazy) vs. widok */
+/* wedlug nazwisk - jednorazowe zbudowanie, przejscie po widoku, strona 20 osob */
+/* od losowego nazwiska oraz usuniecie i ponowne dodanie osoby do widokow */
+void test_wydajnosci_widokow(void)
+{
+  int rozmiary[] = {10000, 100000, 1000000};
+
+  printf("Osoby w kolejnosci nazwisk [ms], zmiany widokow [1/s]\n");
+  printf("%10s %14s %14s %14s %14s %14s\n", "osoby", "sortowanie", "budowanie",
+         "przejscie", "strona 20", "usun.+dod.");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_widokow, NULL);
+}
+
+/* poprzedni sposob porownywania nazwisk w tablicy - string_compare na calych */
+/* napisach bez kluczy sortowania; zostawiony tylko do porownan */
+int porownywanie_nazwisk_bez_kluczy(const void *a, const void *b)
+{
+  return string_compare((*(wezel**)a)->nazwisko, (*(wezel**)b)->nazwisko);
+}
+
+int porownywanie_nazwisk_kluczami(const void *a, const void *b)
+{
+  return porownywanie(*(wezel**)a, *(wezel**)b, 3);
+}
+
+int porownywanie_id(const void *a, const void *b)
+{
+  return porownywanie(*(wezel**)a, *(wezel**)b, 1);
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_kluczy; w dane - stan generatora liczb */
+/* pseudolosowych wspolny dla wszystkich rozmiarow */
+void pomiar_kluczy(przebieg_testu *przebieg)
+{
+  char *sylaby[] = {"ko", "Wal", "ski", "NO", "wak", "Zie", "lin", "ma", "tej", "ce", "Ba"};
+  int j, k, n = przebieg->n, liczba_bledow = 0;
+  unsigned int *stan = przebieg->dane;
+  double czas[3];
+  wezel *osoby, **tablice[3];
+
+  osoby = (wezel*) malloc(n*sizeof(wezel));
+  for(j = 0; j < n; j++)
+  {
+    osoby[j].id = (int)(losowa_liczba(stan) % INT_MAX);
+    strcpy(osoby[j].nazwisko, (j % 10 == 0)? "Wielkopolskiewicz" : "");
+    for(k = 2 + losowa_liczba(stan) % 3; k > 0; k--)
+      strcat(osoby[j].nazwisko, sylaby[losowa_liczba(stan) % 11]);
+    strcpy(osoby[j].pierwsze_imie, "Jan");
+    ustawianie_kluczy_sortowania(&osoby[j]);
+  }
+  for(k = 0; k < 3; k++)
+  {
+    tablice[k] = (wezel**) malloc(n*sizeof(wezel*));
+    for(j = 0; j < n; j++)
+      tablice[k][j] = &osoby[j];
+  }
+  czas[0] = czas_zegarowy();
+  qsort(tablice[0], n, sizeof(wezel*), porownywanie_id);
+  czas[0] = czas_zegarowy() - czas[0];
+  czas[1] = czas_zegarowy();
+  qsort(tablice[1], n, sizeof(wezel*), porownywanie_nazwisk_bez_kluczy);
+  czas[1] = czas_zegarowy() - czas[1];
+  czas[2] = czas_zegarowy();
+  qsort(tablice[2], n, sizeof(wezel*), porownywanie_nazwisk_kluczami);
+  czas[2] = czas_zegarowy() - czas[2];
+
+  for(j = 0; j < n; j++)
+    if(string_compare(tablice[1][j]->nazwisko, tablice[2][j]->nazwisko) != 0)
+      liczba_bledow++;
+  printf("%10d %14.1f %16.1f %16.1f\n", n, 1e3*czas[0], 1e3*czas[1], 1e3*czas[2]);
+  if(liczba_bledow > 0)
+    zglaszanie_bledu_testu("rozna kolejnosc nazwisk (%d)\n", liczba_bledow);
+  for(k = 0; k < 3; k++)
+    free(tablice[k]);
+  free(osoby);
+}
+
+/* sortowanie 10^5 i 10^6 osob (qsort tablicy wskaznikow) wedlug id, wedlug */
+/* nazwisk przez string_compare i wedlug nazwisk kluczami sortowania; nazwiska */
+/* z sylab roznej wielkosci liter, czesc z dlugim wspolnym poczatkiem (wtedy */
+/* klucze sa rowne i trzeba porownac cale napisy) */
+void test_wydajnosci_kluczy(void)
+{
+  int rozmiary[] = {100000, 1000000};
+  unsigned int stan = 11;
+
+  printf("Sortowanie osob (qsort) [ms]\n");
+  printf("%10s %14s %16s %16s\n", "osoby", "id", "string_compare", "klucze");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), BEZ_GRAFU, pomiar_kluczy, &stan);
+}
+
+/* wsk1 jest wskaznikiem na wezly pierwszej listy, wsk2 na wezly drugiej */
+/* na poczatku wsk1 i wsk2 pokazuja na pierwsze elementy obu list. wsk3 jest wskaznikiem na wezly */
+/* posortowanej listy bedacej wynikiem scalenia obu list wskazywanych przez wsk1 i wsk2 */
+/* funkcja zwraca wskaznik do pierwszego wezla posortowanej, scalonej listy */
+wezel* scalanie_list(wezel *wsk1, wezel *wsk2, int tryb)
+{
+  wezel *wsk3;
+  wezel *pierwszy;
+
+  if(porownywanie(wsk1, wsk2, tryb) < 0)
+  {
+    pierwszy = wsk1;
+    wsk1 = wsk1->nastepny;
+  }
+  else
+  {
+    pierwszy = wsk2;
+    wsk2 = wsk2->nastepny;
+  }
+  wsk3 = pierwszy;
+  while(wsk1 != NULL && wsk2 != NULL)
+  {
+    if(porownywanie(wsk1, wsk2, tryb) < 0)
+    {
+      wsk3->nastepny = wsk1;
+      wsk3 = wsk3->nastepny;
+      wsk1 = wsk1->nastepny;
+    }
+    else
+    {
+      wsk3->nastepny = wsk2;
+      wsk3 = wsk3->nastepny;
+      wsk2 = wsk2->nastepny;
+    }
+  }
+  if(wsk1 != NULL)
+    wsk3->nastepny = wsk1;
+  if(wsk2 != NULL)
+    wsk3->nastepny = wsk2;
+  return pierwszy;
+}
+
+/* poprzedni sposob sortowania - rekurencyjne scalanie listy, ktore w kazdym */
+/* wywolaniu przechodzi pol listy, zeby ja podzielic; zostawiony tylko do porownan */
+wezel* sortowanie_listy_przez_scalanie(wezel *pierwszy, int n, int tryb)
+{
+  int i, srodek;
+  wezel *wezelwsk, *temp;
+  wezel *pierwszy1, *pierwszy2;
+
+  if(n == 1)
+    return pierwszy;
+
+  srodek = (int) floor(n/2);
+  wezelwsk = pierwszy;
+  for(i = 1; i <= srodek-1; i++)
+    wezelwsk = wezelwsk->nastepny;
+  temp = wezelwsk->nastepny;
+  wezelwsk->nastepny = NULL;
+
+  pierwszy1 = sortowanie_listy_przez_scalanie(pierwszy, srodek, tryb);
+  pierwszy2 = sortowanie_listy_przez_scalanie(temp, n-srodek, tryb);
+  return scalanie_list(pierwszy1, pierwszy2, tryb);
+}
+
+/* sortowanie listy osob w kolejnosci z tablicy poczatek (przepiecie pol nastepny) */
+wezel* ukladanie_listy(wezel **poczatek, int n)
+{
+  int i;
+
+  for(i = 0; i < n-1; i++)
+    poczatek[i]->nastepny = poczatek[i+1];
+  poczatek[n-1]->nastepny = NULL;
+  return poczatek[0];
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_scalania; w dane - stan generatora liczb */
+/* pseudolosowych wspolny dla wszystkich rozmiarow */
+void pomiar_scalania(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  char *tryby[] = {"", "id", "imiona", "nazwiska"};
+  int j, k, n = przebieg->n, tryb, liczba_bledow, *pozycje;
+  unsigned int *stan = przebieg->dane;
+  double czas[3];
+  wezel **poczatek, **poprzednio, **osoby, **osoby_watkami, *wezelwsk;
+
+  poczatek = (wezel**) malloc(n*sizeof(wezel*));
+  poprzednio = (wezel**) malloc(n*sizeof(wezel*));
+  osoby = (wezel**) malloc(n*sizeof(wezel*));
+  osoby_watkami = (wezel**) malloc(n*sizeof(wezel*));
+  pozycje = (int*) malloc(n*sizeof(int));
+  for(j = 0; j < n; j++)
+    poczatek[j] = g->sloty[j];
+  for(j = n-1; j > 0; j--)
+  {
+    k = (int)(losowa_liczba(stan) % (j+1));
+    wezelwsk = poczatek[j];
+    poczatek[j] = poczatek[k];
+    poczatek[k] = wezelwsk;
+  }
+  for(j = 0; j < n; j++)
+    pozycje[poczatek[j]->slot] = j;
+
+  for(tryb = 1; tryb <= 3; tryb++)
+  {
+    g->zrodlo = ukladanie_listy(poczatek, n);
+    czas[0] = czas_zegarowy();
+    g->zrodlo = sortowanie_listy_przez_scalanie(g->zrodlo, n, tryb);
+    czas[0] = czas_zegarowy() - czas[0];
+    for(j = 0, wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+      poprzednio[j++] = wezelwsk;
+
+    g->zrodlo = ukladanie_listy(poczatek, n);
+    czas[1] = czas_zegarowy();
+    for(j = 0, wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+      osoby[j++] = wezelwsk;
+    sortowanie_tablicy_przez_scalanie(osoby, n, tryb, 1);
+    g->zrodlo = ukladanie_listy(osoby, n);
+    czas[1] = czas_zegarowy() - czas[1];
+
+    g->zrodlo = ukladanie_listy(poczatek, n);
+    czas[2] = czas_zegarowy();
+    for(j = 0, wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+      osoby_watkami[j++] = wezelwsk;
+    sortowanie_tablicy_przez_scalanie(osoby_watkami, n, tryb,
+                                      (int)sysconf(_SC_NPROCESSORS_ONLN));
+    g->zrodlo = ukladanie_listy(osoby_watkami, n);
+    czas[2] = czas_zegarowy() - czas[2];
+
+    liczba_bledow = 0;
+    for(j = 0, wezelwsk = g->zrodlo; wezelwsk != NULL; j++, wezelwsk = wezelwsk->nastepny)
+    {
+      if(j >= n || wezelwsk != osoby[j] || porownywanie(wezelwsk, poprzednio[j], tryb) != 0)
+        liczba_bledow++;
+      if(wezelwsk->nastepny != NULL && porownywanie(wezelwsk, wezelwsk->nastepny, tryb) == 0 &&
+         pozycje[wezelwsk->slot] > pozycje[wezelwsk->nastepny->slot])
+        liczba_bledow++;
+    }
+    printf("%10d %10s %14.1f %14.1f %14.1f\n", n, tryby[tryb], 1e3*czas[0], 1e3*czas[1],
+           1e3*czas[2]);
+    if(liczba_bledow > 0 || j != n)
+      zglaszanie_bledu_testu("niepoprawna kolejnosc osob (%d)\n", liczba_bledow);
+  }
+  g->zrodlo = ukladanie_listy(poczatek, n);
+  odtwarzanie_poprzednikow(g);
+  free(pozycje);
+  free(osoby_watkami);
+  free(osoby);
+  free(poprzednio);
+  free(poczatek);
+}
+
+/* sortowanie 10^5 i 10^6 osob w losowej kolejnosci wedlug id, imion i nazwisk: */
+/* poprzednie scalanie listy oraz scalanie tablicy jednym watkiem i wszystkimi */
+/* rdzeniami (z przepieciem listy); sprawdzamy, ze kolejnosc kluczy jest taka sama jak */
+/* poprzednio i ze rowne osoby zostaja w kolejnosci poczatkowej (stabilnosc) */
+void test_wydajnosci_scalania(void)
+{
+  int rozmiary[] = {100000, 1000000};
+  unsigned int stan = 21;
+
+  printf("Sortowanie listy osob [ms] (watki: %d)\n", (int)sysconf(_SC_NPROCESSORS_ONLN));
+  printf("%10s %10s %14s %14s %14s\n", "osoby", "tryb", "lista", "tablica 1 w.",
+         "tablica");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 0, pomiar_scalania, &stan);
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_sortowania_pozycyjnego; w dane - stan */
+/* generatora liczb pseudolosowych wspolny dla wszystkich rozmiarow */
+void pomiar_sortowania_pozycyjnego(przebieg_testu *przebieg)
+{
+  char *tryby[] = {"", "id", "", "", "telefon", "kod"};
+  int j, k, n = przebieg->n, tryb, liczba_bledow;
+  unsigned int *stan = przebieg->dane;
+  double czas[2];
+  wezel *osoby, **przez_scalanie, **pozycyjnie;
+
+  if((double)sysconf(_SC_AVPHYS_PAGES) * sysconf(_SC_PAGESIZE) <
+     (double)n * (sizeof(wezel) + 4*sizeof(wezel*) + 2*sizeof(para_sortowania)))
+  {
+    printf("%10d - za malo wolnej pamieci, pomijamy\n", n);
+    return;
+  }
+  osoby = (wezel*) malloc((size_t)n*sizeof(wezel));
+  przez_scalanie = (wezel**) malloc(n*sizeof(wezel*));
+  pozycyjnie = (wezel**) malloc(n*sizeof(wezel*));
+  for(j = 0; j < n; j++)
+    osoby[j].id = j+1;
+  for(j = n-1; j > 0; j--)
+  {
+    k = (int)(losowa_liczba(stan) % (j+1));
+    osoby[j].id ^= osoby[k].id;
+    osoby[k].id ^= osoby[j].id;
+    osoby[j].id ^= osoby[k].id;
+  }
+  for(j = 0; j < n; j++)
+  {
+    osoby[j].nr_telefonu = 100000000 + losowa_liczba(stan) % 900000000;
+    k = losowa_liczba(stan) % 100000;
+    sprintf(osoby[j].adres.kod_pocztowy, "%02d-%03d", k / 1000, k % 1000);
+  }
+
+  for(tryb = 1; tryb <= 5; tryb++)
+  {
+    if(tryb == 2 || tryb == 3)
+      continue;
+    for(j = 0; j < n; j++)
+      przez_scalanie[j] = pozycyjnie[j] = &osoby[j];
+    czas[0] = czas_zegarowy();
+    sortowanie_tablicy_przez_scalanie(przez_scalanie, n, tryb,
+                                      (int)sysconf(_SC_NPROCESSORS_ONLN));
+    czas[0] = czas_zegarowy() - czas[0];
+    czas[1] = czas_zegarowy();
+    sortowanie_pozycyjne(pozycyjnie, n, tryb);
+    czas[1] = czas_zegarowy() - czas[1];
+
+    liczba_bledow = 0;
+    for(j = 0; j < n; j++)
+      if(przez_scalanie[j] != pozycyjnie[j])
+        liczba_bledow++;
+    printf("%10d %10s %14.1f %14.1f\n", n, tryby[tryb], 1e3*czas[0], 1e3*czas[1]);
+    if(liczba_bledow > 0)
+      zglaszanie_bledu_testu("rozna kolejnosc osob (%d)\n", liczba_bledow);
+  }
+  free(pozycyjnie);
+  free(przez_scalanie);
+  free(osoby);
+}
+
+/* sortowanie 10^6 i 10^7 osob w losowej kolejnosci wedlug kluczy liczbowych (id, */
+/* numer telefonu, kod pocztowy): scalanie tablicy wszystkimi rdzeniami vs */
+/* sortowanie pozycyjne; oba sa stabilne, wiec wyniki musza byc identyczne; */
+/* 10^7 osob wymaga ok. 4 GB pamieci - przy mniejszej ilosci wolnej pamieci */
+/* ten rozmiar jest pomijany */
+void test_wydajnosci_sortowania_pozycyjnego(void)
+{
+  int rozmiary[] = {1000000, 10000000};
+  unsigned int stan = 22;
+
+  printf("Sortowanie wedlug kluczy liczbowych [ms] (watki: %d)\n",
+         (int)sysconf(_SC_NPROCESSORS_ONLN));
+  printf("%10s %10s %14s %14s\n", "osoby", "klucz", "scalanie", "pozycyjne");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), BEZ_GRAFU,
+               pomiar_sortowania_pozycyjnego, &stan);
+}
+
+/* poprzedni sposob wczytywania bazy - fscanf/fgets/sscanf po jednej linii; */
+/* zostawiony tylko do porownan */
+int wczytywanie_bazy_przez_fscanf(baza *b, char *nazwa_pliku)
+{
+  FILE *plik;
+  int id, waga;
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+  char pierwsze_imie[32], nazwisko[32], napis[256];
+
+  if((plik = fopen(nazwa_pliku, "r")) == NULL)
+    return -1;
+  /* oczyszczanie bazy z poprzednich danych */
+  czyszczenie_bazy(b);
+
+  /* wczytywanie glownych informacji o bazie (grafie) z pliku */
+  fscanf(plik, "Ksiazka adresowo-spolecznosciowa\n");
+  fscanf(plik, "Liczba elementow: %d, biezacy id: %d\n",
+          &b->liczba_elementow, &b->biezacy_id);
+
+  /* wczytywanie informacji o kazdym wezle z pliku */
+  /* warunek w petli while sprawdza czy w pliku sa jeszcze jakies osoby (wezly) */
+  fgets(napis, 256, plik);
+  while((sscanf(napis, "Osoba, id %d\n", &id)) > 0)
+  {
+    wezelwsk = (wezel*) przydzielanie_z_puli(&b->pula_wezlow);
+    wezelwsk->id = id;
+    wezelwsk->pierwszy = wezelwsk->ostatni = NULL;
+    wezelwsk->stopien = 0;
+    wezelwsk->zbior = NULL;
+    przydzielanie_slotu(b, wezelwsk);
+    dodawanie_do_indeksu(b, wezelwsk);
+    fscanf(plik, "Dane osobowe:\n");
+    fscanf(plik, "%s %s %s nr telefonu: %d\n", wezelwsk->pierwsze_imie,
+      wezelwsk->drugie_imie, wezelwsk->nazwisko, &wezelwsk->nr_telefonu);
+    dodawanie_do_indeksu_nazwisk(b, wezelwsk);
+    b->widoki.nieaktualne = true;
+
+    fscanf(plik, "Adres:\n");
+    fscanf(plik, "Ulica %s %d/%d, kod pocztowy: %7s miasto: %s\n",
+      wezelwsk->adres.ulica, &wezelwsk->adres.nr_domu, &wezelwsk->adres.nr_mieszkania,
+      wezelwsk->adres.kod_pocztowy, wezelwsk->adres.miasto);
+
+    dopisywanie_wezla(b, wezelwsk); /* odtwarzamy liste wezlow grafu */
+    fgets(napis, 256, plik);
+  }
+  fgets(napis, 256, plik); /* wczytujemy znak nowej linii */
+  fgets(napis, 256, plik);
+  /* wczytujemy informacje o znajomosciach miedzy osobami z pliku */
+  wezelwsk = b->zrodlo;
+  while(wezelwsk != NULL)
+  {
+    fgets(napis, 256, plik);
+    while((sscanf(napis, "Id %d %s %s stopien znajomosci: %d\n",
+      &id, pierwsze_imie, nazwisko, &waga)) > 0)
+    {
+      krawedzwsk = (krawedz*) przydzielanie_z_puli(&b->pula_krawedzi);
+      krawedzwsk->cel = znajdz_wezel(b, id);
+      krawedzwsk->waga = waga;
+      krawedzwsk->blizniacza = NULL;
+      dopisywanie_krawedzi(b, wezelwsk, krawedzwsk); /* odtwarzamy liste krawedzi danego wezla */
+      if(fgets(napis, 256, plik) == NULL) break; /* przerywany gdy dojdziemy do konca pliku */
+    }
+    wezelwsk = wezelwsk->nastepny;
+    if(fgets(napis, 256, plik) == NULL) break; /* przerywany gdy dojdziemy do konca pliku */
+  }
+  laczenie_krawedzi_blizniaczych(b);
+
+  fclose(plik);
+  return 0;
+}
+
+/* liczba krawedzi grafu i suma kontrolna jego zawartosci (id, numery telefonow, */
+/* cele i wagi krawedzi w kolejnosci list) - do sprawdzania, czy dwa sposoby */
+/* wczytywania zbudowaly ten sam graf */
+unsigned long suma_kontrolna_grafu(graf *g, long *liczba_krawedzi)
+{
+  unsigned long suma = 0;
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+
+  *liczba_krawedzi = 0;
+  for(wezelwsk = g->zrodlo; wezelwsk != NULL; wezelwsk = wezelwsk->nastepny)
+  {
+    suma = 31*suma + wezelwsk->id + wezelwsk->nr_telefonu + wezelwsk->adres.nr_domu +
+           (unsigned char)wezelwsk->nazwisko[0] + (unsigned char)wezelwsk->adres.miasto[0];
+    for(krawedzwsk = wezelwsk->pierwszy; krawedzwsk != NULL; krawedzwsk = krawedzwsk->nastepny)
+    {
+      suma = 31*suma + krawedzwsk->cel->id*16 + krawedzwsk->waga;
+      (*liczba_krawedzi)++;
+    }
+  }
+  return suma;
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_wczytywania */
+void pomiar_wczytywania(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  char *nazwa_pliku = "test_wydajnosci_wczytywania.txt";
+  int j, plik, liczba_watkow = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  long rozmiar, krawedzie[3];
+  unsigned long sumy[3];
+  double czas[4];
+  char *blok;
+
+  if(liczba_watkow < 2)
+    liczba_watkow = 2;
+  if(zapisywanie_bazy_do_pliku(g, nazwa_pliku) == -1)
+  {
+    zglaszanie_bledu_testu("nie udalo sie utworzyc pliku %s\n", nazwa_pliku);
+    return;
+  }
+
+  /* pierwszy odczyt laduje plik do pamieci podrecznej systemu, wiec */
+  /* wszystkie sposoby czytaja plik z tej samej pamieci */
+  blok = (char*) malloc(1 << 20);
+  czas[3] = czas_zegarowy();
+  plik = open(nazwa_pliku, O_RDONLY);
+  for(rozmiar = 0; (krawedzie[0] = read(plik, blok, 1 << 20)) > 0; )
+    rozmiar += krawedzie[0];
+  close(plik);
+  czas[3] = czas_zegarowy() - czas[3];
+  free(blok);
+
+  czas[0] = czas_zegarowy();
+  wczytywanie_bazy_przez_fscanf(g, nazwa_pliku);
+  czas[0] = czas_zegarowy() - czas[0];
+  sumy[0] = suma_kontrolna_grafu(g, &krawedzie[0]);
+  for(j = 1; j <= 2; j++)
+  {
+    czas[j] = czas_zegarowy();
+    wczytywanie_bazy_z_pliku_watkami(g, nazwa_pliku, (j == 1)? 1 : liczba_watkow);
+    czas[j] = czas_zegarowy() - czas[j];
+    sumy[j] = suma_kontrolna_grafu(g, &krawedzie[j]);
+    if(bledne_krawedzie_blizniacze(g) != 0)
+      sumy[j] = ~sumy[0];
+  }
+  remove(nazwa_pliku);
+
+  printf("%10d %10.1f %12.1f %12.1f %12.1f %12.1f\n", przebieg->n, rozmiar/1e6,
+         rozmiar/1e6/czas[0], rozmiar/1e6/czas[1], rozmiar/1e6/czas[2], rozmiar/1e6/czas[3]);
+  if(sumy[0] != sumy[1] || sumy[0] != sumy[2] || krawedzie[0] != krawedzie[1] ||
+     krawedzie[0] != krawedzie[2] || g->liczba_elementow != przebieg->n)
+    zglaszanie_bledu_testu("wczytane grafy sie roznia\n");
+}
+
+/* wczytywanie zapisanych grafow o 10^4 - 10^6 osobach: fscanf/fgets po jednej */
+/* linii vs. odwzorowanie pliku w pamieci i wlasny podzial na slowa (jednym */
+/* watkiem i wszystkimi procesorami, ale co najmniej dwoma watkami, zeby zawsze */
+/* porownac oba sposoby); dla porownania podajemy tez szybkosc samego odczytu */
+/* pliku blokami po 1 MB */
+void test_wydajnosci_wczytywania(void)
+{
+  int rozmiary[] = {10000, 100000, 1000000};
+  int liczba_watkow = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  char naglowek[32];
+
+  sprintf(naglowek, "mmap/%d", (liczba_watkow < 2)? 2 : liczba_watkow);
+  printf("Wczytywanie bazy z pliku tekstowego [MB/s]\n");
+  printf("%10s %10s %12s %12s %12s %12s\n", "osoby", "MB", "fscanf", "mmap/1", naglowek, "odczyt");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_wczytywania, NULL);
+}
+
+/* poprzednia wersja zapisywania bazy - jedno wywolanie fprintf na kazda linie */
+/* pliku; zostawiona do porownania z zapisywaniem przez bufory */
+int zapisywanie_bazy_przez_fprintf(baza *b, char *nazwa_pliku)
+{
+  FILE *plik;
+  wezel *wezelwsk;
+  krawedz *krawedzwsk;
+
+  if((plik = fopen(nazwa_pliku, "w")) == NULL)
+    return -1;
+
+  /* zapisywanie glownych informacji o bazie (grafie) do pliku */
+  fprintf(plik, "Ksiazka adresowo-spolecznosciowa\n");
+  fprintf(plik, "Liczba elementow: %d, biezacy id: %d\n",
+          b->liczba_elementow, b->biezacy_id);
+  /* zapisywanie informacji o kazdym wezle do pliku */
+  wezelwsk = b->zrodlo;
+  while(wezelwsk != NULL)
+  {
+    fprintf(plik, "\nOsoba, id %d\n", wezelwsk->id);
+    fprintf(plik, "Dane osobowe:\n");
+    fprintf(plik, "%s %s %s nr telefonu: %d\n", wezelwsk->pierwsze_imie,
+      wezelwsk->drugie_imie, wezelwsk->nazwisko, wezelwsk->nr_telefonu);
+
+    fprintf(plik, "Adres:\n");
+    fprintf(plik, "Ulica %s %d/%d, kod pocztowy: %s miasto: %s\n",
+      wezelwsk->adres.ulica, wezelwsk->adres.nr_domu, wezelwsk->adres.nr_mieszkania,
+      wezelwsk->adres.kod_pocztowy, wezelwsk->adres.miasto);
+
+    wezelwsk = wezelwsk->nastepny;
+  }
+  /* zapisywanie informacji o wszystkich krawedziach do pliku */
+  fprintf(plik, "\nInformacje o znajomosciach miedzy osobami\n");
+  wezelwsk = b->zrodlo;
+  while(wezelwsk != NULL)
+  {
+    fprintf(plik, "\nZnajomi osoby o identyfikatorze %d:\n", wezelwsk->id);
+    krawedzwsk = wezelwsk->pierwszy;
+    while(krawedzwsk != NULL)
+    {
+      fprintf(plik, "Id %d %s %s stopien znajomosci: %d\n",
+        krawedzwsk->cel->id, krawedzwsk->cel->pierwsze_imie,
+        krawedzwsk->cel->nazwisko, krawedzwsk->waga);
+        krawedzwsk = krawedzwsk->nastepny;
+    }
+    wezelwsk = wezelwsk->nastepny;
+  }
+
+  fclose(plik);
+  return 0;
+}
+
+/* true gdy dwa pliki maja identyczna zawartosc */
+bool porownywanie_plikow(char *nazwa1, char *nazwa2)
+{
+  FILE *plik1 = fopen(nazwa1, "rb"), *plik2 = fopen(nazwa2, "rb");
+  char blok1[1 << 16], blok2[1 << 16];
+  size_t n1, n2;
+  bool identyczne = (plik1 != NULL && plik2 != NULL);
+
+  while(identyczne)
+  {
+    n1 = fread(blok1, 1, sizeof(blok1), plik1);
+    n2 = fread(blok2, 1, sizeof(blok2), plik2);
+    identyczne = (n1 == n2 && memcmp(blok1, blok2, n1) == 0);
+    if(n1 == 0)
+      break;
+  }
+  if(plik1 != NULL)
+    fclose(plik1);
+  if(plik2 != NULL)
+    fclose(plik2);
+  return identyczne;
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_zapisywania */
+void pomiar_zapisywania(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  char *nazwy_plikow[] = {"test_wydajnosci_zapisywania_1.txt", "test_wydajnosci_zapisywania_2.txt"};
+  int j, liczba_watkow = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  long rozmiar = 0;
+  double czas[3];
+  bool identyczne = true;
+
+  if(liczba_watkow < 2)
+    liczba_watkow = 2;
+  czas[0] = czas_zegarowy();
+  if(zapisywanie_bazy_przez_fprintf(g, nazwy_plikow[0]) == -1)
+  {
+    zglaszanie_bledu_testu("nie udalo sie utworzyc pliku %s\n", nazwy_plikow[0]);
+    return;
+  }
+  czas[0] = czas_zegarowy() - czas[0];
+  for(j = 1; j <= 2; j++)
+  {
+    czas[j] = czas_zegarowy();
+    rozmiar = zapisywanie_bazy_do_pliku_watkami(g, nazwy_plikow[1], (j == 1)? 1 : liczba_watkow);
+    czas[j] = czas_zegarowy() - czas[j];
+    identyczne &= (rozmiar != -1 && porownywanie_plikow(nazwy_plikow[0], nazwy_plikow[1]));
+  }
+  remove(nazwy_plikow[0]);
+  remove(nazwy_plikow[1]);
+
+  printf("%10d %10.1f %12.1f %12.1f %12.1f\n", przebieg->n, rozmiar/1e6,
+         rozmiar/1e6/czas[0], rozmiar/1e6/czas[1], rozmiar/1e6/czas[2]);
+  if(!identyczne)
+    zglaszanie_bledu_testu("zapisane pliki sie roznia\n");
+}
+
+/* zapisywanie grafow o 10^4 - 10^6 osobach: fprintf po jednej linii vs. */
+/* reczne formatowanie do buforow jednym watkiem i wszystkimi procesorami */
+/* (co najmniej dwoma); pliki z buforow musza byc identyczne z plikiem z fprintf */
+void test_wydajnosci_zapisywania(void)
+{
+  int rozmiary[] = {10000, 100000, 1000000};
+  int liczba_watkow = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  char naglowek[32];
+
+  sprintf(naglowek, "bufory/%d", (liczba_watkow < 2)? 2 : liczba_watkow);
+  printf("Zapisywanie bazy do pliku tekstowego [MB/s]\n");
+  printf("%10s %10s %12s %12s %12s\n", "osoby", "MB", "fprintf", "bufory/1", naglowek);
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_zapisywania, NULL);
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_pliku_binarnego */
+void pomiar_pliku_binarnego(przebieg_testu *przebieg)
+{
+  graf *g = &przebieg->g;
+  kontekst_wyszukiwania *kontekst = &przebieg->kontekst, kontekst_binarny;
+  char *plik_tekstowy = "test_wydajnosci_binarny.txt";
+  char *plik_binarny = "test_wydajnosci_binarny.bin";
+  int q, n = przebieg->n, tryb, zrodlo, cel, liczba_bledow = 0;
+  unsigned int stan = 9;
+  double czas[4];
+  ksiazka_binarna ksiazka;
+  wezel *wsk1, *wsk2;
+
+  if(zapisywanie_bazy_do_pliku(g, plik_tekstowy) == -1 ||
+     zapisywanie_ksiazki_binarnej(g, plik_binarny) == -1)
+  {
+    zglaszanie_bledu_testu("nie udalo sie utworzyc plikow testowych\n");
+    remove(plik_tekstowy);
+    return;
+  }
+
+  /* pierwsze zapytanie dotyczy dwoch osob, ktore sie znaja */
+  czas[0] = czas_zegarowy();
+  wczytywanie_bazy_z_pliku(g, plik_tekstowy);
+  czas[0] = czas_zegarowy() - czas[0];
+  czas[1] = czas_zegarowy();
+  algorytm_dijkstry(g, kontekst, g->sloty[0], g->sloty[0]->pierwszy->cel, 2);
+  czas[1] = czas_zegarowy() - czas[1];
+  czas[2] = czas_zegarowy();
+  if(otwieranie_ksiazki_binarnej(&ksiazka, plik_binarny) != 0)
+  {
+    zglaszanie_bledu_testu("nie udalo sie otworzyc pliku binarnego\n");
+    remove(plik_tekstowy);
+    remove(plik_binarny);
+    return;
+  }
+  czas[2] = czas_zegarowy() - czas[2];
+  inicjalizacja_kontekstu(&kontekst_binarny);
+  czas[3] = czas_zegarowy();
+  cel = ksiazka.graf.migawka.sasiedzi[ksiazka.graf.migawka.poczatki[0]];
+  algorytm_dijkstry_slotow(&ksiazka.graf, &kontekst_binarny, 0, &cel, 1, 2);
+  czas[3] = czas_zegarowy() - czas[3];
+
+  for(q = 0; q < 200; q++)
+  {
+    wsk1 = znajdz_wezel(g, 1 + losowa_liczba(&stan) % n);
+    wsk2 = znajdz_wezel(g, 1 + losowa_liczba(&stan) % n);
+    tryb = 1 + q % 2;
+    zrodlo = numer_osoby_binarnej(&ksiazka, wsk1->id);
+    cel = numer_osoby_binarnej(&ksiazka, wsk2->id);
+    if((algorytm_dijkstry(g, kontekst, wsk1, wsk2, tryb) != NULL) !=
+       (algorytm_dijkstry_slotow(&ksiazka.graf, &kontekst_binarny, zrodlo, &cel, 1, tryb) > 0) ||
+       (wezel_osiagniety(kontekst, wsk2) &&
+        kontekst->stany[wsk2->slot].odleglosc != kontekst_binarny.stany[cel].odleglosc))
+      liczba_bledow++;
+  }
+
+  printf("%10d %16.2f %16.3f %16.3f %16.3f %12.1f\n", n, 1e3*czas[0],
+         1e3*czas[1], 1e3*czas[2], 1e3*czas[3], ksiazka.rozmiar/1e6);
+  if(liczba_bledow > 0)
+    zglaszanie_bledu_testu("rozne wyniki zapytan (%d)\n", liczba_bledow);
+  zamykanie_ksiazki_binarnej(&ksiazka);
+  zwalnianie_kontekstu(&kontekst_binarny);
+  remove(plik_tekstowy);
+  remove(plik_binarny);
+}
+
+/* czas od uruchomienia do odpowiedzi na pierwsze zapytanie: wczytanie pliku */
+/* tekstowego vs. odwzorowanie pliku binarnego, potem pierwsze zapytanie (na grafie */
+/* z pliku tekstowego obejmuje ono budowanie migawki); wyniki zapytan na obu */
+/* grafach sa porownywane */
+void test_wydajnosci_pliku_binarnego(void)
+{
+  int rozmiary[] = {100000, 1000000};
+
+  printf("Gotowosc do pierwszego zapytania [ms]\n");
+  printf("%10s %16s %16s %16s %16s %12s\n", "osoby", "wczytanie tekstu", "zapytanie",
+         "otwarcie binarny", "zapytanie", "MB binarny");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), 3, pomiar_pliku_binarnego, NULL);
+}
+
+/* losowa zmiana znajomosci w grafie g zapisywana w dzienniku d (jesli nie jest */
+/* NULL): dodanie znajomosci dwoch losowych osob albo jej usuniecie, gdy juz sie znaja */
+void losowa_zmiana_znajomosci(graf *g, dziennik_zmian *d, unsigned int *stan)
+{
+  wezel *wsk1 = g->sloty[losowa_liczba(stan) % g->liczba_elementow];
+  wezel *wsk2 = g->sloty[losowa_liczba(stan) % g->liczba_elementow];
+  int argumenty[4] = {wsk1->id, wsk2->id, 1 + losowa_liczba(stan) % 10, 1 + losowa_liczba(stan) % 10};
+  int wynik;
+
+  if((wynik = dodawanie_krawedzi(g, wsk1, wsk2, argumenty[2], argumenty[3])) == 0 && d != NULL)
+    rejestrowanie_zmiany(d, ZMIANA_DODANIE_ZNAJOMOSCI, 4, argumenty);
+  else if(wynik == -2 && usuwanie_krawedzi(g, wsk1->id, wsk2->id) == 0 && d != NULL)
+    rejestrowanie_zmiany(d, ZMIANA_USUNIECIE_ZNAJOMOSCI, 2, argumenty);
+}
+
+/* utrwalanie pojedynczych zmian w bazie 10^5 osob: zapisanie calej ksiazki */
+/* z synchronizacja po kazdej zmianie vs. dziennik zmian czekajacy na zatwierdzenie */
+/* kazdego rekordu i dziennik z zatwierdzaniem grupowym (czekanie tylko na koncu); */
+/* na koniec baza jest odtwarzana z migawki i dziennika i porownywana z oryginalem */
+void test_wydajnosci_dziennika(void)
+{
+  char *nazwa_ksiazki = "test_wydajnosci_dziennika.txt";
+  char *nazwa_kopii = "test_wydajnosci_dziennika_kopia.txt";
+  char nazwa_pliku[300];
+  int liczby_zmian[] = {20, 2000, 20000};
+  int i, j, n = 100000;
+  long liczba_odtworzonych, liczba_zapisanych;
+  double czas[4];
+  unsigned int stan = 77;
+  dziennik_zmian d, odtworzony;
+  graf g, h;
+
+  /* pliki pozostale po przerwanym tescie bylyby wczytane jako baza poczatkowa */
+  sprintf(nazwa_pliku, "%s.dziennik", nazwa_ksiazki);
+  remove(nazwa_ksiazki);
+  remove(nazwa_pliku);
+  inicjalizacja_bazy(&g);
+  inicjalizacja_bazy(&h);
+  otwieranie_dziennika(&d, &g, nazwa_ksiazki);
+  if(d.plik == -1)
+  {
+    zglaszanie_bledu_testu("nie udalo sie utworzyc dziennika zmian\n");
+    zamykanie_dziennika(&d);
+    return;
+  }
+  generowanie_grafu(&g, n, 3, 12345);
+
+  /* zmiany zapisywane przez przepisanie calej ksiazki nie trafiaja do dziennika, */
+  /* dlatego przed pozostalymi pomiarami zapisujemy migawke */
+  czas[0] = czas_zegarowy();
+  for(j = 0; j < liczby_zmian[0]; j++)
+  {
+    losowa_zmiana_znajomosci(&g, NULL, &stan);
+    if(zapisywanie_bazy_do_pliku(&g, nazwa_kopii) == -1 || synchronizacja_pliku(nazwa_kopii) == -1)
+    {
+      zglaszanie_bledu_testu("nie udalo sie zapisac pliku %s\n", nazwa_kopii);
+      break;
+    }
+  }
+  czas[0] = czas_zegarowy() - czas[0];
+  zapisywanie_migawki(&d, &g);
+
+  for(i = 1; i <= 2; i++)
+  {
+    d.czekanie_na_zapis = (i == 1);
+    czas[i] = czas_zegarowy();
+    for(j = 0; j < liczby_zmian[i]; j++)
+      losowa_zmiana_znajomosci(&g, &d, &stan);
+    if(oczekiwanie_na_zatwierdzenie(&d) == -1)
+      zglaszanie_bledu_testu("nie udalo sie zapisac dziennika zmian\n");
+    czas[i] = czas_zegarowy() - czas[i];
+  }
+  liczba_zapisanych = d.liczba_zapisanych;
+  zamykanie_dziennika(&d);
+
+  czas[3] = czas_zegarowy();
+  liczba_odtworzonych = otwieranie_dziennika(&odtworzony, &h, nazwa_ksiazki);
+  czas[3] = czas_zegarowy() - czas[3];
+  zamykanie_dziennika(&odtworzony);
+
+  printf("Utrwalanie zmian w bazie %d osob [zmiany/s]\n", n);
+  printf("%16s %16s %16s %16s\n", "cala ksiazka", "dziennik", "zatw. grupowe",
+         "odtwarzanie [s]");
+  printf("%16.1f %16.1f %16.1f %16.3f\n", liczby_zmian[0]/czas[0], liczby_zmian[1]/czas[1],
+         liczby_zmian[2]/czas[2], czas[3]);
+  if(liczba_odtworzonych != liczba_zapisanych || h.liczba_elementow != g.liczba_elementow ||
+     zapisywanie_bazy_do_pliku(&g, nazwa_kopii) == -1 ||
+     zapisywanie_bazy_do_pliku(&h, nazwa_ksiazki) == -1 ||
+     !porownywanie_plikow(nazwa_kopii, nazwa_ksiazki))
+    zglaszanie_bledu_testu("baza odtworzona z dziennika rozni sie od oryginalu\n");
+
+  czyszczenie_bazy(&g);
+  czyszczenie_bazy(&h);
+  remove(nazwa_kopii);
+  remove(nazwa_ksiazki);
+  sprintf(nazwa_pliku, "%s.dziennik", nazwa_ksiazki);
+  remove(nazwa_pliku);
+}
+
+/* pamiec fizyczna zajmowana przez program w MB (tylko Linux, w innych systemach 0) */
+double zajeta_pamiec(void)
+{
+  FILE *plik;
+  long strony = 0, rezydentne = 0;
+
+  if((plik = fopen("/proc/self/statm", "r")) == NULL)
+    return 0;
+  if(fscanf(plik, "%ld %ld", &strony, &rezydentne) != 2)
+    rezydentne = 0;
+  fclose(plik);
+  return rezydentne * (double)sysconf(_SC_PAGESIZE) / (1024*1024);
+}
+
+/* pomiar jednego rozmiaru w test_wydajnosci_puli */
+void pomiar_puli(przebieg_testu *przebieg)
+{
+  int j, n = przebieg->n;
+  double czas[4], pamiec[2], przed;
+  clock_t poczatek;
+  krawedz **krawedzie;
+  pula_obiektow pula;
+
+  krawedzie = (krawedz**) malloc(n*sizeof(krawedz*));
+
+  /* kazda krawedz jest zapisywana, zeby jej pamiec zostala faktycznie przydzielona */
+  /* pula jest mierzona jako pierwsza, bo zwolnione przez free bloki pozostaja */
+  /* w pamieci programu i zawyzylyby pomiar pamieci pozostalego sposobu */
+  inicjalizacja_puli(&pula, sizeof(krawedz));
+  przed = zajeta_pamiec();
+  poczatek = clock();
+  for(j = 0; j < n; j++)
+  {
+    krawedzie[j] = (krawedz*) przydzielanie_z_puli(&pula);
+    krawedzie[j]->cel = NULL;
+  }
+  czas[2] = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+  pamiec[1] = zajeta_pamiec() - przed;
+  poczatek = clock();
+  resetowanie_puli(&pula);
+  czas[3] = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+
+  przed = zajeta_pamiec();
+  poczatek = clock();
+  for(j = 0; j < n; j++)
+  {
+    krawedzie[j] = (krawedz*) malloc(sizeof(krawedz));
+    krawedzie[j]->cel = NULL;
+  }
+  czas[0] = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+  pamiec[0] = zajeta_pamiec() - przed;
+  poczatek = clock();
+  for(j = 0; j < n; j++)
+    free(krawedzie[j]);
+  czas[1] = (double)(clock()-poczatek)/CLOCKS_PER_SEC;
+
+  printf("%10d %14.3f %14.3f %14.1f %14.3f %14.3f %14.1f\n", n, czas[0], czas[1],
+    pamiec[0], czas[2], czas[3], pamiec[1]);
+  free(krawedzie);
+}
+
+/* przydzielanie i zwalnianie pamieci dla 10^6 i 10^7 krawedzi: osobne wywolania */
+/* malloc/free oraz pula krawedzi zwalniana naraz (resetowanie_puli) */
+void test_wydajnosci_puli(void)
+{
+  int rozmiary[] = {1000000, 10000000};
+
+  printf("Przydzielanie pamieci dla krawedzi: malloc/free i pula\n");
+  printf("%10s %14s %14s %14s %14s %14s %14s\n", "krawedzie", "malloc [s]", "free [s]",
+         "malloc [MB]", "pula [s]", "reset [s]", "pula [MB]");
+  tabela_testu(rozmiary, sizeof(rozmiary)/sizeof(rozmiary[0]), BEZ_GRAFU, pomiar_puli, NULL);
+}
+
+/* n osob do importu - nazwisk jest n/4, wiec okolo piatej czesci osob */
+/* powtarza imie i nazwisko ktorejs wczesniejszej osoby */
+void generowanie_osob_importu(osoba_importowana *osoby, int n, unsigned int *stan)
+{
+  char *imiona[] = {"Jan", "Michal", "Jakub", "Anna", "Maria", "Pawel", "Tomasz", "Ewa"};
+  int i;
+
+  for(i = 0; i < n; i++)
+  {
+    strcpy(osoby[i].pierwsze_imie, imiona[losowa_liczba(stan) % 8]);
+    strcpy(osoby[i].drugie_imie, "_");
+    nazwisko_testowe(losowa_liczba(stan) % (n/4 + 1), osoby[i].nazwisko);
+    osoby[i].nr_telefonu = 100000000 + losowa_liczba(stan) % 900000000;
+    strcpy(osoby[i].adres.ulica, "Polna");
+    osoby[i].adres.nr_domu = 1 + losowa_liczba(stan) % 100;
+    osoby[i].adres.nr_mieszkania = 1 + losowa_liczba(stan) % 100;
+    strcpy(osoby[i].adres.kod_pocztowy, "01-234");
+    strcpy(osoby[i].adres.miasto, "Warszawa");
+  }
+}
+
+/* m znajomosci miedzy osobami o id 1..n - okolo 1% pozycji to znajomosci */
+/* osoby z soba sama, o stopniu 11 lub z osoba spoza ksiazki */
+void generowanie_znajomosci_importu(znajomosc_importowana *znajomosci, int m, int n,
+                                    unsigned int *stan)
+{
+  int i;
+
+  for(i = 0; i < m; i++)
+  {
+    znajomosci[i].id1 = 1 + losowa_liczba(stan) % n;
+    znajomosci[i].id2 = 1 + losowa_liczba(stan) % n;
+    znajomosci[i].waga1 = 1 + losowa_liczba(stan) % 10;
+    znajomosci[i].waga2 = 1 + losowa_liczba(stan) % 10;
+    switch(losowa_liczba(stan) % 300)
+    {
+      case 0: znajomosci[i].id2 = znajomosci[i].id1; break;
+      case 1: znajomosci[i].waga2 = 11; break;
+      case 2: znajomosci[i].id1 = n+1; break;
+    }
+  }
+}
+
+/* dodawanie osob i znajomosci po kolei (dopisywanie_osoby, dodawanie_krawedzi) */
+/* i importem hurtowym; oba sposoby musza dac ten sam graf (te same id, dane */
+/* z ostatniego wystapienia osoby i listy znajomych w tej samej kolejnosci); */
+/* po imporcie mierzymy tez zbudowanie widokow osob, ktore przy dodawaniu po */
+/* kolei sa aktualizowane na biezaco */
+void test_wydajnosci_importu(void)
+{
+  int osoby_testu[] = {100000, 1000000};
+  int znajomosci_testu[] = {1000000, 10000000};
+  int i, j, n, m, dodane[2];
+  unsigned int stan;
+  unsigned long suma[2];
+  long krawedzie[2];
+  double czas[5];
+  bool nowa;
+  graf g;
+  dziennik_zmian d;
+  osoba_importowana *osoby;
+  znajomosc_importowana *znajomosci;
+  wezel dane, *wsk1, *wsk2;
+
+  d.plik = -1; /* dopisywanie_osoby bez zapisywania zmian */
+  printf("Dodawanie osob i znajomosci po kolei i importem hurtowym [s]\n");
+  printf("%10s %10s %12s %12s %12s %12s %12s\n", "osoby", "znajomosci", "osoby",
+         "znajomosci", "import osob", "import zn.", "widoki");
+  for(i = 0; i < 2; i++)
+  {
+    n = osoby_testu[i];
+    m = znajomosci_testu[i];
+    if((double)sysconf(_SC_AVPHYS_PAGES) * sysconf(_SC_PAGESIZE) <
+       (double)n * (sizeof(wezel) + sizeof(osoba_importowana) + 64) +
+       (double)m * (2*sizeof(krawedz) + sizeof(znajomosc_importowana) +
+                    2*sizeof(klucz_pozycji) + 2*sizeof(wezel*) + sizeof(int)))
+    {
+      printf("%10d %10d - za malo wolnej pamieci, pomijamy\n", n, m);
+      continue;
+    }
+    osoby = (osoba_importowana*) malloc((size_t)n*sizeof(osoba_importowana));
+    znajomosci = (znajomosc_importowana*) malloc((size_t)m*sizeof(znajomosc_importowana));
+    stan = 24;
+    generowanie_osob_importu(osoby, n, &stan);
+
+    inicjalizacja_bazy(&g);
+    czas[0] = czas_zegarowy();
+    for(j = 0; j < n; j++)
+    {
+      strcpy(dane.pierwsze_imie, osoby[j].pierwsze_imie);
+      strcpy(dane.drugie_imie, osoby[j].drugie_imie);
+      strcpy(dane.nazwisko, osoby[j].nazwisko);
+      dane.nr_telefonu = osoby[j].nr_telefonu;
+      dane.adres = osoby[j].adres;
+      dopisywanie_osoby(&g, &d, &dane, &nowa);
+    }
+    czas[0] = czas_zegarowy() - czas[0];
+    /* znajomosci losujemy dopiero teraz, gdy znamy liczbe roznych osob */
+    generowanie_znajomosci_importu(znajomosci, m, g.liczba_elementow, &stan);
+    dodane[0] = 0;
+    czas[1] = czas_zegarowy();
+    for(j = 0; j < m; j++)
+      if((wsk1 = znajdz_wezel(&g, znajomosci[j].id1)) != NULL &&
+         (wsk2 = znajdz_wezel(&g, znajomosci[j].id2)) != NULL &&
+         dodawanie_krawedzi(&g, wsk1, wsk2, znajomosci[j].waga1, znajomosci[j].waga2) == 0)
+        dodane[0]++;
+    czas[1] = czas_zegarowy() - czas[1];
+    suma[0] = suma_kontrolna_grafu(&g, &krawedzie[0]);
+    czyszczenie_bazy(&g);
+
+    czas[2] = czas_zegarowy();
+    import_osob(&g, NULL, osoby, n, NULL);
+    czas[2] = czas_zegarowy() - czas[2];
+    czas[3] = czas_zegarowy();
+    dodane[1] = import_znajomosci(&g, NULL, znajomosci, m, NULL);
+    czas[3] = czas_zegarowy() - czas[3];
+    czas[4] = czas_zegarowy();
+    aktualizacja_widokow(&g);
+    czas[4] = czas_zegarowy() - czas[4];
+    suma[1] = suma_kontrolna_grafu(&g, &krawedzie[1]);
+    czyszczenie_bazy(&g);
+
+    printf("%10d %10d %12.3f %12.3f %12.3f %12.3f %12.3f\n", n, m, czas[0], czas[1],
+           czas[2], czas[3], czas[4]);
+    if(suma[0] != suma[1] || krawedzie[0] != krawedzie[1] || dodane[0] != dodane[1])
+      zglaszanie_bledu_testu("rozne grafy (krawedzie %ld i %ld, dodane znajomosci %d i %d)\n",
+                             krawedzie[0], krawedzie[1], dodane[0], dodane[1]);
+    free(znajomosci);
+    free(osoby);
+  }
+}
+
+/* dane generatora ksiazek zestawu testow - popularniejsze imiona i nazwiska */
+/* sa na poczatku list i sa losowane czesciej */
+char *imiona_generatora[] =
+  {"Anna", "Piotr", "Maria", "Krzysztof", "Katarzyna", "Andrzej", "Malgorzata", "Tomasz",
+   "Agnieszka", "Pawel", "Barbara", "Jan", "Ewa", "Michal", "Krystyna", "Marcin",
+   "Elzbieta", "Marek", "Zofia", "Grzegorz", "Teresa", "Jozef", "Magdalena", "Lukasz",
+   "Joanna", "Adam", "Danuta", "Zbigniew", "Monika", "Jerzy", "Aleksandra", "Tadeusz",
+   "Beata", "Mateusz", "Dorota", "Dariusz", "Karolina", "Mariusz", "Natalia", "Jakub"};
+char *nazwiska_generatora[] =
+  {"Nowak", "Kowalski", "Wisniewski", "Wojcik", "Kowalczyk", "Kaminski", "Lewandowski",
+   "Zielinski", "Szymanski", "Wozniak", "Dabrowski", "Kozlowski", "Jankowski", "Mazur",
+   "Kwiatkowski", "Krawczyk", "Piotrowski", "Grabowski", "Nowakowski", "Pawlowski",
+   "Michalski", "Nowicki", "Adamczyk", "Dudek", "Zajac", "Wieczorek", "Jablonski", "Krol",
+   "Majewski", "Olszewski", "Jaworski", "Wrobel", "Malinowski", "Pawlak", "Witkowski",
+   "Walczak", "Stepien", "Gorski", "Rutkowski", "Michalak"};
+/* zadne nazwisko z listy nie jest innym nazwiskiem z dopisanymi sylabami */
+char *sylaby_generatora[] =
+  {"ba", "be", "bo", "da", "do", "ka", "ko", "la", "le", "lo", "ma", "mi", "na", "no", "ra", "to"};
+char *miasta_generatora[] =
+  {"Warszawa", "Krakow", "Lodz", "Wroclaw", "Poznan", "Gdansk", "Szczecin", "Bydgoszcz",
+   "Lublin", "Bialystok", "Katowice", "Gdynia", "Czestochowa", "Radom", "Torun", "Sosnowiec",
+   "Rzeszow", "Kielce", "Gliwice", "Olsztyn", "Zabrze", "Bytom", "Opole", "Elblag", "Plock",
+   "Tarnow", "Chorzow", "Kalisz", "Koszalin", "Legnica"};
+char *ulice_generatora[] =
+  {"Polna", "Lesna", "Sloneczna", "Krotka", "Szkolna", "Ogrodowa", "Lipowa", "Brzozowa",
+   "Lakowa", "Kwiatowa", "Sosnowa", "Koscielna", "Akacjowa", "Parkowa", "Zielona", "Kolejowa",
+   "Sportowa", "Debowa", "Pogodna", "Mickiewicza", "Sienkiewicza", "Slowackiego",
+   "Kopernika", "Chopina"};
+
+#define LICZBA_IMION_GENERATORA (int)(sizeof(imiona_generatora)/sizeof(imiona_generatora[0]))
+#define LICZBA_NAZWISK_GENERATORA (int)(sizeof(nazwiska_generatora)/sizeof(nazwiska_generatora[0]))
+#define LICZBA_MIAST_GENERATORA (int)(sizeof(miasta_generatora)/sizeof(miasta_generatora[0]))
+#define LICZBA_ULIC_GENERATORA (int)(sizeof(ulice_generatora)/sizeof(ulice_generatora[0]))
+
+/* liczba losowa z przedzialu (0, 1] */
+double losowy_ulamek(unsigned int *stan)
+{
+  return (losowa_liczba(stan) + 1.0) / 4294967296.0;
+}
+
+/* numer z przedzialu [0, liczba) - male numery sa losowane czesciej */
+int losowanie_popularnego(unsigned int *stan, int liczba)
+{
+  double u = losowy_ulamek(stan);
+  int numer = (int)(liczba*u*u);
+
+  return (numer < liczba)? numer : liczba-1;
+}
+
+/* liczba o rozkladzie potegowym (Pareto) z wykladnikiem alfa - nie mniejsza */
+/* niz minimum i nie wieksza niz maksimum */
+int losowanie_potegowe(unsigned int *stan, double minimum, double alfa, int maksimum)
+{
+  double x = minimum * pow(losowy_ulamek(stan), -1.0/(alfa-1.0));
+
+  return (x > maksimum)? maksimum : (int)x;
+}
+
+/* nazwisko z listy, a za nim numer osoby o tym nazwisku zapisany sylabami */
+/* (numeracja bijektywna o podstawie 16, numer 0 - samo nazwisko), wiec */
+/* nazwiska wszystkich osob sa rozne; numer ponizej 16^6 miesci sie w 31 znakach */
+void nazwisko_generatora(int rdzen, int numer, char *nazwisko)
+{
+  int n = (int)strlen(strcpy(nazwisko, nazwiska_generatora[rdzen]));
+
+  while(numer > 0)
+  {
+    numer--;
+    memcpy(nazwisko+n, sylaby_generatora[numer % 16], 2);
+    n += 2;
+    numer /= 16;
+  }
+  nazwisko[n] = '\0';
+}
+
+/* generowanie ksiazki n osob do importu (po imporcie do pustej ksiazki osoby */
+/* maja id 1..n) i co najwyzej maks_znajomosci znajomosci; osoby naleza do */
+/* spolecznosci o wielkosci z rozkladu potegowego, ktore maja wspolne miasto, */
+/* poczatek kodu pocztowego i kilka ulic; kazda osoba zawiera znajomosci */
+/* z polowa swojej liczby znajomych (tez z rozkladu potegowego) - w 85% */
+/* z losowa osoba swojej spolecznosci, a w pozostalych z osoba z losowej */
+/* wczesniejszej znajomosci, wiec osoby z wieloma znajomymi sa wybierane */
+/* czesciej; na koniec osoby sa przemieszane, zeby spolecznosci nie mialy */
+/* kolejnych identyfikatorow; powtorzone znajomosci i znajomosci osoby */
+/* z soba sama odrzuci import; funkcja zwraca liczbe znajomosci */
+int generowanie_spolecznosci(osoba_importowana *osoby, int n, znajomosc_importowana *znajomosci,
+                             int maks_znajomosci, unsigned int ziarno)
+{
+  unsigned int stan = (ziarno == 0)? 1 : ziarno;
+  int liczniki_nazwisk[LICZBA_NAZWISK_GENERATORA];
+  int *gdzie, *kto; /* gdzie[i] - nowe miejsce osoby i, kto[j] - osoba na miejscu j */
+  int i, j, k, m = 0, rdzen, liczba_znajomych;
+  int poczatek = 0, wielkosc = 0, miasto = 0, prefiks_kodu = 0, kod = 0, ulica = 0;
+  osoba_importowana *osoba, temp;
+
+  memset(liczniki_nazwisk, 0, sizeof(liczniki_nazwisk));
+  for(i = 0; i < n; i++)
+  {
+    if(i == poczatek + wielkosc)
+    { /* nowa spolecznosc */
+      poczatek = i;
+      wielkosc = losowanie_potegowe(&stan, 20.0, 2.0, 10000);
+      if(wielkosc > n - i)
+        wielkosc = n - i;
+      miasto = losowanie_popularnego(&stan, LICZBA_MIAST_GENERATORA);
+      prefiks_kodu = 10 + losowa_liczba(&stan) % 90;
+      kod = losowa_liczba(&stan) % 1000;
+      ulica = losowa_liczba(&stan) % LICZBA_ULIC_GENERATORA;
+    }
+    osoba = &osoby[i];
+    strcpy(osoba->pierwsze_imie,
+           imiona_generatora[losowanie_popularnego(&stan, LICZBA_IMION_GENERATORA)]);
+    if(losowa_liczba(&stan) % 4 == 0)
+      strcpy(osoba->drugie_imie, imiona_generatora[losowa_liczba(&stan) % LICZBA_IMION_GENERATORA]);
+    else
+      strcpy(osoba->drugie_imie, "_");
+    rdzen = losowanie_popularnego(&stan, LICZBA_NAZWISK_GENERATORA);
+    nazwisko_generatora(rdzen, liczniki_nazwisk[rdzen]++, osoba->nazwisko);
+    osoba->nr_telefonu = 500000000 + losowa_liczba(&stan) % 400000000;
+    strcpy(osoba->adres.ulica, ulice_generatora[(ulica + losowa_liczba(&stan) % 3) % LICZBA_ULIC_GENERATORA]);
+    osoba->adres.nr_domu = 1 + losowa_liczba(&stan) % 120;
+    osoba->adres.nr_mieszkania = 1 + losowa_liczba(&stan) % 60;
+    sprintf(osoba->adres.kod_pocztowy, "%02d-%03d", prefiks_kodu,
+            (int)((kod + losowa_liczba(&stan) % 20) % 1000));
+    strcpy(osoba->adres.miasto, miasta_generatora[miasto]);
+
+    liczba_znajomych = losowanie_potegowe(&stan, 3.0, 2.5, 1000);
+    for(j = 0; j < (liczba_znajomych+1)/2 && m < maks_znajomosci; j++, m++)
+    {
+      znajomosci[m].id1 = i+1;
+      if(m == 0 || losowa_liczba(&stan) % 100 < 85)
+        znajomosci[m].id2 = poczatek + 1 + (int)(losowa_liczba(&stan) % wielkosc);
+      else
+      {
+        k = (int)(losowa_liczba(&stan) % m);
+        znajomosci[m].id2 = (losowa_liczba(&stan) & 1)? znajomosci[k].id1 : znajomosci[k].id2;
+      }
+      znajomosci[m].waga1 = 1 + losowa_liczba(&stan) % 10;
+      znajomosci[m].waga2 = 1 + losowa_liczba(&stan) % 10;
+    }
+  }
+
+  gdzie = (int*) malloc(n*sizeof(int));
+  kto = (int*) malloc(n*sizeof(int));
+  for(i = 0; i < n; i++)
+    gdzie[i] = kto[i] = i;
+  for(i = n-1; i > 0; i--)
+  {
+    j = (int)(losowa_liczba(&stan) % (i+1));
+    temp = osoby[i];
+    osoby[i] = osoby[j];
+    osoby[j] = temp;
+    k = kto[i];
+    kto[i] = kto[j];
+    kto[j] = k;
+    gdzie[kto[i]] = i;
+    gdzie[kto[j]] = j;
+  }
+  for(j = 0; j < m; j++)
+  {
+    znajomosci[j].id1 = gdzie[znajomosci[j].id1 - 1] + 1;
+    znajomosci[j].id2 = gdzie[znajomosci[j].id2 - 1] + 1;
+  }
+  free(kto);
+  free(gdzie);
+  return m;
+}
+
+/* liczba pomiarow kazdego testu makro zestawu, liczba operacji kazdego */
+/* testu mikro i liczba zapytan o sciezke w kazdym trybie */
+#define POWTORZENIA_ZESTAWU 3
+#define OPERACJE_ZESTAWU 1000
+#define ZAPYTANIA_ZESTAWU 100
+
+/* statystyki czasow jednego testu zestawu (czasy sa sortowane) - wiersz */
+/* tabeli na ekranie i obiekt w tablicy "wyniki" pliku JSON (czasy w sekundach) */
+void zapisywanie_wyniku_zestawu(FILE *plik, int *liczba_wynikow, int osoby, int znajomosci,
+                                const char *test, const char *rodzaj, double *czasy, int n)
+{
+  double suma = 0;
+  int i;
+
+  qsort(czasy, n, sizeof(double), porownywanie_czasow);
+  for(i = 0; i < n; i++)
+    suma += czasy[i];
+  fprintf(plik, "%s\n    {\"osoby\": %d, \"znajomosci\": %d, \"test\": \"%s\", \"rodzaj\": \"%s\", "
+          "\"liczba\": %d, \"min\": %.9g, \"mediana\": %.9g, \"srednia\": %.9g, "
+          "\"p99\": %.9g, \"maks\": %.9g}", (*liczba_wynikow > 0)? "," : "", osoby, znajomosci,
+          test, rodzaj, n, czasy[0], percentyl(czasy, n, 0.5), suma/n, percentyl(czasy, n, 0.99),
+          czasy[n-1]);
+  printf("%10d %10d %-22s %6s %6d %14.4f %14.4f %14.4f\n", osoby, znajomosci, test, rodzaj, n,
+         1e3*percentyl(czasy, n, 0.5), 1e3*percentyl(czasy, n, 0.99), 1e3*czasy[n-1]);
+  (*liczba_wynikow)++;
+}
+
+/* zestaw testow dla ksiazek 10^3, 10^4, ... do maks_osob osob z generatora */
+/* (generowanie_spolecznosci z podanym ziarnem, wiec pomiary sa powtarzalne): */
+/* testy makro - import, budowanie widokow i migawki, zapisywanie, wczytywanie */
+/* i sortowanie w kazdym trybie (kazdy POWTORZENIA_ZESTAWU razy) - oraz testy */
+/* mikro, w ktorych kazda operacja jest mierzona osobno - dodawanie i usuwanie */
+/* osob i znajomosci, zmiana stopnia znajomosci i wyszukiwanie sciezek w obu */
+/* trybach; wyniki sa zapisywane w pliku JSON; zwraca kod zakonczenia programu */
+int zestaw_testow(char *plik_wynikow, int maks_osob, unsigned int ziarno)
+{
+  char *nazwy_sortowan[] =
+    {"", "sortowanie_id", "sortowanie_imiona", "sortowanie_nazwiska", "sortowanie_telefon",
+     "sortowanie_kod"};
+  char *plik_tymczasowy = "zestaw_testow.tmp.txt";
+  FILE *plik;
+  graf g, wczytany;
+  dziennik_zmian d;
+  kontekst_wyszukiwania kontekst;
+  osoba_importowana *osoby;
+  znajomosc_importowana *znajomosci;
+  zapytanie z;
+  wezel dane, *wsk1, *wsk2;
+  double czasy[OPERACJE_ZESTAWU], czasy_widokow[POWTORZENIA_ZESTAWU], poczatek;
+  int pary[OPERACJE_ZESTAWU][2];
+  int n, k, m, i, j, tryb, liczba_par, znajomosci_ksiazki = 0, liczba_wynikow = 0;
+  unsigned long suma;
+  long krawedzie, krawedzie_wczytane;
+  unsigned int stan;
+  bool nowa;
+
+  if((plik = fopen(plik_wynikow, "w")) == NULL)
+  {
+    printf("blad, nie udalo sie utworzyc pliku %s\n", plik_wynikow);
+    return 1;
+  }
+  fprintf(plik, "{\n  \"program\": \"ksiazka_adresowa\",\n  \"ziarno\": %u,\n"
+          "  \"procesory\": %d,\n  \"powtorzenia\": %d,\n  \"wyniki\": [", ziarno,
+          (int)sysconf(_SC_NPROCESSORS_ONLN), POWTORZENIA_ZESTAWU);
+  d.plik = -1; /* operacje bez zapisywania zmian w dzienniku */
+  inicjalizacja_bazy(&g);
+  inicjalizacja_bazy(&wczytany);
+  inicjalizacja_kontekstu(&kontekst);
+  printf("Zestaw testow (ziarno %u), czasy [ms]\n", ziarno);
+  printf("%10s %10s %-22s %6s %6s %14s %14s %14s\n", "osoby", "znajomosci", "test", "rodzaj",
+         "liczba", "mediana", "p99", "maks");
+  for(n = 1000; n <= maks_osob && n > 0; n = (n > INT_MAX/10)? -1 : 10*n)
+  {
+    /* k dodatkowych osob z generatora nie trafia do ksiazki - sa dodawane w tescie */
+    k = (n/10 < OPERACJE_ZESTAWU)? n/10 : OPERACJE_ZESTAWU;
+    if((double)sysconf(_SC_AVPHYS_PAGES) * sysconf(_SC_PAGESIZE) <
+       (double)(n+k) * (2*(sizeof(wezel) + 64) + sizeof(osoba_importowana) +
+                        6*(sizeof(znajomosc_importowana) + 2*sizeof(klucz_pozycji) +
+                           2*sizeof(wezel*) + sizeof(int) + 4*sizeof(krawedz))))
+    {
+      printf("%10d - za malo wolnej pamieci, pomijamy\n", n);
+      continue;
+    }
+    osoby = (osoba_importowana*) malloc((size_t)(n+k)*sizeof(osoba_importowana));
+    znajomosci = (znajomosc_importowana*) malloc((size_t)6*(n+k)*sizeof(znajomosc_importowana));
+    poczatek = czas_zegarowy();
+    m = generowanie_spolecznosci(osoby, n+k, znajomosci, 6*(n+k), ziarno);
+    czasy[0] = czas_zegarowy() - poczatek;
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, 0, "generowanie", "makro", czasy, 1);
+
+    for(i = 0; i < POWTORZENIA_ZESTAWU; i++)
+    {
+      czyszczenie_bazy(&g);
+      poczatek = czas_zegarowy();
+      import_osob(&g, NULL, osoby, n, NULL);
+      znajomosci_ksiazki = import_znajomosci(&g, NULL, znajomosci, m, NULL);
+      czasy[i] = czas_zegarowy() - poczatek;
+      poczatek = czas_zegarowy();
+      aktualizacja_widokow(&g);
+      czasy_widokow[i] = czas_zegarowy() - poczatek;
+    }
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "import", "makro",
+                               czasy, POWTORZENIA_ZESTAWU);
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "budowanie_widokow",
+                               "makro", czasy_widokow, POWTORZENIA_ZESTAWU);
+    poczatek = czas_zegarowy();
+    aktualizacja_migawki(&g);
+    czasy[0] = czas_zegarowy() - poczatek;
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "budowanie_migawki",
+                               "makro", czasy, 1);
+
+    suma = suma_kontrolna_grafu(&g, &krawedzie);
+    for(i = 0; i < POWTORZENIA_ZESTAWU; i++)
+    {
+      poczatek = czas_zegarowy();
+      zapisywanie_bazy_do_pliku(&g, plik_tymczasowy);
+      czasy[i] = czas_zegarowy() - poczatek;
+    }
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "zapisywanie", "makro",
+                               czasy, POWTORZENIA_ZESTAWU);
+    for(i = 0; i < POWTORZENIA_ZESTAWU; i++)
+    {
+      czyszczenie_bazy(&wczytany);
+      poczatek = czas_zegarowy();
+      wczytywanie_bazy_z_pliku(&wczytany, plik_tymczasowy);
+      czasy[i] = czas_zegarowy() - poczatek;
+      if(suma_kontrolna_grafu(&wczytany, &krawedzie_wczytane) != suma || krawedzie_wczytane != krawedzie)
+        zglaszanie_bledu_testu("wczytana ksiazka rozni sie od zapisanej\n");
+    }
+    czyszczenie_bazy(&wczytany);
+    remove(plik_tymczasowy);
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "wczytywanie", "makro",
+                               czasy, POWTORZENIA_ZESTAWU);
+
+    for(tryb = 1; tryb <= 5; tryb++)
+    {
+      for(i = 0; i < POWTORZENIA_ZESTAWU; i++)
+      {
+        poczatek = czas_zegarowy();
+        if(tryb <= 3)
+          ukladanie_wedlug_widoku(&g, tryb);
+        else
+          ukladanie_wedlug_klucza(&g, tryb);
+        czasy[i] = czas_zegarowy() - poczatek;
+      }
+      zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, nazwy_sortowan[tryb],
+                                 "makro", czasy, POWTORZENIA_ZESTAWU);
+    }
+
+    /* zapytania o sciezki miedzy losowymi osobami w obu trybach */
+    for(tryb = 1; tryb <= 2; tryb++)
+    {
+      stan = ziarno + (unsigned int)n + 1;
+      for(i = 0; i < ZAPYTANIA_ZESTAWU; i++)
+      {
+        z.id1 = 1 + losowa_liczba(&stan) % n;
+        z.id2 = 1 + losowa_liczba(&stan) % n;
+        z.tryb = tryb;
+        wykonywanie_zapytania(&g, NULL, &kontekst, &z);
+        czasy[i] = z.czas;
+        free(z.wynik);
+      }
+      zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki,
+                                 (tryb == 1)? "sciezka_posrednicy" : "sciezka_skuteczna", "mikro",
+                                 czasy, ZAPYTANIA_ZESTAWU);
+    }
+
+    /* dodawanie osob spoza ksiazki (ostatnie osoby z generatora) */
+    for(i = 0; i < k; i++)
+    {
+      strcpy(dane.pierwsze_imie, osoby[n+i].pierwsze_imie);
+      strcpy(dane.drugie_imie, osoby[n+i].drugie_imie);
+      strcpy(dane.nazwisko, osoby[n+i].nazwisko);
+      dane.nr_telefonu = osoby[n+i].nr_telefonu;
+      dane.adres = osoby[n+i].adres;
+      poczatek = czas_zegarowy();
+      dopisywanie_osoby(&g, &d, &dane, &nowa);
+      czasy[i] = czas_zegarowy() - poczatek;
+    }
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "dodawanie_osoby",
+                               "mikro", czasy, k);
+
+    /* dodawanie znajomosci miedzy losowymi osobami, a potem zmiana stopnia */
+    /* i usuniecie dodanych znajomosci */
+    stan = ziarno + (unsigned int)n + 2;
+    for(i = 0, liczba_par = 0; i < OPERACJE_ZESTAWU; i++)
+    {
+      pary[liczba_par][0] = 1 + losowa_liczba(&stan) % n;
+      pary[liczba_par][1] = 1 + losowa_liczba(&stan) % n;
+      poczatek = czas_zegarowy();
+      if((wsk1 = znajdz_wezel(&g, pary[liczba_par][0])) != NULL &&
+         (wsk2 = znajdz_wezel(&g, pary[liczba_par][1])) != NULL &&
+         dodawanie_krawedzi(&g, wsk1, wsk2, 5, 5) == 0)
+        liczba_par++;
+      czasy[i] = czas_zegarowy() - poczatek;
+    }
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "dodawanie_znajomosci",
+                               "mikro", czasy, OPERACJE_ZESTAWU);
+    for(i = 0; i < liczba_par; i++)
+    {
+      poczatek = czas_zegarowy();
+      zmiana_wagi_krawedzi(&g, znajdz_wezel(&g, pary[i][0]), znajdz_wezel(&g, pary[i][1]), 7);
+      czasy[i] = czas_zegarowy() - poczatek;
+    }
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "zmiana_stopnia",
+                               "mikro", czasy, liczba_par);
+    for(i = 0; i < liczba_par; i++)
+    {
+      poczatek = czas_zegarowy();
+      usuwanie_krawedzi(&g, pary[i][0], pary[i][1]);
+      czasy[i] = czas_zegarowy() - poczatek;
+    }
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "usuwanie_znajomosci",
+                               "mikro", czasy, liczba_par);
+
+    /* usuwanie losowych osob razem z ich znajomosciami */
+    for(i = 0; i < k; i++)
+    {
+      do
+        j = 1 + losowa_liczba(&stan) % n;
+      while(znajdz_wezel(&g, j) == NULL);
+      poczatek = czas_zegarowy();
+      usuwanie_wezla(&g, j);
+      g.liczba_elementow--;
+      czasy[i] = czas_zegarowy() - poczatek;
+    }
+    zapisywanie_wyniku_zestawu(plik, &liczba_wynikow, n, znajomosci_ksiazki, "usuwanie_osoby",
+                               "mikro", czasy, k);
+    fflush(plik);
+    czyszczenie_bazy(&g);
+    free(znajomosci);
+    free(osoby);
+  }
+  fprintf(plik, "\n  ],\n  \"bledy\": %ld\n}\n", liczba_bledow_testow);
+  fclose(plik);
+  zwalnianie_kontekstu(&kontekst);
+  printf("Wyniki zapisano w pliku %s\n", plik_wynikow);
+  if(liczba_bledow_testow > 0)
+  {
+    printf("Liczba bledow: %ld\n", liczba_bledow_testow);
+    return 1;
+  }
+  return 0;
+}
+
+/* lista dostepnych testow - nowe testy dopisujemy na koncu tablicy */
+typedef struct
+{
+  char *nazwa;
+  void (*funkcja)(void);
+} test_wydajnosci;
+
+test_wydajnosci lista_testow[] =
+{
+  {"kopiec", test_wydajnosci_kopca},
+  {"front", test_wydajnosci_frontu},
+  {"wszerz", test_wydajnosci_przeszukiwania_wszerz},
+  {"kubelki", test_wydajnosci_kolejki_kubelkowej},
+  {"wiele_celow", test_wydajnosci_wielu_celow},
+  {"csr", test_wydajnosci_migawki},
+  {"stopien", test_wydajnosci_stopnia},
+  {"pula", test_wydajnosci_puli},
+  {"usuwanie", test_wydajnosci_usuwania},
+  {"wczytywanie", test_wydajnosci_wczytywania},
+  {"zapisywanie", test_wydajnosci_zapisywania},
+  {"binarny", test_wydajnosci_pliku_binarnego},
+  {"dziennik", test_wydajnosci_dziennika},
+  {"nazwiska", test_wydajnosci_nazwisk},
+  {"widoki", test_wydajnosci_widokow},
+  {"klucze", test_wydajnosci_kluczy},
+  {"scalanie", test_wydajnosci_scalania},
+  {"pozycyjne", test_wydajnosci_sortowania_pozycyjnego},
+  {"import", test_wydajnosci_importu}
+};
+
+/* argumenty - nazwy testow do uruchomienia, brak argumentow oznacza wszystkie testy */
+/* zwraca 1 gdy ktorys test wykryl blad lub podano nieznany test */
+int testy_wydajnosci(int argc, char *argv[])
+{
+  int i, j;
+  int liczba_testow = sizeof(lista_testow)/sizeof(lista_testow[0]);
+
+  if(argc == 0)
+    for(j = 0; j < liczba_testow; j++)
+      lista_testow[j].funkcja();
+  for(i = 0; i < argc; i++)
+  {
+    for(j = 0; j < liczba_testow; j++)
+      if(strcmp(argv[i], lista_testow[j].nazwa) == 0)
+        break;
+    if(j == liczba_testow)
+    {
+      printf("nieznany test: %s\n", argv[i]);
+      return 1;
+    }
+    lista_testow[j].funkcja();
+  }
+  if(liczba_bledow_testow > 0)
+  {
+    printf("Liczba bledow: %ld\n", liczba_bledow_testow);
+    return 1;
+  }
+  return 0;
+}